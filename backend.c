@@ -0,0 +1,316 @@
+#include "backend.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Vertex buffer raylib keeps positions in (see UpdateMeshBuffer)
+#define MESH_BUFFER_POSITIONS 0
+
+// State of the raylib backend
+typedef struct {
+    Material material;    // Default material; colors come from the vertices
+} RaylibBackend;
+
+// Positions of a mesh uploaded to the headless backend (kept only when
+// capturing)
+typedef struct {
+    float* vertices;      // xyz per vertex
+    int vertexCount;
+    bool used;            // The slot holds a mesh that was not unloaded
+} HeadlessMesh;
+
+// State of the headless backend
+typedef struct {
+    float aspectRatio;
+    bool capture;         // Keep mesh positions and record drawn vertices
+    HeadlessMesh* meshes; // Indexed by mesh id - 1
+    int meshCount;        // Slots handed out so far
+    int meshCapacity;
+    int* freeIds;         // Ids of unloaded meshes, reused first
+    int freeCount;
+    float* captured;      // Positions of every vertex drawn since the last reset
+    int capturedCount;    // Vertices in captured
+    int capturedCapacity;
+} HeadlessBackend;
+
+static void RaylibUploadMesh(void* context, Mesh* mesh, bool dynamic) {
+    (void)context;
+    UploadMesh(mesh, dynamic);
+}
+
+static void RaylibUpdateMeshBuffer(void* context, Mesh mesh, int index, const void* data, int size) {
+    (void)context;
+    UpdateMeshBuffer(mesh, index, data, size, 0);
+}
+
+static void RaylibUnloadMesh(void* context, Mesh mesh) {
+    (void)context;
+    UnloadMesh(mesh);
+}
+
+static void RaylibDrawMesh(void* context, Mesh mesh, Matrix transform) {
+    RaylibBackend* raylib = (RaylibBackend*)context;
+    DrawMesh(mesh, raylib->material, transform);
+}
+
+static void RaylibSetBlending(void* context, bool enabled) {
+    (void)context;
+    if (enabled) {
+        BeginBlendMode(BLEND_ALPHA);
+    } else {
+        EndBlendMode();
+    }
+}
+
+static float RaylibGetAspectRatio(void* context) {
+    (void)context;
+    return (float)GetScreenWidth() / (float)GetScreenHeight();
+}
+
+static void RaylibDestroy(void* context) {
+    RaylibBackend* raylib = (RaylibBackend*)context;
+    UnloadMaterial(raylib->material);
+    free(raylib);
+}
+
+// Allocate a backend around an implementation's state
+static RenderBackend* AllocateRenderBackend(void* context) {
+    RenderBackend* backend = (RenderBackend*)calloc(1, sizeof(RenderBackend));
+    if (backend) backend->context = context;
+    return backend;
+}
+
+// Create a backend that draws with raylib (the window must be open)
+RenderBackend* CreateRaylibRenderBackend(void) {
+    RaylibBackend* raylib = (RaylibBackend*)malloc(sizeof(RaylibBackend));
+    if (!raylib) return NULL;
+    
+    RenderBackend* backend = AllocateRenderBackend(raylib);
+    if (!backend) {
+        free(raylib);
+        return NULL;
+    }
+    
+    raylib->material = LoadMaterialDefault();
+    backend->uploadMesh = RaylibUploadMesh;
+    backend->updateMeshBuffer = RaylibUpdateMeshBuffer;
+    backend->unloadMesh = RaylibUnloadMesh;
+    backend->drawMesh = RaylibDrawMesh;
+    backend->setBlending = RaylibSetBlending;
+    backend->getAspectRatio = RaylibGetAspectRatio;
+    backend->destroy = RaylibDestroy;
+    
+    return backend;
+}
+
+// Get the slot of a headless mesh id (NULL for ids never handed out)
+static HeadlessMesh* GetHeadlessMesh(HeadlessBackend* headless, unsigned int id) {
+    if (id == 0 || id > (unsigned int)headless->meshCount) return NULL;
+    return &headless->meshes[id - 1];
+}
+
+// Hand out a mesh id, reusing those of unloaded meshes first (0 if memory runs out)
+static unsigned int AllocateHeadlessMeshId(HeadlessBackend* headless) {
+    if (headless->freeCount > 0) return (unsigned int)headless->freeIds[--headless->freeCount];
+    
+    if (headless->meshCount == headless->meshCapacity) {
+        int newCapacity = headless->meshCapacity ? headless->meshCapacity * 2 : 256;
+        HeadlessMesh* newMeshes = (HeadlessMesh*)realloc(headless->meshes, newCapacity * sizeof(HeadlessMesh));
+        if (!newMeshes) return 0;
+        headless->meshes = newMeshes;
+        
+        int* newFreeIds = (int*)realloc(headless->freeIds, newCapacity * sizeof(int));
+        if (!newFreeIds) return 0;
+        headless->freeIds = newFreeIds;
+        headless->meshCapacity = newCapacity;
+    }
+    
+    headless->meshes[headless->meshCount] = (HeadlessMesh){ 0 };
+    return (unsigned int)++headless->meshCount;
+}
+
+// Copy positions into a headless mesh (only when capturing)
+static void StoreHeadlessVertices(HeadlessBackend* headless, HeadlessMesh* mesh, const float* vertices, int vertexCount) {
+    if (!headless->capture || !vertices) return;
+    
+    float* copy = (float*)realloc(mesh->vertices, (size_t)vertexCount * 3 * sizeof(float));
+    if (!copy && vertexCount > 0) return;
+    
+    memcpy(copy, vertices, (size_t)vertexCount * 3 * sizeof(float));
+    mesh->vertices = copy;
+    mesh->vertexCount = vertexCount;
+}
+
+static void HeadlessUploadMesh(void* context, Mesh* mesh, bool dynamic) {
+    HeadlessBackend* headless = (HeadlessBackend*)context;
+    (void)dynamic;
+    
+    mesh->vaoId = AllocateHeadlessMeshId(headless);
+    HeadlessMesh* stored = GetHeadlessMesh(headless, mesh->vaoId);
+    if (!stored) return;
+    
+    stored->used = true;
+    StoreHeadlessVertices(headless, stored, mesh->vertices, mesh->vertexCount);
+}
+
+static void HeadlessUpdateMeshBuffer(void* context, Mesh mesh, int index, const void* data, int size) {
+    HeadlessBackend* headless = (HeadlessBackend*)context;
+    HeadlessMesh* stored = GetHeadlessMesh(headless, mesh.vaoId);
+    if (!stored || !stored->used || index != MESH_BUFFER_POSITIONS) return;
+    
+    StoreHeadlessVertices(headless, stored, (const float*)data, size / (int)(3 * sizeof(float)));
+}
+
+static void HeadlessUnloadMesh(void* context, Mesh mesh) {
+    HeadlessBackend* headless = (HeadlessBackend*)context;
+    HeadlessMesh* stored = GetHeadlessMesh(headless, mesh.vaoId);
+    if (!stored || !stored->used) return;
+    
+    free(stored->vertices);
+    *stored = (HeadlessMesh){ 0 };
+    headless->freeIds[headless->freeCount++] = (int)mesh.vaoId;
+}
+
+// Append the positions of a drawn mesh to the capture
+static void HeadlessDrawMesh(void* context, Mesh mesh, Matrix transform) {
+    HeadlessBackend* headless = (HeadlessBackend*)context;
+    (void)transform;
+    
+    HeadlessMesh* stored = GetHeadlessMesh(headless, mesh.vaoId);
+    if (!headless->capture || !stored || !stored->vertices) return;
+    
+    int needed = headless->capturedCount + stored->vertexCount;
+    if (needed > headless->capturedCapacity) {
+        int newCapacity = headless->capturedCapacity ? headless->capturedCapacity : 4096;
+        while (newCapacity < needed) newCapacity *= 2;
+        float* newCaptured = (float*)realloc(headless->captured, (size_t)newCapacity * 3 * sizeof(float));
+        if (!newCaptured) return;
+        headless->captured = newCaptured;
+        headless->capturedCapacity = newCapacity;
+    }
+    
+    memcpy(headless->captured + (size_t)headless->capturedCount * 3, stored->vertices,
+           (size_t)stored->vertexCount * 3 * sizeof(float));
+    headless->capturedCount = needed;
+}
+
+static void HeadlessSetBlending(void* context, bool enabled) {
+    (void)context;
+    (void)enabled;
+}
+
+static float HeadlessGetAspectRatio(void* context) {
+    return ((HeadlessBackend*)context)->aspectRatio;
+}
+
+static void HeadlessDestroy(void* context) {
+    HeadlessBackend* headless = (HeadlessBackend*)context;
+    
+    for (int i = 0; i < headless->meshCount; i++) {
+        free(headless->meshes[i].vertices);
+    }
+    free(headless->meshes);
+    free(headless->freeIds);
+    free(headless->captured);
+    free(headless);
+}
+
+// Create a backend that draws nothing, for programs without a window: it
+// counts what is submitted and, when captureVertices is set, records the
+// position of every vertex drawn (see GetCapturedVertices)
+RenderBackend* CreateHeadlessRenderBackend(int screenWidth, int screenHeight, bool captureVertices) {
+    if (screenWidth <= 0 || screenHeight <= 0) return NULL;
+    
+    HeadlessBackend* headless = (HeadlessBackend*)calloc(1, sizeof(HeadlessBackend));
+    if (!headless) return NULL;
+    
+    RenderBackend* backend = AllocateRenderBackend(headless);
+    if (!backend) {
+        free(headless);
+        return NULL;
+    }
+    
+    headless->aspectRatio = (float)screenWidth / (float)screenHeight;
+    headless->capture = captureVertices;
+    backend->uploadMesh = HeadlessUploadMesh;
+    backend->updateMeshBuffer = HeadlessUpdateMeshBuffer;
+    backend->unloadMesh = HeadlessUnloadMesh;
+    backend->drawMesh = HeadlessDrawMesh;
+    backend->setBlending = HeadlessSetBlending;
+    backend->getAspectRatio = HeadlessGetAspectRatio;
+    backend->destroy = HeadlessDestroy;
+    
+    return backend;
+}
+
+// Free a backend (the meshes uploaded to it must be unloaded first)
+void DestroyRenderBackend(RenderBackend* backend) {
+    if (backend) {
+        backend->destroy(backend->context);
+        free(backend);
+    }
+}
+
+// Upload a mesh's vertex data (positions, and colors if it has them)
+void UploadRenderMesh(RenderBackend* backend, Mesh* mesh, bool dynamic) {
+    backend->stats.meshUploads++;
+    backend->stats.bytesUploaded += (long)mesh->vertexCount * (3 * sizeof(float) + (mesh->colors ? 4 : 0));
+    backend->uploadMesh(backend->context, mesh, dynamic);
+}
+
+// Rewrite one vertex buffer of an uploaded dynamic mesh
+void UpdateRenderMeshBuffer(RenderBackend* backend, Mesh mesh, int index, const void* data, int size) {
+    backend->stats.bufferUpdates++;
+    backend->stats.bytesUploaded += size;
+    backend->updateMeshBuffer(backend->context, mesh, index, data, size);
+}
+
+// Release an uploaded mesh
+void UnloadRenderMesh(RenderBackend* backend, Mesh mesh) {
+    backend->unloadMesh(backend->context, mesh);
+}
+
+// Draw an uploaded mesh
+void DrawRenderMesh(RenderBackend* backend, Mesh mesh, Matrix transform) {
+    backend->stats.drawCalls++;
+    backend->stats.triangles += mesh.triangleCount;
+    backend->stats.vertices += mesh.vertexCount;
+    backend->drawMesh(backend->context, mesh, transform);
+}
+
+// Turn alpha blending on or off (only a change of state is submitted)
+void SetRenderBlending(RenderBackend* backend, bool enabled) {
+    if (backend->blending == enabled) return;
+    
+    backend->blending = enabled;
+    backend->stats.stateChanges++;
+    backend->setBlending(backend->context, enabled);
+}
+
+// Width over height of the render target
+float GetRenderAspectRatio(RenderBackend* backend) {
+    return backend->getAspectRatio(backend->context);
+}
+
+// Zero the counters (and the vertex capture of a headless backend)
+void ResetRenderBackendStats(RenderBackend* backend) {
+    if (!backend) return;
+    
+    backend->stats = (RenderBackendStats){ 0 };
+    if (backend->destroy == HeadlessDestroy) {
+        ((HeadlessBackend*)backend->context)->capturedCount = 0;
+    }
+}
+
+// Positions (xyz) of every vertex drawn since the last reset, in draw order.
+// Only a headless backend created with captureVertices records them; other
+// backends return NULL.
+const float* GetCapturedVertices(RenderBackend* backend, int* vertexCount) {
+    if (vertexCount) *vertexCount = 0;
+    if (!backend || backend->destroy != HeadlessDestroy) return NULL;
+    
+    HeadlessBackend* headless = (HeadlessBackend*)backend->context;
+    if (!headless->capture) return NULL;
+    
+    if (vertexCount) *vertexCount = headless->capturedCount;
+    return headless->captured;
+}
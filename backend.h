@@ -0,0 +1,55 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+// Counters of the work submitted to a backend
+typedef struct {
+    int drawCalls;        // Meshes drawn
+    long triangles;       // Triangles in the meshes drawn
+    long vertices;        // Vertices in the meshes drawn
+    int stateChanges;     // Switches of the blend mode
+    int meshUploads;      // Meshes uploaded
+    int bufferUpdates;    // Vertex buffers rewritten in place
+    long bytesUploaded;   // Vertex data sent by uploads and buffer updates
+} RenderBackendStats;
+
+// Everything the renderer submits goes through a backend: a table of
+// functions and the state they share. The raylib backend draws for real;
+// the headless backend needs no window or GPU and only counts (and can
+// capture) what it is given, so render-side work can be measured on
+// machines without a display. The counters are kept here, the same for
+// every backend.
+typedef struct {
+    void* context;            // Implementation state, passed to every function
+    void (*uploadMesh)(void* context, Mesh* mesh, bool dynamic);
+    void (*updateMeshBuffer)(void* context, Mesh mesh, int index, const void* data, int size);
+    void (*unloadMesh)(void* context, Mesh mesh);
+    void (*drawMesh)(void* context, Mesh mesh, Matrix transform);
+    void (*setBlending)(void* context, bool enabled);
+    float (*getAspectRatio)(void* context);
+    void (*destroy)(void* context);
+    
+    bool blending;            // Alpha blending is enabled
+    RenderBackendStats stats; // Counters since the last ResetRenderBackendStats
+} RenderBackend;
+
+// Backend creation (the raylib backend needs an open window)
+RenderBackend* CreateRaylibRenderBackend(void);
+RenderBackend* CreateHeadlessRenderBackend(int screenWidth, int screenHeight, bool captureVertices);
+void DestroyRenderBackend(RenderBackend* backend);
+
+// Submission
+void UploadRenderMesh(RenderBackend* backend, Mesh* mesh, bool dynamic);
+void UpdateRenderMeshBuffer(RenderBackend* backend, Mesh mesh, int index, const void* data, int size);
+void UnloadRenderMesh(RenderBackend* backend, Mesh mesh);
+void DrawRenderMesh(RenderBackend* backend, Mesh mesh, Matrix transform);
+void SetRenderBlending(RenderBackend* backend, bool enabled);
+float GetRenderAspectRatio(RenderBackend* backend);
+
+// Statistics
+void ResetRenderBackendStats(RenderBackend* backend);
+const float* GetCapturedVertices(RenderBackend* backend, int* vertexCount);
+
+#endif // BACKEND_H
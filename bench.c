@@ -0,0 +1,759 @@
+#include "voxel.h"
+#include "terrain.h"
+#include "player.h"
+#include "entity.h"
+#include "broadphase.h"
+#include "mesher.h"
+#include "noise.h"
+#include "jobs.h"
+#include "raycast.h"
+#include "renderer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <dirent.h>
+
+// Headless benchmark suite. Prints one JSON object per benchmark on stdout:
+//   {"name": ..., "iterations": ..., "ns_per_op": ..., "ops_per_sec": ...,
+//    "allocs_per_op": ..., "bytes_per_op": ...}
+// Allocation counts are only available when built with BENCH_COUNT_ALLOCS
+// (the Makefile enables it on Linux by wrapping malloc); otherwise they are -1.
+//
+// Usage: voxel_bench [name-filter]
+
+// Minimum time spent in each benchmark
+#define BENCH_MIN_SECONDS 0.5
+
+// Number of random boxes used by the collision benchmark
+#define BENCH_COLLISION_BOXES 4096
+
+// Number of physics ticks in the scripted player run
+#define BENCH_PHYSICS_TICKS 600
+
+// Number of wandering entities in the batched physics benchmark, and the
+// ticks they are stepped for
+#define BENCH_ENTITIES 4096
+#define BENCH_ENTITY_TICKS 60
+
+// Largest entity count in the broadphase benchmarks, and how many pairs
+// they can report
+#define BENCH_BROADPHASE_MAX 100000
+#define BENCH_BROADPHASE_PAIRS (BENCH_BROADPHASE_MAX * 4)
+
+// Number of random rays cast by the raycast benchmarks, and their length
+#define BENCH_RAYS 4096
+#define BENCH_RAY_DISTANCE 64.0f
+
+// Frames the renderer gets to mesh the world before RenderWorld is timed
+#define BENCH_RENDER_WARMUP_FRAMES 64
+
+// Edge of the box written by the bulk edit benchmarks
+#define BENCH_FILL_SIZE 40
+
+// Scratch directory for the save/load benchmarks
+#define BENCH_SAVE_DIRECTORY "bench_world_save"
+
+// A benchmark body: performs opsPerCall operations on its context
+typedef void (*BenchFunction)(void* context);
+
+// Allocation counters
+static long allocCount = 0;
+static long allocBytes = 0;
+
+#ifdef BENCH_COUNT_ALLOCS
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    __atomic_add_fetch(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&allocBytes, (long)size, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    __atomic_add_fetch(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&allocBytes, (long)(count * size), __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    __atomic_add_fetch(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&allocBytes, (long)size, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    __real_free(ptr);
+}
+#endif
+
+// Sink that keeps results alive so the optimizer cannot drop benchmark work
+static volatile long benchSink = 0;
+
+// Current time in nanoseconds
+static double GetTimeNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Run a benchmark repeatedly for at least BENCH_MIN_SECONDS and print its results
+static void RunBenchmark(const char* filter, const char* name, BenchFunction function,
+                         void* context, long opsPerCall) {
+    if (filter && !strstr(name, filter)) return;
+    
+    // Warm up caches and lazily allocated state
+    function(context);
+    
+    long startAllocs = allocCount;
+    long startBytes = allocBytes;
+    long calls = 0;
+    double start = GetTimeNs();
+    double elapsed = 0.0;
+    
+    do {
+        function(context);
+        calls++;
+        elapsed = GetTimeNs() - start;
+    } while (elapsed < BENCH_MIN_SECONDS * 1e9);
+    
+    double ops = (double)calls * (double)opsPerCall;
+#ifdef BENCH_COUNT_ALLOCS
+    double allocsPerOp = (double)(allocCount - startAllocs) / ops;
+    double bytesPerOp = (double)(allocBytes - startBytes) / ops;
+#else
+    double allocsPerOp = -1.0;
+    double bytesPerOp = -1.0;
+    (void)startAllocs;
+    (void)startBytes;
+#endif
+    
+    printf("{\"name\": \"%s\", \"iterations\": %.0f, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, "
+           "\"allocs_per_op\": %.4f, \"bytes_per_op\": %.1f}\n",
+           name, ops, elapsed / ops, ops / (elapsed * 1e-9), allocsPerOp, bytesPerOp);
+    fflush(stdout);
+}
+
+// Delete a saved world directory and the files in it
+static void RemoveSavedWorld(const char* directory) {
+    DIR* dir = opendir(directory);
+    if (!dir) return;
+    
+    struct dirent* entry;
+    char path[512];
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        remove(path);
+    }
+    closedir(dir);
+    remove(directory);
+}
+
+// Shared benchmark state
+typedef struct {
+    World* world;                                   // Generated world
+    BoundingBox boxes[BENCH_COLLISION_BOXES];       // Random player-sized boxes
+    Ray rays[BENCH_RAYS];                           // Random rays from above the terrain
+    ChunkSnapshot* snapshots;                       // Snapshots of every generated chunk
+    int snapshotCount;
+    ChunkMeshData* lakeMeshes;                      // Meshes of the chunks with transparent faces
+    int lakeMeshCount;
+    int lakeQuadCount;                              // Transparent quads in those meshes
+    EntityStore* entities;                          // Bodies of the player and the wandering mobs
+    Player* player;                                 // Player driven by the physics script
+    EntityStore* mobs;                              // Store of BENCH_ENTITIES wandering mobs
+    BoundingBox* crowd;                             // BENCH_BROADPHASE_MAX body-sized boxes
+    Broadphase* broadphase;                         // Broadphase for the crowd
+    BroadphasePair* pairs;                          // Pairs found in the crowd
+    JobSystem* jobs;                                // Worker pool for parallel benchmarks
+    RenderBackend* backend;                         // Headless backend counting what is drawn
+    WorldRenderer* renderer;                        // Renderer with every chunk of the world meshed
+    Camera camera;                                  // View from above the world centre
+    BlockRegion* terrainCopy;                       // BENCH_FILL_SIZE^3 blocks of the generated terrain
+} BenchContext;
+
+// GenerateTerrain on a fresh world
+static void BenchGenerateTerrain(void* context) {
+    (void)context;
+    World* world = CreateWorld();
+    GenerateTerrain(world);
+    benchSink += world->chunkCount;
+    DestroyWorld(world);
+}
+
+// GenerateTerrainSeeded with chunk columns spread over the worker pool
+static void BenchGenerateTerrainParallel(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    World* world = CreateWorld();
+    GenerateTerrainSeeded(world, DEFAULT_WORLD_SEED, bench->jobs);
+    benchSink += world->chunkCount;
+    DestroyWorld(world);
+}
+
+// Three octaves of scalar GenerateNoise2D for every column of the generated area
+static void BenchNoiseScalar(void* context) {
+    (void)context;
+    float sum = 0.0f;
+    
+    for (int z = 0; z < WORLD_SIZE_Z; z++) {
+        for (int x = 0; x < WORLD_SIZE_X; x++) {
+            sum += GenerateNoise2D((float)x, (float)z, NOISE_SCALE);
+            sum += 0.5f * GenerateNoise2D((float)x, (float)z, NOISE_SCALE * 2.0f);
+            sum += 0.25f * GenerateNoise2D((float)x, (float)z, NOISE_SCALE * 4.0f);
+        }
+    }
+    
+    benchSink += (long)sum;
+}
+
+// The same columns through the batch height kernel
+static void BenchHeightRow(void* context) {
+    (void)context;
+    float heights[WORLD_SIZE_X];
+    float sum = 0.0f;
+    
+    for (int z = 0; z < WORLD_SIZE_Z; z++) {
+        GenerateHeightRow(heights, WORLD_SIZE_X, 0, z, DEFAULT_WORLD_SEED);
+        sum += heights[z];
+    }
+    
+    benchSink += (long)sum;
+}
+
+// GetBlock over the generated area
+static void BenchGetBlock(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    long sum = 0;
+    
+    for (int x = 0; x < WORLD_SIZE_X; x++) {
+        for (int y = 0; y < WORLD_SIZE_Y; y++) {
+            for (int z = 0; z < WORLD_SIZE_Z; z++) {
+                sum += GetBlock(bench->world, x, y, z);
+            }
+        }
+    }
+    
+    benchSink += sum;
+}
+
+// GetSolidHeight for every column of the generated area (the heights are
+// cached after the first pass)
+static void BenchSolidHeight(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    long sum = 0;
+    
+    for (int x = 0; x < WORLD_SIZE_X; x++) {
+        for (int z = 0; z < WORLD_SIZE_Z; z++) {
+            sum += GetSolidHeight(bench->world, x, z);
+        }
+    }
+    
+    benchSink += sum;
+}
+
+// SaveWorld of the generated world (records are rewritten in place after the first pass)
+static void BenchSaveWorld(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    benchSink += SaveWorld(bench->world, BENCH_SAVE_DIRECTORY);
+}
+
+// LoadWorld of the saved world into a fresh world
+static void BenchLoadWorld(void* context) {
+    (void)context;
+    World* world = LoadWorld(BENCH_SAVE_DIRECTORY);
+    if (world) {
+        benchSink += world->chunkCount;
+        DestroyWorld(world);
+    }
+}
+
+// LoadWorldLazy of the saved world, reading a single block
+static void BenchLoadWorldLazy(void* context) {
+    (void)context;
+    World* world = LoadWorldLazy(BENCH_SAVE_DIRECTORY);
+    if (world) {
+        benchSink += GetBlock(world, WORLD_SIZE_X / 2, WORLD_SIZE_Y / 2, WORLD_SIZE_Z / 2) + world->chunkCount;
+        DestroyWorld(world);
+    }
+}
+
+// SetBlock rewriting a 32x32x32 region with alternating types
+static void BenchSetBlock(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    static int pass = 0;
+    pass++;
+    
+    for (int x = 0; x < 32; x++) {
+        for (int y = 0; y < 32; y++) {
+            for (int z = 0; z < 32; z++) {
+                SetBlock(bench->world, x + 512, y, z, ((x + y + z + pass) & 1) ? BLOCK_STONE : BLOCK_SAND);
+            }
+        }
+    }
+    
+    // Keep the dirty list from growing between passes
+    ChunkCoord coord;
+    while (PopDirtyChunk(bench->world, &coord)) {}
+}
+
+// SetBlock over an unaligned 40^3 box, alternating between two types each
+// pass (the per-block baseline for BenchFillRegion)
+static void BenchFillBlocks(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    static int pass = 0;
+    BlockType type = (++pass & 1) ? BLOCK_STONE : BLOCK_SAND;
+    
+    for (int x = 0; x < BENCH_FILL_SIZE; x++) {
+        for (int y = 0; y < BENCH_FILL_SIZE; y++) {
+            for (int z = 0; z < BENCH_FILL_SIZE; z++) {
+                SetBlock(bench->world, x + 1029, y + 5, z + 3, type);
+            }
+        }
+    }
+    
+    ChunkCoord coord;
+    while (PopDirtyChunk(bench->world, &coord)) {}
+}
+
+// FillRegion of the same box
+static void BenchFillRegion(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    static int pass = 0;
+    BlockType type = (++pass & 1) ? BLOCK_STONE : BLOCK_SAND;
+    
+    FillRegion(bench->world, 1029, 5, 3, 1028 + BENCH_FILL_SIZE, 4 + BENCH_FILL_SIZE, 2 + BENCH_FILL_SIZE, type);
+    
+    ChunkCoord coord;
+    while (PopDirtyChunk(bench->world, &coord)) {}
+}
+
+// PasteRegion of a 40^3 box of terrain, at alternating offsets so every
+// pass rewrites the blocks
+static void BenchPasteRegion(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    static int pass = 0;
+    
+    PasteRegion(bench->world, bench->terrainCopy, 2048 + (++pass & 1), 5, 3);
+    
+    ChunkCoord coord;
+    while (PopDirtyChunk(bench->world, &coord)) {}
+}
+
+// IsBlockFaceVisible for all six faces of every block in the generated area
+static void BenchFaceScan(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    long visible = 0;
+    
+    for (int x = 0; x < WORLD_SIZE_X; x++) {
+        for (int y = 0; y < WORLD_SIZE_Y; y++) {
+            for (int z = 0; z < WORLD_SIZE_Z; z++) {
+                for (int faceDir = 0; faceDir < 6; faceDir++) {
+                    visible += IsBlockFaceVisible(bench->world, x, y, z, faceDir);
+                }
+            }
+        }
+    }
+    
+    benchSink += visible;
+}
+
+// GetColumnFaceMasks for every column of the generated area (the same faces
+// as BenchFaceScan, culled a column at a time)
+static void BenchColumnFaceMasks(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    uint64_t visible = 0;
+    
+    for (int x = 0; x < WORLD_SIZE_X; x++) {
+        for (int z = 0; z < WORLD_SIZE_Z; z++) {
+            uint64_t faceMasks[6];
+            GetColumnFaceMasks(bench->world, x, z, faceMasks);
+            for (int faceDir = 0; faceDir < 6; faceDir++) {
+                visible ^= faceMasks[faceDir];
+            }
+        }
+    }
+    
+    benchSink += (long)(visible & 0xffff);
+}
+
+// CheckCollision against many player-sized boxes scattered over the terrain
+static void BenchCheckCollision(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    long hits = 0;
+    
+    for (int i = 0; i < BENCH_COLLISION_BOXES; i++) {
+        hits += CheckCollision(bench->world, bench->boxes[i]);
+    }
+    
+    benchSink += hits;
+}
+
+// SweepBoxAxis of the collision boxes along every axis; the fast variant
+// moves 16 blocks per sweep instead of a tenth of one
+static void SweepCollisionBoxes(BenchContext* bench, float distance) {
+    float moved = 0.0f;
+    
+    for (int i = 0; i < BENCH_COLLISION_BOXES; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            moved += SweepBoxAxis(bench->world, bench->boxes[i], axis, (i & 1) ? distance : -distance);
+        }
+    }
+    
+    benchSink += (long)moved;
+}
+
+static void BenchSweepSlow(void* context) {
+    SweepCollisionBoxes((BenchContext*)context, 0.1f);
+}
+
+static void BenchSweepFast(void* context) {
+    SweepCollisionBoxes((BenchContext*)context, 16.0f);
+}
+
+// RaycastWorld of every benchmark ray, one call per ray
+static void BenchRaycast(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    long hits = 0;
+    
+    for (int i = 0; i < BENCH_RAYS; i++) {
+        hits += RaycastWorld(bench->world, bench->rays[i], BENCH_RAY_DISTANCE, 0).hit;
+    }
+    
+    benchSink += hits;
+}
+
+// RaycastWorldBatch of every benchmark ray in one call
+static void BenchRaycastBatch(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    static RaycastHit hits[BENCH_RAYS];
+    
+    RaycastWorldBatch(bench->world, bench->rays, BENCH_RAYS, BENCH_RAY_DISTANCE, 0, hits);
+    benchSink += hits[0].hit + hits[BENCH_RAYS - 1].hit;
+}
+
+// StepEntities for the player's body alone over a scripted run: walk,
+// strafe, jump and turn
+static void BenchPlayerPhysics(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    Player* player = bench->player;
+    
+    SetEntityPosition(bench->entities, player->entity,
+                      (Vector3){ WORLD_SIZE_X / 2.0f, WORLD_SIZE_Y * 0.75f, WORLD_SIZE_Z / 2.0f });
+    
+    for (int tick = 0; tick < BENCH_PHYSICS_TICKS; tick++) {
+        // Scripted input: change heading every 100 ticks and jump every 45
+        float angle = (float)(tick / 100) * 1.3f;
+        uint8_t input = (tick % 45 == 0) ? ENTITY_INPUT_JUMP : 0;
+        SetEntityInput(bench->entities, player->entity,
+                       sinf(angle) * PLAYER_MOVE_SPEED, cosf(angle) * PLAYER_MOVE_SPEED, input);
+        
+        StepEntities(bench->entities, bench->world);
+    }
+    
+    benchSink += (long)GetPlayerPosition(player).y;
+}
+
+// StepEntities for many mobs walking over the terrain, each turning and
+// jumping on its own schedule
+static void BenchEntities(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    EntityStore* mobs = bench->mobs;
+    static int pass = 0;
+    pass++;
+    
+    for (int tick = 0; tick < BENCH_ENTITY_TICKS; tick++) {
+        for (int i = 0; i < mobs->count; i++) {
+            float angle = (float)((i + pass * 7 + tick / 30) % 16) * 0.39f;
+            uint8_t input = ((i + tick) % 40 == 0) ? ENTITY_INPUT_JUMP : 0;
+            SetEntityInput(mobs, mobs->ids[i], sinf(angle) * PLAYER_MOVE_SPEED, cosf(angle) * PLAYER_MOVE_SPEED, input);
+        }
+        
+        StepEntities(mobs, bench->world);
+    }
+    
+    // Keep the mobs on the generated area
+    for (int i = 0; i < mobs->count; i++) {
+        if (mobs->positionX[i] < 0.0f || mobs->positionX[i] >= WORLD_SIZE_X ||
+            mobs->positionZ[i] < 0.0f || mobs->positionZ[i] >= WORLD_SIZE_Z) {
+            SetEntityPosition(mobs, mobs->ids[i], (Vector3){ WORLD_SIZE_X / 2.0f, WORLD_SIZE_Y * 0.75f, WORLD_SIZE_Z / 2.0f });
+        }
+    }
+    
+    benchSink += (long)mobs->positionY[0];
+}
+
+// Rebuild the broadphase from the first count boxes of the crowd and find
+// every overlapping pair. The crowd is spread so that the density is the
+// same at every count, so the time per box should stay flat.
+static void FindCrowdPairs(BenchContext* bench, int count) {
+    ClearBroadphase(bench->broadphase);
+    for (int i = 0; i < count; i++) {
+        AddBroadphaseBox(bench->broadphase, i, bench->crowd[i]);
+    }
+    
+    benchSink += FindBroadphasePairs(bench->broadphase, bench->pairs, BENCH_BROADPHASE_PAIRS);
+}
+
+static void BenchBroadphase1k(void* context) {
+    FindCrowdPairs((BenchContext*)context, 1000);
+}
+
+static void BenchBroadphase10k(void* context) {
+    FindCrowdPairs((BenchContext*)context, 10000);
+}
+
+static void BenchBroadphase100k(void* context) {
+    FindCrowdPairs((BenchContext*)context, 100000);
+}
+
+// Every pair of the first 1000 crowd boxes tested directly, for comparison
+static void BenchBruteForcePairs1k(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    long pairs = 0;
+    
+    for (int i = 0; i < 1000; i++) {
+        for (int j = i + 1; j < 1000; j++) {
+            pairs += CheckCollisionBoxes(bench->crowd[i], bench->crowd[j]);
+        }
+    }
+    
+    benchSink += pairs;
+}
+
+// CreateChunkSnapshot for every chunk of the generated world
+static void BenchSnapshot(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    
+    for (int i = 0; i < bench->snapshotCount; i++) {
+        ChunkSnapshot* snapshot = &bench->snapshots[i];
+        CreateChunkSnapshot(bench->world, snapshot->cx, snapshot->cy, snapshot->cz, snapshot);
+    }
+}
+
+// Greedy meshing of every chunk of the generated world
+static void BenchBuildChunkMesh(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    
+    for (int i = 0; i < bench->snapshotCount; i++) {
+        ChunkMeshData mesh;
+        if (BuildChunkMesh(&bench->snapshots[i], &mesh)) {
+            benchSink += mesh.quadCount;
+            FreeChunkMeshData(&mesh);
+        }
+    }
+}
+
+// Face connectivity flood fill of every chunk of the generated world
+static void BenchChunkConnectivity(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    
+    for (int i = 0; i < bench->snapshotCount; i++) {
+        benchSink += GetChunkConnectivity(&bench->snapshots[i]);
+    }
+}
+
+// Level 2 snapshot and mesh of every chunk of the generated world (the
+// work a distant chunk costs the renderer)
+static void BenchLodMesh(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    
+    for (int i = 0; i < bench->snapshotCount; i++) {
+        const ChunkSnapshot* source = &bench->snapshots[i];
+        ChunkSnapshot snapshot;
+        ChunkMeshData mesh;
+        CreateLodSnapshot(bench->world, source->cx, source->cy, source->cz, 2, &snapshot);
+        if (BuildChunkMesh(&snapshot, &mesh)) {
+            benchSink += mesh.quadCount;
+            FreeChunkMeshData(&mesh);
+        }
+    }
+}
+
+// SortMeshBufferQuads of every chunk with jello, from viewpoints on
+// alternating sides so every pass reorders the faces
+static void BenchSortTransparent(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    static int pass = 0;
+    pass++;
+    
+    for (int i = 0; i < bench->lakeMeshCount; i++) {
+        MeshBuffer* quads = &bench->lakeMeshes[i].transparent;
+        Vector3 viewPoint = (pass & 1) ? (Vector3){ -20.0f, 40.0f, -20.0f } : (Vector3){ 80.0f, 40.0f, 80.0f };
+        benchSink += SortMeshBufferQuads(quads, viewPoint);
+    }
+}
+
+// RenderWorld of the whole generated world through the headless backend:
+// visibility search, culling, transparent sorting and submission
+static void BenchRenderWorld(void* context) {
+    BenchContext* bench = (BenchContext*)context;
+    
+    SetEntityPosition(bench->entities, bench->player->entity,
+                      (Vector3){ WORLD_SIZE_X / 2.0f, WORLD_SIZE_Y * 0.75f, WORLD_SIZE_Z / 2.0f });
+    ResetRenderBackendStats(bench->backend);
+    RenderWorld(bench->renderer, bench->world, bench->player, bench->camera);
+    
+    benchSink += bench->backend->stats.drawCalls;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = (argc > 1) ? argv[1] : NULL;
+    BenchContext* bench = (BenchContext*)calloc(1, sizeof(BenchContext));
+    if (!bench) return 1;
+    
+    // Shared world used by the read-only benchmarks
+    bench->world = CreateWorld();
+    GenerateTerrain(bench->world);
+    
+    srand(1234);
+    for (int i = 0; i < BENCH_COLLISION_BOXES; i++) {
+        float x = (float)(rand() % (WORLD_SIZE_X * 100)) / 100.0f;
+        float y = (float)(rand() % (WORLD_SIZE_Y * 50)) / 100.0f;
+        float z = (float)(rand() % (WORLD_SIZE_Z * 100)) / 100.0f;
+        bench->boxes[i] = (BoundingBox){
+            { x - PLAYER_WIDTH / 2, y, z - PLAYER_DEPTH / 2 },
+            { x + PLAYER_WIDTH / 2, y + PLAYER_HEIGHT, z + PLAYER_DEPTH / 2 }
+        };
+    }
+    for (int i = 0; i < BENCH_RAYS; i++) {
+        float angle = (float)(rand() % 6283) / 1000.0f;
+        bench->rays[i] = (Ray){
+            { (float)(rand() % (WORLD_SIZE_X * 100)) / 100.0f, 40.0f + (float)(rand() % 2000) / 100.0f,
+              (float)(rand() % (WORLD_SIZE_Z * 100)) / 100.0f },
+            { cosf(angle), -(float)(rand() % 1000) / 1000.0f, sinf(angle) }
+        };
+    }
+    
+    // The first n crowd boxes cover a square of side 4 * sqrt(n) blocks
+    bench->crowd = (BoundingBox*)malloc(BENCH_BROADPHASE_MAX * sizeof(BoundingBox));
+    bench->broadphase = CreateBroadphase(BENCH_BROADPHASE_MAX, ENTITY_CELL_SIZE);
+    bench->pairs = (BroadphasePair*)malloc(BENCH_BROADPHASE_PAIRS * sizeof(BroadphasePair));
+    if (!bench->crowd || !bench->broadphase || !bench->pairs) return 1;
+    for (int i = 0; i < BENCH_BROADPHASE_MAX; i++) {
+        float side = 4.0f * sqrtf((float)(i + 1));
+        float x = (float)rand() / (float)RAND_MAX * side;
+        float y = (float)(rand() % (WORLD_SIZE_Y * 100)) / 100.0f;
+        float z = (float)rand() / (float)RAND_MAX * side;
+        bench->crowd[i] = (BoundingBox){
+            { x - PLAYER_WIDTH / 2, y, z - PLAYER_DEPTH / 2 },
+            { x + PLAYER_WIDTH / 2, y + PLAYER_HEIGHT, z + PLAYER_DEPTH / 2 }
+        };
+    }
+    
+    bench->snapshots = (ChunkSnapshot*)malloc(bench->world->chunkCount * sizeof(ChunkSnapshot));
+    if (!bench->snapshots) return 1;
+    for (int i = 0; i < bench->world->capacity; i++) {
+        Chunk* chunk = bench->world->slots[i];
+        if (chunk) {
+            CreateChunkSnapshot(bench->world, chunk->cx, chunk->cy, chunk->cz,
+                                &bench->snapshots[bench->snapshotCount++]);
+        }
+    }
+    
+    bench->lakeMeshes = (ChunkMeshData*)malloc(bench->snapshotCount * sizeof(ChunkMeshData));
+    if (!bench->lakeMeshes) return 1;
+    for (int i = 0; i < bench->snapshotCount; i++) {
+        ChunkMeshData* mesh = &bench->lakeMeshes[bench->lakeMeshCount];
+        if (!BuildChunkMesh(&bench->snapshots[i], mesh)) continue;
+        if (mesh->transparent.vertexCount == 0) {
+            FreeChunkMeshData(mesh);
+            continue;
+        }
+        bench->lakeQuadCount += mesh->transparent.vertexCount / VERTICES_PER_QUAD;
+        bench->lakeMeshCount++;
+    }
+    
+    bench->entities = CreateEntityStore(1);
+    bench->player = CreatePlayer(bench->world, bench->entities);
+    if (!bench->player) return 1;
+    
+    bench->mobs = CreateEntityStore(BENCH_ENTITIES);
+    if (!bench->mobs) return 1;
+    for (int i = 0; i < BENCH_ENTITIES; i++) {
+        Vector3 position = { (float)(rand() % (WORLD_SIZE_X * 100)) / 100.0f, WORLD_SIZE_Y * 0.75f,
+                             (float)(rand() % (WORLD_SIZE_Z * 100)) / 100.0f };
+        CreateEntity(bench->mobs, position, (Vector3){ PLAYER_WIDTH, PLAYER_HEIGHT, PLAYER_DEPTH });
+    }
+    bench->jobs = CreateJobSystem(0);
+    
+    // Mesh the world for the render benchmark from the player's starting point
+    bench->backend = CreateHeadlessRenderBackend(800, 600, false);
+    bench->renderer = CreateWorldRenderer(bench->jobs, bench->backend);
+    if (!bench->renderer) return 1;
+    SetEntityPosition(bench->entities, bench->player->entity,
+                      (Vector3){ WORLD_SIZE_X / 2.0f, WORLD_SIZE_Y * 0.75f, WORLD_SIZE_Z / 2.0f });
+    for (int i = 0; i < BENCH_RENDER_WARMUP_FRAMES; i++) {
+        UpdateWorldRenderer(bench->renderer, bench->world, bench->player);
+        WaitForJobs(bench->jobs);
+    }
+    UpdateWorldRenderer(bench->renderer, bench->world, bench->player);
+    bench->camera = (Camera){
+        { WORLD_SIZE_X / 2.0f, WORLD_SIZE_Y * 0.75f, WORLD_SIZE_Z / 2.0f },
+        { WORLD_SIZE_X * 0.75f, WORLD_SIZE_Y * 0.25f, WORLD_SIZE_Z * 0.75f },
+        { 0.0f, 1.0f, 0.0f }, 60.0f, CAMERA_PERSPECTIVE
+    };
+    
+    bench->terrainCopy = CopyRegion(bench->world, 0, 0, 0, BENCH_FILL_SIZE - 1, BENCH_FILL_SIZE - 1, BENCH_FILL_SIZE - 1);
+    if (!bench->terrainCopy) return 1;
+    
+    long worldVolume = (long)WORLD_SIZE_X * WORLD_SIZE_Y * WORLD_SIZE_Z;
+    long fillVolume = (long)BENCH_FILL_SIZE * BENCH_FILL_SIZE * BENCH_FILL_SIZE;
+    RunBenchmark(filter, "GenerateTerrain", BenchGenerateTerrain, bench, 1);
+    RunBenchmark(filter, "GenerateTerrainParallel", BenchGenerateTerrainParallel, bench, 1);
+    RunBenchmark(filter, "GenerateNoise2D", BenchNoiseScalar, bench, WORLD_SIZE_X * WORLD_SIZE_Z);
+    RunBenchmark(filter, "GenerateHeightRow", BenchHeightRow, bench, WORLD_SIZE_X * WORLD_SIZE_Z);
+    RunBenchmark(filter, "GetBlock", BenchGetBlock, bench, worldVolume);
+    RunBenchmark(filter, "GetSolidHeight", BenchSolidHeight, bench, WORLD_SIZE_X * WORLD_SIZE_Z);
+    RunBenchmark(filter, "IsBlockFaceVisible", BenchFaceScan, bench, worldVolume * 6);
+    RunBenchmark(filter, "ColumnFaceMasks", BenchColumnFaceMasks, bench, worldVolume * 6);
+    RunBenchmark(filter, "CheckCollision", BenchCheckCollision, bench, BENCH_COLLISION_BOXES);
+    RunBenchmark(filter, "SweepBoxAxis", BenchSweepSlow, bench, BENCH_COLLISION_BOXES * 3);
+    RunBenchmark(filter, "SweepBoxAxisFast", BenchSweepFast, bench, BENCH_COLLISION_BOXES * 3);
+    RunBenchmark(filter, "UpdatePlayerPhysics", BenchPlayerPhysics, bench, BENCH_PHYSICS_TICKS);
+    RunBenchmark(filter, "StepEntities", BenchEntities, bench, BENCH_ENTITIES * BENCH_ENTITY_TICKS);
+    RunBenchmark(filter, "Broadphase1k", BenchBroadphase1k, bench, 1000);
+    RunBenchmark(filter, "Broadphase10k", BenchBroadphase10k, bench, 10000);
+    RunBenchmark(filter, "Broadphase100k", BenchBroadphase100k, bench, 100000);
+    RunBenchmark(filter, "BruteForcePairs1k", BenchBruteForcePairs1k, bench, 1000);
+    RunBenchmark(filter, "RaycastWorld", BenchRaycast, bench, BENCH_RAYS);
+    RunBenchmark(filter, "RaycastWorldBatch", BenchRaycastBatch, bench, BENCH_RAYS);
+    RunBenchmark(filter, "CreateChunkSnapshot", BenchSnapshot, bench, bench->snapshotCount);
+    RunBenchmark(filter, "BuildChunkMesh", BenchBuildChunkMesh, bench, bench->snapshotCount);
+    RunBenchmark(filter, "GetChunkConnectivity", BenchChunkConnectivity, bench, bench->snapshotCount);
+    RunBenchmark(filter, "BuildLodMesh", BenchLodMesh, bench, bench->snapshotCount);
+    RunBenchmark(filter, "SortTransparentQuads", BenchSortTransparent, bench, bench->lakeQuadCount);
+    RunBenchmark(filter, "RenderWorld", BenchRenderWorld, bench, 1);
+    RunBenchmark(filter, "SaveWorld", BenchSaveWorld, bench, 1);
+    RunBenchmark(filter, "LoadWorld", BenchLoadWorld, bench, 1);
+    RunBenchmark(filter, "LoadWorldLazy", BenchLoadWorldLazy, bench, 1);
+    RunBenchmark(filter, "SetBlock", BenchSetBlock, bench, 32 * 32 * 32);
+    RunBenchmark(filter, "FillBlocks", BenchFillBlocks, bench, fillVolume);
+    RunBenchmark(filter, "FillRegion", BenchFillRegion, bench, fillVolume);
+    RunBenchmark(filter, "PasteRegion", BenchPasteRegion, bench, fillVolume);
+    
+    RemoveSavedWorld(BENCH_SAVE_DIRECTORY);
+    FreeBlockRegion(bench->terrainCopy);
+    DestroyWorldRenderer(bench->renderer);
+    DestroyRenderBackend(bench->backend);
+    DestroyJobSystem(bench->jobs);
+    DestroyPlayer(bench->player);
+    DestroyEntityStore(bench->entities);
+    DestroyEntityStore(bench->mobs);
+    DestroyBroadphase(bench->broadphase);
+    free(bench->pairs);
+    free(bench->crowd);
+    for (int i = 0; i < bench->lakeMeshCount; i++) {
+        FreeChunkMeshData(&bench->lakeMeshes[i]);
+    }
+    free(bench->lakeMeshes);
+    free(bench->snapshots);
+    DestroyWorld(bench->world);
+    free(bench);
+    
+    return 0;
+}
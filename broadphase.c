@@ -0,0 +1,263 @@
+#include "broadphase.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Called for every item that may overlap a region; returns false to stop
+typedef bool (*BroadphaseVisitor)(void* context, int item);
+
+// Whether two boxes overlap (touching counts)
+static inline bool BoxesOverlap(BoundingBox a, BoundingBox b) {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+// Grid cell holding a coordinate
+static inline int GetCellCoord(const Broadphase* broadphase, float v) {
+    return (int)floorf(v * broadphase->inverseCellSize);
+}
+
+// Number of hash buckets for a number of boxes: at least two per box keeps
+// the chains short
+static int GetBucketCount(int boxes) {
+    int buckets = 1;
+    while (buckets < boxes * 2) buckets <<= 1;
+    return buckets;
+}
+
+// Create an empty broadphase for up to capacity boxes
+Broadphase* CreateBroadphase(int capacity, float cellSize) {
+    if (capacity <= 0 || cellSize <= 0.0f) return NULL;
+    
+    Broadphase* broadphase = (Broadphase*)calloc(1, sizeof(Broadphase));
+    if (!broadphase) return NULL;
+    
+    broadphase->capacity = capacity;
+    broadphase->cellSize = cellSize;
+    broadphase->inverseCellSize = 1.0f / cellSize;
+    broadphase->maxBuckets = GetBucketCount(capacity);
+    broadphase->bucketStart = (int*)calloc(broadphase->maxBuckets + 1, sizeof(int));
+    broadphase->bucketCursor = (int*)malloc(broadphase->maxBuckets * sizeof(int));
+    broadphase->added = (BroadphaseItem*)malloc(capacity * sizeof(BroadphaseItem));
+    broadphase->sorted = (BroadphaseItem*)malloc(capacity * sizeof(BroadphaseItem));
+    
+    if (!broadphase->bucketStart || !broadphase->bucketCursor || !broadphase->added || !broadphase->sorted) {
+        DestroyBroadphase(broadphase);
+        return NULL;
+    }
+    
+    broadphase->built = true;
+    
+    return broadphase;
+}
+
+// Free a broadphase
+void DestroyBroadphase(Broadphase* broadphase) {
+    if (broadphase) {
+        free(broadphase->bucketStart);
+        free(broadphase->bucketCursor);
+        free(broadphase->added);
+        free(broadphase->sorted);
+        free(broadphase);
+    }
+}
+
+// Remove every box
+void ClearBroadphase(Broadphase* broadphase) {
+    if (!broadphase) return;
+    
+    broadphase->count = 0;
+    broadphase->maxHalfSize = (Vector3){ 0.0f, 0.0f, 0.0f };
+    broadphase->built = false;
+}
+
+// Add a box (returns false if the broadphase is full). The box takes part
+// in queries after the next BuildBroadphase.
+bool AddBroadphaseBox(Broadphase* broadphase, int id, BoundingBox box) {
+    if (!broadphase || broadphase->count == broadphase->capacity) return false;
+    
+    BroadphaseItem* item = &broadphase->added[broadphase->count++];
+    item->box = box;
+    item->id = id;
+    item->cx = GetCellCoord(broadphase, (box.min.x + box.max.x) * 0.5f);
+    item->cy = GetCellCoord(broadphase, (box.min.y + box.max.y) * 0.5f);
+    item->cz = GetCellCoord(broadphase, (box.min.z + box.max.z) * 0.5f);
+    item->hash = HashChunkCoords(item->cx, item->cy, item->cz);
+    
+    Vector3* maxHalfSize = &broadphase->maxHalfSize;
+    maxHalfSize->x = fmaxf(maxHalfSize->x, (box.max.x - box.min.x) * 0.5f);
+    maxHalfSize->y = fmaxf(maxHalfSize->y, (box.max.y - box.min.y) * 0.5f);
+    maxHalfSize->z = fmaxf(maxHalfSize->z, (box.max.z - box.min.z) * 0.5f);
+    broadphase->built = false;
+    
+    return true;
+}
+
+// Group the added boxes by bucket (counting sort: count, prefix sum, scatter)
+void BuildBroadphase(Broadphase* broadphase) {
+    if (!broadphase || broadphase->built) return;
+    
+    // Size the table for the boxes actually added, so clearing it stays
+    // proportional to them rather than to the capacity
+    int buckets = GetBucketCount(broadphase->count);
+    unsigned int mask = (unsigned int)(buckets - 1);
+    int* start = broadphase->bucketStart;
+    int* cursor = broadphase->bucketCursor;
+    
+    broadphase->bucketMask = buckets - 1;
+    memset(start, 0, (buckets + 1) * sizeof(int));
+    for (int i = 0; i < broadphase->count; i++) {
+        start[(broadphase->added[i].hash & mask) + 1]++;
+    }
+    
+    for (int b = 0; b < buckets; b++) {
+        start[b + 1] += start[b];
+    }
+    
+    memcpy(cursor, start, buckets * sizeof(int));
+    for (int i = 0; i < broadphase->count; i++) {
+        const BroadphaseItem* item = &broadphase->added[i];
+        broadphase->sorted[cursor[item->hash & mask]++] = *item;
+    }
+    
+    broadphase->built = true;
+}
+
+// Visit every sorted item whose box centre can lie in the cells a region
+// reaches. Items of other cells that share a bucket are skipped, so each
+// item is visited at most once. Very large regions scan all items instead.
+static void VisitRegion(Broadphase* broadphase, BoundingBox region, BroadphaseVisitor visit, void* context) {
+    Vector3 grow = broadphase->maxHalfSize;
+    int minX = GetCellCoord(broadphase, region.min.x - grow.x);
+    int minY = GetCellCoord(broadphase, region.min.y - grow.y);
+    int minZ = GetCellCoord(broadphase, region.min.z - grow.z);
+    int maxX = GetCellCoord(broadphase, region.max.x + grow.x);
+    int maxY = GetCellCoord(broadphase, region.max.y + grow.y);
+    int maxZ = GetCellCoord(broadphase, region.max.z + grow.z);
+    
+    double cells = (double)(maxX - minX + 1) * (double)(maxY - minY + 1) * (double)(maxZ - minZ + 1);
+    if (cells > (double)broadphase->count) {
+        for (int i = 0; i < broadphase->count; i++) {
+            if (!visit(context, i)) return;
+        }
+        return;
+    }
+    
+    for (int cx = minX; cx <= maxX; cx++) {
+        for (int cy = minY; cy <= maxY; cy++) {
+            for (int cz = minZ; cz <= maxZ; cz++) {
+                int bucket = (int)(HashChunkCoords(cx, cy, cz) & (unsigned int)broadphase->bucketMask);
+                int end = broadphase->bucketStart[bucket + 1];
+                
+                for (int i = broadphase->bucketStart[bucket]; i < end; i++) {
+                    const BroadphaseItem* item = &broadphase->sorted[i];
+                    if (item->cx != cx || item->cy != cy || item->cz != cz) continue;
+                    if (!visit(context, i)) return;
+                }
+            }
+        }
+    }
+}
+
+// State of a pair search while visiting the neighbours of one item
+typedef struct {
+    Broadphase* broadphase;
+    int item;                 // Item whose neighbours are visited
+    BroadphasePair* pairs;
+    int maxPairs;
+    int pairCount;
+} PairSearch;
+
+// Record a pair for a neighbour further along the sorted items (so each
+// pair is reported once)
+static bool VisitPairCandidate(void* context, int item) {
+    PairSearch* search = (PairSearch*)context;
+    const BroadphaseItem* items = search->broadphase->sorted;
+    
+    if (item <= search->item || !BoxesOverlap(items[item].box, items[search->item].box)) return true;
+    if (search->pairCount == search->maxPairs) return false;
+    
+    search->pairs[search->pairCount++] = (BroadphasePair){ items[search->item].id, items[item].id };
+    return true;
+}
+
+// Find the pairs of boxes that overlap (up to maxPairs). Returns the number
+// of pairs written.
+int FindBroadphasePairs(Broadphase* broadphase, BroadphasePair* pairs, int maxPairs) {
+    if (!broadphase || !pairs || maxPairs <= 0) return 0;
+    
+    BuildBroadphase(broadphase);
+    
+    PairSearch search = { broadphase, 0, pairs, maxPairs, 0 };
+    for (int i = 0; i < broadphase->count && search.pairCount < maxPairs; i++) {
+        search.item = i;
+        VisitRegion(broadphase, broadphase->sorted[i].box, VisitPairCandidate, &search);
+    }
+    
+    return search.pairCount;
+}
+
+// State of a box or radius query
+typedef struct {
+    const BroadphaseItem* items;
+    BoundingBox box;          // Query box (the bounds of the sphere for radius queries)
+    bool sphere;              // Test against the sphere instead of the box
+    Vector3 center;
+    float radiusSquared;
+    int* ids;
+    int maxIds;
+    int idCount;
+} BroadphaseQuery;
+
+// Record an item that overlaps the query box or sphere
+static bool VisitQueryCandidate(void* context, int item) {
+    BroadphaseQuery* query = (BroadphaseQuery*)context;
+    BoundingBox box = query->items[item].box;
+    
+    if (!BoxesOverlap(box, query->box)) return true;
+    
+    if (query->sphere) {
+        // Distance from the centre to the closest point of the box
+        float dx = fmaxf(fmaxf(box.min.x - query->center.x, query->center.x - box.max.x), 0.0f);
+        float dy = fmaxf(fmaxf(box.min.y - query->center.y, query->center.y - box.max.y), 0.0f);
+        float dz = fmaxf(fmaxf(box.min.z - query->center.z, query->center.z - box.max.z), 0.0f);
+        if (dx * dx + dy * dy + dz * dz > query->radiusSquared) return true;
+    }
+    
+    if (query->idCount == query->maxIds) return false;
+    
+    query->ids[query->idCount++] = query->items[item].id;
+    return true;
+}
+
+// Find the ids of the boxes overlapping a box (up to maxIds). Returns the
+// number of ids written.
+int QueryBroadphaseBox(Broadphase* broadphase, BoundingBox box, int* ids, int maxIds) {
+    if (!broadphase || !ids || maxIds <= 0) return 0;
+    
+    BuildBroadphase(broadphase);
+    
+    BroadphaseQuery query = { broadphase->sorted, box, false, { 0.0f, 0.0f, 0.0f }, 0.0f, ids, maxIds, 0 };
+    VisitRegion(broadphase, box, VisitQueryCandidate, &query);
+    
+    return query.idCount;
+}
+
+// Find the ids of the boxes within radius of a point (up to maxIds).
+// Returns the number of ids written.
+int QueryBroadphaseRadius(Broadphase* broadphase, Vector3 center, float radius, int* ids, int maxIds) {
+    if (!broadphase || !ids || maxIds <= 0) return 0;
+    
+    BuildBroadphase(broadphase);
+    
+    BoundingBox bounds = {
+        { center.x - radius, center.y - radius, center.z - radius },
+        { center.x + radius, center.y + radius, center.z + radius }
+    };
+    
+    BroadphaseQuery query = { broadphase->sorted, bounds, true, center, radius * radius, ids, maxIds, 0 };
+    VisitRegion(broadphase, bounds, VisitQueryCandidate, &query);
+    
+    return query.idCount;
+}
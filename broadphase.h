@@ -0,0 +1,52 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include "raylib.h"
+#include "voxel.h"
+
+// A box added to the broadphase
+typedef struct {
+    BoundingBox box;
+    int id;               // Caller's id for the box
+    int cx, cy, cz;       // Grid cell holding the box centre
+    unsigned int hash;    // Hash of that cell
+} BroadphaseItem;
+
+// Two ids whose boxes overlap
+typedef struct {
+    int a, b;
+} BroadphasePair;
+
+// Uniform grid over box centres, stored as a hash table of cells so it
+// covers the unbounded world. Boxes are added, then BuildBroadphase groups
+// them by bucket with a counting sort (linear in the number of boxes); the
+// grid is rebuilt from scratch every tick rather than updated.
+// Queries look at the cells whose boxes could reach the query region:
+// the region grown by the largest half size of any box, so boxes larger
+// than a cell are still found.
+typedef struct {
+    int capacity;             // Maximum number of boxes
+    int count;                // Boxes added since the last clear
+    float cellSize;           // Edge length of a grid cell in blocks
+    float inverseCellSize;
+    Vector3 maxHalfSize;      // Largest half size of any added box on each axis
+    int maxBuckets;           // Buckets allocated (enough for capacity boxes)
+    int bucketMask;           // Buckets in use - 1 (a power of two, sized by the last build)
+    int* bucketStart;         // Items of bucket b are sorted[bucketStart[b]..bucketStart[b + 1])
+    int* bucketCursor;        // Scratch for the counting sort
+    BroadphaseItem* added;    // Boxes in the order they were added
+    BroadphaseItem* sorted;   // The same boxes grouped by bucket (valid after BuildBroadphase)
+    bool built;               // No boxes were added since the last build
+} Broadphase;
+
+// Function prototypes
+Broadphase* CreateBroadphase(int capacity, float cellSize);
+void DestroyBroadphase(Broadphase* broadphase);
+void ClearBroadphase(Broadphase* broadphase);
+bool AddBroadphaseBox(Broadphase* broadphase, int id, BoundingBox box);
+void BuildBroadphase(Broadphase* broadphase);
+int FindBroadphasePairs(Broadphase* broadphase, BroadphasePair* pairs, int maxPairs);
+int QueryBroadphaseBox(Broadphase* broadphase, BoundingBox box, int* ids, int maxIds);
+int QueryBroadphaseRadius(Broadphase* broadphase, Vector3 center, float radius, int* ids, int maxIds);
+
+#endif // BROADPHASE_H
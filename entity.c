@@ -0,0 +1,469 @@
+#include "entity.h"
+#include "profiler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Number of float arrays per entity (see GetEntityFloatArrays)
+#define ENTITY_FLOAT_ARRAYS 14
+
+// Arrays are carved out of one allocation, each starting on its own cache line
+#define ENTITY_ARRAY_ALIGNMENT 64
+
+// Round an array size up to a whole number of cache lines
+static size_t AlignEntityArray(size_t bytes) {
+    return (bytes + ENTITY_ARRAY_ALIGNMENT - 1) & ~(size_t)(ENTITY_ARRAY_ALIGNMENT - 1);
+}
+
+// Collect the addresses of the per-entity float arrays
+static void GetEntityFloatArrays(EntityStore* store, float** arrays[ENTITY_FLOAT_ARRAYS]) {
+    float** fields[ENTITY_FLOAT_ARRAYS] = {
+        &store->positionX, &store->positionY, &store->positionZ,
+        &store->previousX, &store->previousY, &store->previousZ,
+        &store->velocityX, &store->velocityY, &store->velocityZ,
+        &store->sizeX, &store->sizeY, &store->sizeZ,
+        &store->moveX, &store->moveZ
+    };
+    memcpy(arrays, fields, sizeof(fields));
+}
+
+// Create an empty store with room for capacity entities
+EntityStore* CreateEntityStore(int capacity) {
+    if (capacity <= 0) return NULL;
+    
+    EntityStore* store = (EntityStore*)calloc(1, sizeof(EntityStore));
+    if (!store) return NULL;
+    
+    size_t floatArraySize = AlignEntityArray((size_t)capacity * sizeof(float));
+    size_t intArraySize = AlignEntityArray((size_t)capacity * sizeof(int));
+    size_t byteArraySize = AlignEntityArray((size_t)capacity);
+    
+    store->memory = malloc(floatArraySize * ENTITY_FLOAT_ARRAYS + intArraySize * 3 + byteArraySize * 2);
+    store->broadphase = CreateBroadphase(capacity, ENTITY_CELL_SIZE);
+    if (!store->memory || !store->broadphase) {
+        DestroyEntityStore(store);
+        return NULL;
+    }
+    
+    char* next = (char*)store->memory;
+    float** floatArrays[ENTITY_FLOAT_ARRAYS];
+    GetEntityFloatArrays(store, floatArrays);
+    for (int i = 0; i < ENTITY_FLOAT_ARRAYS; i++) {
+        *floatArrays[i] = (float*)next;
+        next += floatArraySize;
+    }
+    
+    store->ids = (int*)next;
+    next += intArraySize;
+    store->indexOfId = (int*)next;
+    next += intArraySize;
+    store->freeIds = (int*)next;
+    next += intArraySize;
+    store->input = (uint8_t*)next;
+    next += byteArraySize;
+    store->flags = (uint8_t*)next;
+    
+    // Hand out low ids first
+    for (int id = 0; id < capacity; id++) {
+        store->indexOfId[id] = -1;
+        store->freeIds[id] = capacity - 1 - id;
+    }
+    
+    store->capacity = capacity;
+    store->freeIdCount = capacity;
+    
+    return store;
+}
+
+// Free a store and all of its entities
+void DestroyEntityStore(EntityStore* store) {
+    if (store) {
+        DestroyBroadphase(store->broadphase);
+        free(store->memory);
+        free(store);
+    }
+}
+
+// Add an entity at rest and return its id (-1 if the store is full)
+int CreateEntity(EntityStore* store, Vector3 position, Vector3 size) {
+    if (!store || store->freeIdCount == 0) return -1;
+    
+    int id = store->freeIds[--store->freeIdCount];
+    int index = store->count++;
+    
+    store->ids[index] = id;
+    store->indexOfId[id] = index;
+    
+    store->positionX[index] = store->previousX[index] = position.x;
+    store->positionY[index] = store->previousY[index] = position.y;
+    store->positionZ[index] = store->previousZ[index] = position.z;
+    store->velocityX[index] = store->velocityY[index] = store->velocityZ[index] = 0.0f;
+    store->sizeX[index] = size.x;
+    store->sizeY[index] = size.y;
+    store->sizeZ[index] = size.z;
+    store->moveX[index] = store->moveZ[index] = 0.0f;
+    store->input[index] = 0;
+    store->flags[index] = 0;
+    
+    return id;
+}
+
+// Remove an entity; the last entity in the arrays takes its place
+void RemoveEntity(EntityStore* store, int id) {
+    int index = GetEntityIndex(store, id);
+    if (index < 0) return;
+    
+    int last = --store->count;
+    if (index != last) {
+        float** floatArrays[ENTITY_FLOAT_ARRAYS];
+        GetEntityFloatArrays(store, floatArrays);
+        for (int i = 0; i < ENTITY_FLOAT_ARRAYS; i++) {
+            (*floatArrays[i])[index] = (*floatArrays[i])[last];
+        }
+        
+        store->input[index] = store->input[last];
+        store->flags[index] = store->flags[last];
+        store->ids[index] = store->ids[last];
+        store->indexOfId[store->ids[index]] = index;
+    }
+    
+    store->indexOfId[id] = -1;
+    store->freeIds[store->freeIdCount++] = id;
+}
+
+// Array index of an entity (-1 if the id is not in use)
+int GetEntityIndex(EntityStore* store, int id) {
+    if (!store || id < 0 || id >= store->capacity) return -1;
+    return store->indexOfId[id];
+}
+
+// Get an entity's position (bottom centre of its box)
+Vector3 GetEntityPosition(EntityStore* store, int id) {
+    int index = GetEntityIndex(store, id);
+    if (index < 0) return (Vector3){ 0.0f, 0.0f, 0.0f };
+    
+    return (Vector3){ store->positionX[index], store->positionY[index], store->positionZ[index] };
+}
+
+// Move an entity without simulating the path there (it lands at rest)
+void SetEntityPosition(EntityStore* store, int id, Vector3 position) {
+    int index = GetEntityIndex(store, id);
+    if (index < 0) return;
+    
+    store->positionX[index] = store->previousX[index] = position.x;
+    store->positionY[index] = store->previousY[index] = position.y;
+    store->positionZ[index] = store->previousZ[index] = position.z;
+    store->velocityX[index] = store->velocityY[index] = store->velocityZ[index] = 0.0f;
+    store->flags[index] = 0;
+}
+
+// Get an entity's velocity in blocks per tick
+Vector3 GetEntityVelocity(EntityStore* store, int id) {
+    int index = GetEntityIndex(store, id);
+    if (index < 0) return (Vector3){ 0.0f, 0.0f, 0.0f };
+    
+    return (Vector3){ store->velocityX[index], store->velocityY[index], store->velocityZ[index] };
+}
+
+// Get an entity's collision box size
+Vector3 GetEntitySize(EntityStore* store, int id) {
+    int index = GetEntityIndex(store, id);
+    if (index < 0) return (Vector3){ 0.0f, 0.0f, 0.0f };
+    
+    return (Vector3){ store->sizeX[index], store->sizeY[index], store->sizeZ[index] };
+}
+
+// Get an entity's ENTITY_* state flags
+uint8_t GetEntityFlags(EntityStore* store, int id) {
+    int index = GetEntityIndex(store, id);
+    return (index < 0) ? 0 : store->flags[index];
+}
+
+// Set what an entity tries to do on the following ticks: the horizontal
+// velocity it wants per tick and its ENTITY_INPUT_* flags
+void SetEntityInput(EntityStore* store, int id, float moveX, float moveZ, uint8_t input) {
+    int index = GetEntityIndex(store, id);
+    if (index < 0) return;
+    
+    store->moveX[index] = moveX;
+    store->moveZ[index] = moveZ;
+    store->input[index] = input;
+}
+
+// Bounding box of the entity at an array index
+static BoundingBox GetBoxAtIndex(EntityStore* store, int index) {
+    float halfX = store->sizeX[index] / 2;
+    float halfZ = store->sizeZ[index] / 2;
+    
+    // The box is centered on X and Z, but bottom-aligned on Y
+    return (BoundingBox){
+        { store->positionX[index] - halfX, store->positionY[index], store->positionZ[index] - halfZ },
+        { store->positionX[index] + halfX, store->positionY[index] + store->sizeY[index], store->positionZ[index] + halfZ }
+    };
+}
+
+// Get the bounding box of an entity at its current position
+BoundingBox GetEntityBoundingBox(EntityStore* store, int id) {
+    int index = GetEntityIndex(store, id);
+    if (index < 0) return (BoundingBox){ 0 };
+    
+    return GetBoxAtIndex(store, index);
+}
+
+// Position to draw an entity at: between the last two physics ticks, by
+// the fraction of a tick that has not been simulated yet
+Vector3 GetEntityRenderPosition(EntityStore* store, int id) {
+    int index = GetEntityIndex(store, id);
+    if (index < 0) return (Vector3){ 0.0f, 0.0f, 0.0f };
+    
+    float alpha = store->tickAccumulator / ENTITY_TICK_TIME;
+    
+    return (Vector3){
+        store->previousX[index] + (store->positionX[index] - store->previousX[index]) * alpha,
+        store->previousY[index] + (store->positionY[index] - store->previousY[index]) * alpha,
+        store->previousZ[index] + (store->positionZ[index] - store->previousZ[index]) * alpha
+    };
+}
+
+// Run as many fixed physics ticks as the frame time covers (called once per
+// frame), so the simulation keeps its speed whatever the frame rate.
+// Returns the number of ticks run.
+int UpdateEntities(EntityStore* store, World* world, float frameTime) {
+    if (!store || !world) return 0;
+    
+    PROFILE_BEGIN("UpdateEntities");
+    store->tickAccumulator += frameTime;
+    
+    int ticks = 0;
+    while (store->tickAccumulator >= ENTITY_TICK_TIME) {
+        // Catch up at most a few ticks; after a long stall, drop the rest
+        if (ticks == MAX_ENTITY_TICKS_PER_FRAME) {
+            store->tickAccumulator = fmodf(store->tickAccumulator, ENTITY_TICK_TIME);
+            break;
+        }
+        
+        StepEntities(store, world);
+        
+        store->tickAccumulator -= ENTITY_TICK_TIME;
+        ticks++;
+    }
+    PROFILE_END();
+    
+    return ticks;
+}
+
+// Turn input into velocity: the requested horizontal velocity (slowed in
+// water), jumps off the ground and swimming up or down
+static void ApplyEntityInput(EntityStore* store) {
+    int count = store->count;
+    float* restrict velocityX = store->velocityX;
+    float* restrict velocityY = store->velocityY;
+    float* restrict velocityZ = store->velocityZ;
+    const float* restrict moveX = store->moveX;
+    const float* restrict moveZ = store->moveZ;
+    const uint8_t* restrict input = store->input;
+    uint8_t* restrict flags = store->flags;
+    
+    for (int i = 0; i < count; i++) {
+        bool inWater = (flags[i] & ENTITY_IN_WATER) != 0;
+        bool onGround = (flags[i] & ENTITY_ON_GROUND) != 0;
+        bool jump = (input[i] & ENTITY_INPUT_JUMP) != 0;
+        bool sink = (input[i] & ENTITY_INPUT_SINK) != 0;
+        
+        float speedFactor = inWater ? WATER_MOVEMENT_FACTOR : 1.0f;
+        velocityX[i] = moveX[i] * speedFactor;
+        velocityZ[i] = moveZ[i] * speedFactor;
+        
+        // Jump from the ground, or swim up and down in water
+        float swim = (jump ? ENTITY_SWIM_SPEED : 0.0f) - (sink ? ENTITY_SWIM_SPEED : 0.0f);
+        bool jumps = jump && !inWater && onGround;
+        velocityY[i] = jumps ? ENTITY_JUMP_FORCE : velocityY[i] + (inWater ? swim : 0.0f);
+        flags[i] = jumps ? (uint8_t)((flags[i] & ~ENTITY_ON_GROUND) | ENTITY_JUMPING) : flags[i];
+    }
+}
+
+// Look up the blocks at each entity's feet and head and update the water
+// flags, keeping the previous state for ApplyEntityForces. These are the
+// only world reads outside the collision sweeps, and are skipped for
+// entities above the cached jello height of their column.
+static void ProbeEntityWater(EntityStore* store, World* world) {
+    for (int i = 0; i < store->count; i++) {
+        int x = (int)floorf(store->positionX[i]);
+        int y = (int)floorf(store->positionY[i]);
+        int z = (int)floorf(store->positionZ[i]);
+        int headY = (int)floorf(store->positionY[i] + store->sizeY[i] * 0.9f); // Check at head level
+        
+        // Entities above the column's highest jello block cannot touch any
+        BlockType feet = BLOCK_EMPTY;
+        BlockType head = BLOCK_EMPTY;
+        if (y <= GetJelloHeight(world, x, z)) {
+            feet = GetBlock(world, x, y, z);
+            head = (headY == y) ? feet : GetBlock(world, x, headY, z);
+        }
+        
+        uint8_t flags = store->flags[i];
+        uint8_t updated = flags & (uint8_t)~(ENTITY_IN_WATER | ENTITY_UNDERWATER |
+                                             ENTITY_WAS_IN_WATER | ENTITY_WAS_UNDERWATER);
+        if (flags & ENTITY_IN_WATER) updated |= ENTITY_WAS_IN_WATER;
+        if (flags & ENTITY_UNDERWATER) updated |= ENTITY_WAS_UNDERWATER;
+        if (feet == BLOCK_JELLO || head == BLOCK_JELLO) updated |= ENTITY_IN_WATER;
+        if (head == BLOCK_JELLO) updated |= ENTITY_UNDERWATER;
+        
+        store->flags[i] = updated;
+    }
+}
+
+// Apply gravity and buoyancy to the vertical velocity
+static void ApplyEntityForces(EntityStore* store) {
+    int count = store->count;
+    float* restrict velocityY = store->velocityY;
+    const uint8_t* restrict input = store->input;
+    const uint8_t* restrict flags = store->flags;
+    
+    for (int i = 0; i < count; i++) {
+        bool onGround = (flags[i] & ENTITY_ON_GROUND) != 0;
+        bool inWater = (flags[i] & ENTITY_IN_WATER) != 0;
+        bool underwater = (flags[i] & ENTITY_UNDERWATER) != 0;
+        bool wasInWater = (flags[i] & ENTITY_WAS_IN_WATER) != 0;
+        bool wasUnderwater = (flags[i] & ENTITY_WAS_UNDERWATER) != 0;
+        float vy = velocityY[i];
+        
+        if (inWater) {
+            // Fully underwater: minimal gravity for more "flying-like" controls.
+            // At the surface: stronger buoyancy to keep the entity floating.
+            float buoyancy = underwater ? ENTITY_BUOYANCY : ENTITY_BUOYANCY * SURFACE_BUOYANCY_FACTOR;
+            float gravity = ENTITY_GRAVITY * (underwater ? UNDERWATER_GRAVITY_FACTOR : SURFACE_GRAVITY_FACTOR);
+            
+            vy += onGround ? 0.0f : buoyancy;
+            vy -= gravity;
+            
+            // Dampen velocity when moving between the surface and underwater
+            if (wasInWater != inWater || wasUnderwater != underwater) vy *= 0.7f;
+            
+            // Cap vertical velocity in water: higher when actively swimming,
+            // lower when floating
+            float maxSpeed = (input[i] & (ENTITY_INPUT_JUMP | ENTITY_INPUT_SINK)) ?
+                             WATER_MAX_VERTICAL_SPEED : WATER_MAX_VERTICAL_SPEED * 0.5f;
+            vy = fminf(fmaxf(vy, -maxSpeed), maxSpeed);
+        } else {
+            vy -= onGround ? 0.0f : ENTITY_GRAVITY;
+            
+            // Small upward boost when leaving water for a smoother transition
+            vy += wasInWater ? ENTITY_BUOYANCY * 0.5f : 0.0f;
+        }
+        
+        velocityY[i] = vy;
+    }
+}
+
+// Move every entity by its velocity, one axis at a time, stopping each move
+// at the first solid block the box would reach
+static void MoveEntities(EntityStore* store, World* world) {
+    for (int i = 0; i < store->count; i++) {
+        float vy = store->velocityY[i];
+        float moveY = SweepBoxAxis(world, GetBoxAtIndex(store, i), 1, vy);
+        store->positionY[i] += moveY;
+        
+        if (moveY != vy) {
+            // If we were moving down, we've hit the ground
+            if (vy < 0) store->flags[i] |= ENTITY_ON_GROUND;
+            
+            // Stop vertical movement
+            store->velocityY[i] = 0.0f;
+        } else {
+            // Still on the ground if a block lies just below the feet
+            float probe = SweepBoxAxis(world, GetBoxAtIndex(store, i), 1, -ENTITY_GROUND_PROBE);
+            if (probe > -ENTITY_GROUND_PROBE) {
+                store->flags[i] |= ENTITY_ON_GROUND;
+            } else {
+                store->flags[i] &= (uint8_t)~ENTITY_ON_GROUND;
+            }
+        }
+        
+        float vx = store->velocityX[i];
+        float moveX = SweepBoxAxis(world, GetBoxAtIndex(store, i), 0, vx);
+        store->positionX[i] += moveX;
+        if (moveX != vx) store->velocityX[i] = 0.0f;
+        
+        float vz = store->velocityZ[i];
+        float moveZ = SweepBoxAxis(world, GetBoxAtIndex(store, i), 2, vz);
+        store->positionZ[i] += moveZ;
+        if (moveZ != vz) store->velocityZ[i] = 0.0f;
+        
+        // Ensure entities don't fall through the bottom of the world
+        if (store->positionY[i] < 0) {
+            store->positionY[i] = 0.0f;
+            store->velocityY[i] = 0.0f;
+            store->flags[i] |= ENTITY_ON_GROUND;
+        }
+    }
+}
+
+// Push overlapping entities apart. The broadphase is rebuilt from the boxes
+// after movement; each pair it reports is separated horizontally, along the
+// axis it overlaps least on, by up to ENTITY_PUSH_SPEED per tick split
+// between both bodies, without pushing either into blocks.
+static void SeparateEntities(EntityStore* store, World* world) {
+    Broadphase* broadphase = store->broadphase;
+    
+    ClearBroadphase(broadphase);
+    for (int i = 0; i < store->count; i++) {
+        AddBroadphaseBox(broadphase, i, GetBoxAtIndex(store, i));
+    }
+    BuildBroadphase(broadphase);
+    
+    if (store->count < 2) return;
+    
+    int neighbours[MAX_ENTITY_NEIGHBOURS];
+    for (int i = 0; i < store->count; i++) {
+        int neighbourCount = QueryBroadphaseBox(broadphase, GetBoxAtIndex(store, i), neighbours, MAX_ENTITY_NEIGHBOURS);
+        
+        for (int n = 0; n < neighbourCount; n++) {
+            // Each pair is handled once, by its lower index
+            int j = neighbours[n];
+            if (j <= i) continue;
+            
+            BoundingBox a = GetBoxAtIndex(store, i);
+            BoundingBox b = GetBoxAtIndex(store, j);
+            float overlapX = fminf(a.max.x, b.max.x) - fmaxf(a.min.x, b.min.x);
+            float overlapY = fminf(a.max.y, b.max.y) - fmaxf(a.min.y, b.min.y);
+            float overlapZ = fminf(a.max.z, b.max.z) - fmaxf(a.min.z, b.min.z);
+            if (overlapX <= 0.0f || overlapY <= 0.0f || overlapZ <= 0.0f) continue;
+            
+            int axis = (overlapX < overlapZ) ? 0 : 2;
+            float* position = (axis == 0) ? store->positionX : store->positionZ;
+            float overlap = (axis == 0) ? overlapX : overlapZ;
+            
+            // j moves towards the side it is on (the positive side for a tie), i the other way
+            float direction = (position[j] >= position[i]) ? 1.0f : -1.0f;
+            float push = fminf(overlap, ENTITY_PUSH_SPEED) * 0.5f;
+            
+            position[i] += SweepBoxAxis(world, a, axis, -direction * push);
+            position[j] += SweepBoxAxis(world, b, axis, direction * push);
+        }
+    }
+}
+
+// Advance every entity by one physics tick. Each stage is a separate pass
+// over the arrays, ending with entity-entity collision. The pure arithmetic
+// stages touch only the arrays they need and have no world reads, so the
+// compiler can vectorize them.
+void StepEntities(EntityStore* store, World* world) {
+    if (!store || !world) return;
+    
+    PROFILE_BEGIN("StepEntities");
+    
+    // Remember where each entity started the tick (for interpolation)
+    size_t bytes = (size_t)store->count * sizeof(float);
+    memcpy(store->previousX, store->positionX, bytes);
+    memcpy(store->previousY, store->positionY, bytes);
+    memcpy(store->previousZ, store->positionZ, bytes);
+    
+    ApplyEntityInput(store);
+    ProbeEntityWater(store, world);
+    ApplyEntityForces(store);
+    MoveEntities(store, world);
+    SeparateEntities(store, world);
+    
+    PROFILE_END();
+}
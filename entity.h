@@ -0,0 +1,99 @@
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include "raylib.h"
+#include "voxel.h"
+#include "broadphase.h"
+
+// Physics runs on a fixed tick (the speeds and forces here are per tick)
+#define ENTITY_TICK_RATE 60
+#define ENTITY_TICK_TIME (1.0f / ENTITY_TICK_RATE)
+#define MAX_ENTITY_TICKS_PER_FRAME 8 // Longer stalls are dropped rather than replayed
+
+// Entity physics constants
+#define ENTITY_JUMP_FORCE 0.15f
+#define ENTITY_GRAVITY 0.005f
+#define ENTITY_GROUND_PROBE 0.1f  // Gap below the feet that still counts as standing
+
+// Entity-entity collision constants
+#define ENTITY_CELL_SIZE 2.0f     // Broadphase cell edge (about the size of the largest body)
+#define ENTITY_PUSH_SPEED 0.05f   // Most an overlapping pair is pushed apart per tick
+#define MAX_ENTITY_NEIGHBOURS 32  // Overlapping bodies resolved per entity and tick
+
+// Water physics constants
+#define ENTITY_BUOYANCY 0.3f      // Buoyancy force in water
+#define WATER_MOVEMENT_FACTOR 0.6f // Movement speed reduction in water
+#define ENTITY_SWIM_SPEED 0.15f   // Speed for vertical swimming movement
+#define WATER_MAX_VERTICAL_SPEED 0.4f // Maximum vertical velocity in water
+#define SURFACE_BUOYANCY_FACTOR 1.2f // Stronger buoyancy near the surface
+#define UNDERWATER_GRAVITY_FACTOR 0.3f // Reduced gravity when fully underwater
+#define SURFACE_GRAVITY_FACTOR 0.6f // Gravity when at water surface (higher than underwater)
+
+// Entity state flags (maintained by the physics step)
+#define ENTITY_ON_GROUND 0x01     // Standing on a solid block
+#define ENTITY_JUMPING 0x02       // Left the ground by jumping
+#define ENTITY_IN_WATER 0x04      // Feet or head in jello
+#define ENTITY_UNDERWATER 0x08    // Head in jello
+#define ENTITY_WAS_IN_WATER 0x10  // ENTITY_IN_WATER before the last water probe
+#define ENTITY_WAS_UNDERWATER 0x20 // ENTITY_UNDERWATER before the last water probe
+
+// Entity input flags (set by whatever drives the entity: keyboard, AI or network)
+#define ENTITY_INPUT_JUMP 0x01    // Jump, or swim up in water
+#define ENTITY_INPUT_SINK 0x02    // Swim down in water
+
+// Structure-of-arrays store of physics bodies. Live entities are packed in
+// [0, count) so the physics step walks every array front to back; removing
+// an entity moves the last one into its place. Entity ids stay valid across
+// removals and are mapped to array indices through indexOfId.
+typedef struct {
+    int count;                // Live entities
+    int capacity;             // Maximum number of entities
+    
+    // Per-entity arrays (indexed 0..count-1)
+    float* positionX;         // Bottom centre of the collision box
+    float* positionY;
+    float* positionZ;
+    float* previousX;         // Position before the last physics tick
+    float* previousY;
+    float* previousZ;
+    float* velocityX;         // Velocity in blocks per tick
+    float* velocityY;
+    float* velocityZ;
+    float* sizeX;             // Collision box size
+    float* sizeY;
+    float* sizeZ;
+    float* moveX;             // Requested horizontal velocity per tick (on land)
+    float* moveZ;
+    uint8_t* input;           // ENTITY_INPUT_* flags
+    uint8_t* flags;           // ENTITY_* state flags
+    int* ids;                 // Id of the entity stored at each index
+    
+    // Id bookkeeping (indexed by id)
+    int* indexOfId;           // Array index of each id (-1 when unused)
+    int* freeIds;             // Stack of unused ids
+    int freeIdCount;
+    
+    Broadphase* broadphase;   // Entity boxes after the last tick's movement (ids are array indices)
+    
+    float tickAccumulator;    // Frame time not yet simulated (less than one tick after an update)
+    void* memory;             // Single allocation backing all arrays
+} EntityStore;
+
+// Function prototypes
+EntityStore* CreateEntityStore(int capacity);
+void DestroyEntityStore(EntityStore* store);
+int CreateEntity(EntityStore* store, Vector3 position, Vector3 size);
+void RemoveEntity(EntityStore* store, int id);
+int GetEntityIndex(EntityStore* store, int id);
+Vector3 GetEntityPosition(EntityStore* store, int id);
+void SetEntityPosition(EntityStore* store, int id, Vector3 position);
+Vector3 GetEntityVelocity(EntityStore* store, int id);
+Vector3 GetEntitySize(EntityStore* store, int id);
+uint8_t GetEntityFlags(EntityStore* store, int id);
+void SetEntityInput(EntityStore* store, int id, float moveX, float moveZ, uint8_t input);
+BoundingBox GetEntityBoundingBox(EntityStore* store, int id);
+Vector3 GetEntityRenderPosition(EntityStore* store, int id);
+int UpdateEntities(EntityStore* store, World* world, float frameTime);
+void StepEntities(EntityStore* store, World* world);
+
+#endif // ENTITY_H
@@ -0,0 +1,71 @@
+#include "frustum.h"
+#include <math.h>
+
+// Small vector helpers
+static Vector3 Add3(Vector3 a, Vector3 b) { return (Vector3){ a.x + b.x, a.y + b.y, a.z + b.z }; }
+static Vector3 Scale3(Vector3 v, float s) { return (Vector3){ v.x * s, v.y * s, v.z * s }; }
+static float Dot3(Vector3 a, Vector3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+static Vector3 Cross3(Vector3 a, Vector3 b) {
+    return (Vector3){ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+static Vector3 Normalize3(Vector3 v) {
+    float length = sqrtf(Dot3(v, v));
+    return (length > 0.0f) ? Scale3(v, 1.0f / length) : v;
+}
+
+// Build a plane through a point with the given inward-facing normal
+static FrustumPlane MakePlane(Vector3 normal, Vector3 point) {
+    return (FrustumPlane){ normal, -Dot3(normal, point) };
+}
+
+// Build the frustum of a perspective camera (fovy in degrees, aspect = width / height)
+Frustum GetCameraFrustum(Camera camera, float aspect) {
+    Frustum frustum;
+    
+    // Camera basis
+    Vector3 forward = Normalize3(Add3(camera.target, Scale3(camera.position, -1.0f)));
+    Vector3 right = Normalize3(Cross3(forward, camera.up));
+    Vector3 up = Cross3(right, forward);
+    
+    // Half extents of the view at distance 1
+    float halfHeight = tanf(camera.fovy * 0.5f * PI / 180.0f);
+    float halfWidth = halfHeight * aspect;
+    
+    // Side planes pass through the eye and contain one edge of the view
+    Vector3 leftEdge = Add3(forward, Scale3(right, -halfWidth));
+    Vector3 rightEdge = Add3(forward, Scale3(right, halfWidth));
+    Vector3 bottomEdge = Add3(forward, Scale3(up, -halfHeight));
+    Vector3 topEdge = Add3(forward, Scale3(up, halfHeight));
+    
+    frustum.planes[0] = MakePlane(Cross3(leftEdge, up), camera.position);
+    frustum.planes[1] = MakePlane(Cross3(up, rightEdge), camera.position);
+    frustum.planes[2] = MakePlane(Cross3(right, bottomEdge), camera.position);
+    frustum.planes[3] = MakePlane(Cross3(topEdge, right), camera.position);
+    frustum.planes[4] = MakePlane(forward, Add3(camera.position, Scale3(forward, FRUSTUM_NEAR_PLANE)));
+    frustum.planes[5] = MakePlane(Scale3(forward, -1.0f), Add3(camera.position, Scale3(forward, FRUSTUM_FAR_PLANE)));
+    
+    return frustum;
+}
+
+// Check if an axis-aligned box is at least partly inside the frustum.
+// Conservative: boxes near a frustum corner may be reported as visible.
+bool IsBoxInFrustum(const Frustum* frustum, BoundingBox box) {
+    for (int i = 0; i < 6; i++) {
+        const FrustumPlane* plane = &frustum->planes[i];
+        
+        // Test the box corner furthest along the plane normal
+        Vector3 corner = {
+            (plane->normal.x >= 0.0f) ? box.max.x : box.min.x,
+            (plane->normal.y >= 0.0f) ? box.max.y : box.min.y,
+            (plane->normal.z >= 0.0f) ? box.max.z : box.min.z
+        };
+        
+        if (Dot3(plane->normal, corner) + plane->distance < 0.0f) {
+            return false;
+        }
+    }
+    
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+// Default clip distances used by raylib's perspective projection
+#define FRUSTUM_NEAR_PLANE 0.01f
+#define FRUSTUM_FAR_PLANE 1000.0f
+
+// Plane in the form dot(normal, p) + distance = 0; the inside of the frustum
+// is where the expression is positive
+typedef struct {
+    Vector3 normal;
+    float distance;
+} FrustumPlane;
+
+// View frustum: left, right, bottom, top, near and far planes
+typedef struct {
+    FrustumPlane planes[6];
+} Frustum;
+
+// Function prototypes
+Frustum GetCameraFrustum(Camera camera, float aspect);
+bool IsBoxInFrustum(const Frustum* frustum, BoundingBox box);
+
+#endif // FRUSTUM_H
@@ -0,0 +1,221 @@
+#include "jobs.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include <unistd.h>
+
+// Create an empty queue; capacity is rounded up to a power of two
+bool InitJobQueue(JobQueue* queue, int capacity) {
+    size_t size = 2;
+    while (size < (size_t)capacity) size *= 2;
+    
+    queue->cells = (JobQueueCell*)malloc(size * sizeof(JobQueueCell));
+    if (!queue->cells) return false;
+    
+    // Each cell starts out ready for the producer at its own position
+    for (size_t i = 0; i < size; i++) {
+        queue->cells[i].sequence = i;
+    }
+    queue->mask = size - 1;
+    queue->enqueuePos = 0;
+    queue->dequeuePos = 0;
+    
+    return true;
+}
+
+// Free the queue's storage (the queue must no longer be in use)
+void FreeJobQueue(JobQueue* queue) {
+    free(queue->cells);
+    queue->cells = NULL;
+}
+
+// Add a job to the queue; returns false when the queue is full
+bool PushJob(JobQueue* queue, Job job) {
+    JobQueueCell* cell;
+    size_t pos = __atomic_load_n(&queue->enqueuePos, __ATOMIC_RELAXED);
+    
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        
+        if (diff == 0) {
+            // The cell is free; try to claim this position
+            if (__atomic_compare_exchange_n(&queue->enqueuePos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The cell still holds a job from one lap ago
+            return false;
+        } else {
+            pos = __atomic_load_n(&queue->enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+    
+    cell->job = job;
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+    
+    return true;
+}
+
+// Take the oldest job from the queue; returns false when the queue is empty
+bool PopJob(JobQueue* queue, Job* job) {
+    JobQueueCell* cell;
+    size_t pos = __atomic_load_n(&queue->dequeuePos, __ATOMIC_RELAXED);
+    
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+        
+        if (diff == 0) {
+            // The cell holds a published job; try to claim it
+            if (__atomic_compare_exchange_n(&queue->dequeuePos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Nothing has been published at this position yet
+            return false;
+        } else {
+            pos = __atomic_load_n(&queue->dequeuePos, __ATOMIC_RELAXED);
+        }
+    }
+    
+    *job = cell->job;
+    __atomic_store_n(&cell->sequence, pos + queue->mask + 1, __ATOMIC_RELEASE);
+    
+    return true;
+}
+
+// Run a job and record that it finished
+static void RunJob(JobSystem* jobs, Job job) {
+    job.function(job.data);
+    __atomic_sub_fetch(&jobs->activeJobs, 1, __ATOMIC_RELEASE);
+}
+
+// Worker thread: run jobs until the pool shuts down, sleeping while the queue is empty
+static void* WorkerMain(void* arg) {
+    JobSystem* jobs = (JobSystem*)arg;
+    Job job;
+    
+    for (;;) {
+        if (PopJob(&jobs->queue, &job)) {
+            RunJob(jobs, job);
+            continue;
+        }
+        
+        pthread_mutex_lock(&jobs->mutex);
+        if (jobs->stopping) {
+            pthread_mutex_unlock(&jobs->mutex);
+            break;
+        }
+        
+        // Check again under the lock so a wakeup cannot be missed
+        if (PopJob(&jobs->queue, &job)) {
+            pthread_mutex_unlock(&jobs->mutex);
+            RunJob(jobs, job);
+            continue;
+        }
+        
+        jobs->sleepingWorkers++;
+        pthread_cond_wait(&jobs->wake, &jobs->mutex);
+        jobs->sleepingWorkers--;
+        pthread_mutex_unlock(&jobs->mutex);
+    }
+    
+    return NULL;
+}
+
+// Get the number of online processors (at least 1)
+int GetProcessorCount(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (int)count : 1;
+#else
+    return 1;
+#endif
+}
+
+// Start a pool of worker threads (workerCount <= 0 uses one per spare core)
+JobSystem* CreateJobSystem(int workerCount) {
+    if (workerCount <= 0) {
+        workerCount = GetProcessorCount() - 1;
+        if (workerCount < 1) workerCount = 1;
+    }
+    
+    JobSystem* jobs = (JobSystem*)calloc(1, sizeof(JobSystem));
+    if (!jobs) return NULL;
+    
+    jobs->workers = (pthread_t*)malloc(workerCount * sizeof(pthread_t));
+    if (!jobs->workers || !InitJobQueue(&jobs->queue, JOB_QUEUE_CAPACITY)) {
+        free(jobs->workers);
+        free(jobs);
+        return NULL;
+    }
+    
+    pthread_mutex_init(&jobs->mutex, NULL);
+    pthread_cond_init(&jobs->wake, NULL);
+    
+    for (int i = 0; i < workerCount; i++) {
+        if (pthread_create(&jobs->workers[i], NULL, WorkerMain, jobs) != 0) break;
+        jobs->workerCount++;
+    }
+    
+    return jobs;
+}
+
+// Finish all submitted jobs, stop the workers and free the pool
+void DestroyJobSystem(JobSystem* jobs) {
+    if (!jobs) return;
+    
+    WaitForJobs(jobs);
+    
+    pthread_mutex_lock(&jobs->mutex);
+    jobs->stopping = true;
+    pthread_cond_broadcast(&jobs->wake);
+    pthread_mutex_unlock(&jobs->mutex);
+    
+    for (int i = 0; i < jobs->workerCount; i++) {
+        pthread_join(jobs->workers[i], NULL);
+    }
+    
+    pthread_cond_destroy(&jobs->wake);
+    pthread_mutex_destroy(&jobs->mutex);
+    FreeJobQueue(&jobs->queue);
+    free(jobs->workers);
+    free(jobs);
+}
+
+// Queue a job for the workers; returns false when the queue is full
+bool SubmitJob(JobSystem* jobs, JobFunction function, void* data) {
+    __atomic_add_fetch(&jobs->activeJobs, 1, __ATOMIC_RELAXED);
+    
+    if (!PushJob(&jobs->queue, (Job){ function, data })) {
+        __atomic_sub_fetch(&jobs->activeJobs, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    
+    pthread_mutex_lock(&jobs->mutex);
+    if (jobs->sleepingWorkers > 0) {
+        pthread_cond_signal(&jobs->wake);
+    }
+    pthread_mutex_unlock(&jobs->mutex);
+    
+    return true;
+}
+
+// Block until every submitted job has finished, running queued jobs on the
+// calling thread in the meantime
+void WaitForJobs(JobSystem* jobs) {
+    Job job;
+    
+    while (__atomic_load_n(&jobs->activeJobs, __ATOMIC_ACQUIRE) > 0) {
+        if (PopJob(&jobs->queue, &job)) {
+            RunJob(jobs, job);
+        } else {
+            sched_yield();
+        }
+    }
+}
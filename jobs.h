@@ -0,0 +1,63 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+// Number of jobs that can wait in the worker queue at once
+#define JOB_QUEUE_CAPACITY 4096
+
+// A unit of work: a function and the data it runs on
+typedef void (*JobFunction)(void* data);
+
+typedef struct {
+    JobFunction function;
+    void* data;
+} Job;
+
+// Slot of a job queue; the sequence number tells producers and consumers
+// whether the slot is ready for them
+typedef struct {
+    size_t sequence;
+    Job job;
+} JobQueueCell;
+
+// Bounded lock-free multi-producer multi-consumer queue of jobs.
+// The positions are padded onto separate cache lines to avoid false sharing.
+typedef struct {
+    JobQueueCell* cells;
+    size_t mask;              // Capacity - 1 (capacity is a power of two)
+    char padding0[64];
+    size_t enqueuePos;        // Next position to write
+    char padding1[64];
+    size_t dequeuePos;        // Next position to read
+    char padding2[64];
+} JobQueue;
+
+// Pool of worker threads running jobs from a shared queue
+typedef struct {
+    pthread_t* workers;       // Worker thread handles
+    int workerCount;          // Number of worker threads
+    JobQueue queue;           // Jobs waiting for a worker
+    int activeJobs;           // Jobs submitted but not yet finished (atomic)
+    bool stopping;            // Set when the pool shuts down
+    int sleepingWorkers;      // Workers blocked on wake (guarded by mutex)
+    pthread_mutex_t mutex;    // Protects sleeping workers
+    pthread_cond_t wake;      // Signalled when work is submitted
+} JobSystem;
+
+// Lock-free queue operations (safe from any thread)
+bool InitJobQueue(JobQueue* queue, int capacity);
+void FreeJobQueue(JobQueue* queue);
+bool PushJob(JobQueue* queue, Job job);
+bool PopJob(JobQueue* queue, Job* job);
+
+// Worker pool management
+int GetProcessorCount(void);
+JobSystem* CreateJobSystem(int workerCount);
+void DestroyJobSystem(JobSystem* jobs);
+bool SubmitJob(JobSystem* jobs, JobFunction function, void* data);
+void WaitForJobs(JobSystem* jobs);
+
+#endif // JOBS_H
@@ -2,169 +2,26 @@
 #include "voxel.h"
 #include "player.h"
 #include "terrain.h"
+#include "renderer.h"
+#include "jobs.h"
+#include "streaming.h"
+#include "raycast.h"
+#include "profiler.h"
+#include <stdlib.h>
 
 // Window dimensions
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
 #define GAME_TITLE "Simple Voxel Game"
 
-// Color definitions for different block types
-const Color BLOCK_COLORS[BLOCK_TYPE_COUNT] = {
-    { 0, 0, 0, 0 },        // BLOCK_EMPTY (transparent)
-    { 34, 139, 34, 255 },  // BLOCK_GRASS (forest green)
-    { 210, 180, 140, 255 },// BLOCK_SAND (tan)
-    { 128, 128, 128, 255 },// BLOCK_STONE (gray)
-    { 223, 64, 64, 150 }  // BLOCK_JELLO (semi-transparent red)
-};
+// Directory the world is saved to and loaded from
+#define WORLD_SAVE_DIRECTORY "world"
 
-// Define render distance (how far to render blocks)
-#define RENDER_DISTANCE 48
+// Most physics bodies (the player and mobs) the world can hold
+#define MAX_ENTITIES 4096
 
-// Draw a single block face
-void DrawBlockFace(int x, int y, int z, int faceDir, Color color) {
-    // Define corners of a cube
-    const float vertices[8][3] = {
-        { x + 0.0f, y + 0.0f, z + 0.0f }, // 0: bottom-left-back
-        { x + 1.0f, y + 0.0f, z + 0.0f }, // 1: bottom-right-back
-        { x + 1.0f, y + 1.0f, z + 0.0f }, // 2: top-right-back
-        { x + 0.0f, y + 1.0f, z + 0.0f }, // 3: top-left-back
-        { x + 0.0f, y + 0.0f, z + 1.0f }, // 4: bottom-left-front
-        { x + 1.0f, y + 0.0f, z + 1.0f }, // 5: bottom-right-front
-        { x + 1.0f, y + 1.0f, z + 1.0f }, // 6: top-right-front
-        { x + 0.0f, y + 1.0f, z + 1.0f }  // 7: top-left-front
-    };
-
-    // Define the indices for each face (CCW winding)
-    const int faceIndices[6][4] = {
-        { 1, 2, 6, 5 }, // +X face
-        { 0, 4, 7, 3 }, // -X face
-        { 3, 7, 6, 2 }, // +Y face
-        { 0, 1, 5, 4 }, // -Y face
-        { 4, 5, 6, 7 }, // +Z face
-        { 0, 3, 2, 1 }  // -Z face
-    };
-
-    // Slightly adjust color based on face direction for better visibility
-    Color faceColor = color;
-    switch (faceDir) {
-        case 0: // +X (right)
-            faceColor.r = (unsigned char)(color.r * 0.9f);
-            faceColor.g = (unsigned char)(color.g * 0.9f);
-            faceColor.b = (unsigned char)(color.b * 0.9f);
-            break;
-        case 1: // -X (left)
-            faceColor.r = (unsigned char)(color.r * 0.8f);
-            faceColor.g = (unsigned char)(color.g * 0.8f);
-            faceColor.b = (unsigned char)(color.b * 0.8f);
-            break;
-        case 2: // +Y (top)
-            // Keep original color for top faces
-            break;
-        case 3: // -Y (bottom)
-            faceColor.r = (unsigned char)(color.r * 0.7f);
-            faceColor.g = (unsigned char)(color.g * 0.7f);
-            faceColor.b = (unsigned char)(color.b * 0.7f);
-            break;
-        case 4: // +Z (front)
-            faceColor.r = (unsigned char)(color.r * 0.85f);
-            faceColor.g = (unsigned char)(color.g * 0.85f);
-            faceColor.b = (unsigned char)(color.b * 0.85f);
-            break;
-        case 5: // -Z (back)
-            faceColor.r = (unsigned char)(color.r * 0.75f);
-            faceColor.g = (unsigned char)(color.g * 0.75f);
-            faceColor.b = (unsigned char)(color.b * 0.75f);
-            break;
-    }
-
-    // Get vertices for this face
-    Vector3 v0 = { vertices[faceIndices[faceDir][0]][0], vertices[faceIndices[faceDir][0]][1], vertices[faceIndices[faceDir][0]][2] };
-    Vector3 v1 = { vertices[faceIndices[faceDir][1]][0], vertices[faceIndices[faceDir][1]][1], vertices[faceIndices[faceDir][1]][2] };
-    Vector3 v2 = { vertices[faceIndices[faceDir][2]][0], vertices[faceIndices[faceDir][2]][1], vertices[faceIndices[faceDir][2]][2] };
-    Vector3 v3 = { vertices[faceIndices[faceDir][3]][0], vertices[faceIndices[faceDir][3]][1], vertices[faceIndices[faceDir][3]][2] };
-
-    // Draw two triangles to form the face quad
-    DrawTriangle3D(v0, v1, v2, faceColor);
-    DrawTriangle3D(v0, v2, v3, faceColor);
-}
-
-// Render the voxel world
-void RenderWorld(World* world, Player* player) {
-    if (!world || !player) return;
-
-    // Calculate the maximum distance to render blocks
-    int renderHalfDistance = RENDER_DISTANCE / 2;
-
-    // Convert player position to integer coordinates
-    int playerX = (int)player->position.x;
-    int playerY = (int)player->position.y;
-    int playerZ = (int)player->position.z;
-
-    // Calculate visible range
-    int startX = playerX - renderHalfDistance;
-    int startY = playerY - renderHalfDistance;
-    int startZ = playerZ - renderHalfDistance;
-    int endX = playerX + renderHalfDistance;
-    int endY = playerY + renderHalfDistance;
-    int endZ = playerZ + renderHalfDistance;
-
-    // Clamp to world bounds
-    startX = (startX < 0) ? 0 : startX;
-    startY = (startY < 0) ? 0 : startY;
-    startZ = (startZ < 0) ? 0 : startZ;
-    endX = (endX >= WORLD_SIZE_X) ? WORLD_SIZE_X - 1 : endX;
-    endY = (endY >= WORLD_SIZE_Y) ? WORLD_SIZE_Y - 1 : endY;
-    endZ = (endZ >= WORLD_SIZE_Z) ? WORLD_SIZE_Z - 1 : endZ;
-
-    // First pass: Render opaque blocks
-    for (int x = startX; x <= endX; x++) {
-        for (int y = startY; y <= endY; y++) {
-            for (int z = startZ; z <= endZ; z++) {
-                // Get the block type
-                BlockType blockType = GetBlock(world, x, y, z);
-
-                // Skip empty blocks and transparent blocks (will be rendered in second pass)
-                if (blockType == BLOCK_EMPTY || IsBlockTransparent(blockType)) continue;
-
-                // Get the color for this block type
-                Color blockColor = BLOCK_COLORS[blockType];
-
-                // Check and draw each visible face
-                for (int faceDir = 0; faceDir < 6; faceDir++) {
-                    if (IsBlockFaceVisible(world, x, y, z, faceDir)) {
-                        DrawBlockFace(x, y, z, faceDir, blockColor);
-                    }
-                }
-            }
-        }
-    }
-
-    // Second pass: Render transparent blocks
-    // Enable alpha blending for transparent objects
-    BeginBlendMode(BLEND_ALPHA);
-    for (int x = startX; x <= endX; x++) {
-        for (int y = startY; y <= endY; y++) {
-            for (int z = startZ; z <= endZ; z++) {
-                // Get the block type
-                BlockType blockType = GetBlock(world, x, y, z);
-
-                // Only render transparent blocks (not empty and transparent)
-                if (blockType == BLOCK_EMPTY || !IsBlockTransparent(blockType)) continue;
-
-                // Get the color for this block type
-                Color blockColor = BLOCK_COLORS[blockType];
-
-                // Check and draw each visible face
-                for (int faceDir = 0; faceDir < 6; faceDir++) {
-                    if (IsBlockFaceVisible(world, x, y, z, faceDir)) {
-                        DrawBlockFace(x, y, z, faceDir, blockColor);
-                    }
-                }
-            }
-        }
-    }
-    EndBlendMode();
-}
+// File the profiler writes its Chrome trace to on exit (make profile)
+#define PROFILE_TRACE_PATH "profile_trace.json"
 
 // Draw a simple crosshair in the center of the screen
 void DrawCrosshair() {
@@ -176,7 +33,30 @@ void DrawCrosshair() {
     DrawLine(centerX, centerY - 10, centerX, centerY + 10, WHITE);
 }
 
-int main(void) {
+#ifdef ENABLE_PROFILER
+// Draw the time spent in each profiled zone during the last frame, with its
+// moving average and the number of times it ran
+void DrawProfilerOverlay(int x, int y) {
+    ProfileZoneStats zones[PROFILER_MAX_ZONES];
+    int zoneCount = GetProfileZoneStats(zones, PROFILER_MAX_ZONES);
+    
+    DrawRectangle(x - 5, y - 5, 420, zoneCount * 20 + 30, Fade(BLACK, 0.6f));
+    DrawText(TextFormat("Profiler (%ld zones dropped)", GetProfileDroppedEvents()), x, y, 20, WHITE);
+    for (int i = 0; i < zoneCount; i++) {
+        DrawText(TextFormat("%-20s %7.3f ms %7.3f avg %5d", zones[i].name, zones[i].frameMs,
+                            zones[i].averageMs, zones[i].calls), x, y + 20 * (i + 1), 20, WHITE);
+    }
+}
+#endif
+
+int main(int argc, char** argv) {
+    // The world seed can be given on the command line to reproduce a world
+    // (a saved world keeps the seed it was created with)
+    unsigned int seed = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 10) : DEFAULT_WORLD_SEED;
+    
+    // Start timing the hot paths (does nothing unless built with make profile)
+    PROFILE_INIT();
+    
     // Initialize the window and OpenGL context
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, GAME_TITLE);
     
@@ -186,12 +66,28 @@ int main(void) {
     // Disable cursor for first-person mouse look
     DisableCursor();
     
-    // Create and initialize the voxel world
-    World* world = CreateWorld();
-    GenerateTerrain(world);
+    // Start the worker threads that generate terrain and build chunk meshes
+    JobSystem* jobs = CreateJobSystem(0);
+    
+    // Open the saved world (columns are decoded as they are first reached),
+    // or create and generate a new one from the seed
+    World* world = LoadWorldLazy(WORLD_SAVE_DIRECTORY);
+    if (!world) {
+        world = CreateWorld();
+        GenerateTerrainSeeded(world, seed, jobs);
+    }
     
-    // Create and initialize the player
-    Player* player = CreatePlayer(world);
+    // Create the store of physics bodies, and the player with a body in it
+    EntityStore* entities = CreateEntityStore(MAX_ENTITIES);
+    Player* player = CreatePlayer(world, entities);
+    
+    // Stream chunk columns in around the player and out again when memory runs short
+    WorldStreamer* streamer = CreateWorldStreamer(jobs, world->seed, STREAM_RADIUS, STREAM_MEMORY_BUDGET,
+                                                  WORLD_SAVE_DIRECTORY);
+    
+    // Create the renderer that caches chunk meshes on the GPU, drawing through raylib
+    RenderBackend* backend = CreateRaylibRenderBackend();
+    WorldRenderer* renderer = CreateWorldRenderer(jobs, backend);
     
     // Initialize the camera for a 3D perspective view
     Camera camera = { 0 };
@@ -205,12 +101,42 @@ int main(void) {
     while (!WindowShouldClose()) {
         // Update game logic
         
-        // Update player physics and handle input
-        UpdatePlayer(player, world);
+        // Handle player input, then advance every body by the ticks this frame covers
+        UpdatePlayer(player);
+        UpdateEntities(entities, world, GetFrameTime());
         
         // Update camera based on player position and orientation
         UpdateCameraFromPlayer(&camera, player);
         
+        // Find the block under the crosshair (jello is see-through for picking)
+        Ray view = { camera.position, { camera.target.x - camera.position.x,
+                                        camera.target.y - camera.position.y,
+                                        camera.target.z - camera.position.z } };
+        RaycastHit target = RaycastWorld(world, view, PLAYER_REACH, RAYCAST_IGNORE_JELLO);
+        
+        // Left click breaks the targeted block, right click places stone against
+        // the face it was hit on (unless the new block would overlap the player
+        // or another body)
+        if (target.hit && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+            SetBlock(world, target.x, target.y, target.z, BLOCK_EMPTY);
+        } else if (target.hit && IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) {
+            int px = target.x + target.normalX;
+            int py = target.y + target.normalY;
+            int pz = target.z + target.normalZ;
+            int blocker;
+            if (QueryBroadphaseBox(entities->broadphase, GetBlockBoundingBox(px, py, pz), &blocker, 1) == 0) {
+                SetBlock(world, px, py, pz, BLOCK_STONE);
+            }
+        }
+        
+        // Insert generated columns and request the ones the player is heading towards
+        Vector3 forward = { camera.target.x - camera.position.x, 0.0f, camera.target.z - camera.position.z };
+        UpdateWorldStreamer(streamer, world, GetPlayerPosition(player), forward);
+        
+        // Upload meshes finished by the workers and queue new mesh jobs
+        ResetRenderBackendStats(backend);
+        UpdateWorldRenderer(renderer, world, player);
+        
         // Begin drawing
         BeginDrawing();
             ClearBackground(SKYBLUE);
@@ -218,19 +144,56 @@ int main(void) {
             // Draw 3D elements
             BeginMode3D(camera);
                 // Render the voxel world
-                RenderWorld(world, player);
+                RenderWorld(renderer, world, player, camera);
+                
+                // Outline the targeted block
+                if (target.hit) {
+                    DrawCubeWires((Vector3){ target.x + 0.5f, target.y + 0.5f, target.z + 0.5f },
+                                  1.01f, 1.01f, 1.01f, BLACK);
+                }
             EndMode3D();
             
             // Draw 2D UI elements
             DrawFPS(10, 10);
-            DrawText("WASD - Move, SPACE - Jump, Mouse - Look", 10, 30, 20, BLACK);
+            DrawText("WASD - Move, SPACE - Jump, Mouse - Look, LMB/RMB - Break/Place", 10, 30, 20, BLACK);
+            DrawText(TextFormat("Chunks: %d reached, %d drawn (%d LOD), %d culled, %d tested",
+                                renderer->stats.chunksReached,
+                                renderer->stats.chunksDrawn,
+                                renderer->stats.lodChunksDrawn,
+                                renderer->stats.chunksCulled,
+                                renderer->stats.chunksTested), 10, 55, 20, BLACK);
+            DrawText(TextFormat("Columns: %d loaded, %d generating, %d queued, %d saving, %d KB",
+                                streamer->stats.loadedColumns,
+                                streamer->stats.generatingColumns,
+                                streamer->stats.pendingColumns,
+                                streamer->stats.savingColumns,
+                                (int)(streamer->stats.memoryUsage / 1024)), 10, 80, 20, BLACK);
+            DrawText(TextFormat("Draws: %d calls, %ld triangles, %d uploads, %ld KB sent",
+                                backend->stats.drawCalls,
+                                backend->stats.triangles,
+                                backend->stats.meshUploads + backend->stats.bufferUpdates,
+                                backend->stats.bytesUploaded / 1024), 10, 105, 20, BLACK);
             DrawCrosshair();
             
+#ifdef ENABLE_PROFILER
+            DrawProfilerOverlay(10, 135);
+#endif
+        
         EndDrawing();
+        
+        // Close the profiler's frame: drain the per-thread timings into the overlay
+        PROFILE_FRAME();
     }
     
-    // Cleanup resources
+    // Cleanup resources (the streamer finishes its pending saves first)
+    DestroyWorldStreamer(streamer, world);
+    SaveWorld(world, WORLD_SAVE_DIRECTORY);
+    DestroyWorldRenderer(renderer);
+    DestroyRenderBackend(backend);
+    DestroyJobSystem(jobs);
+    PROFILE_SHUTDOWN(PROFILE_TRACE_PATH);
     DestroyPlayer(player);
+    DestroyEntityStore(entities);
     DestroyWorld(world);
     
     // Re-enable cursor before closing
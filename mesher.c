@@ -0,0 +1,546 @@
+#include "mesher.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Color definitions for different block types
+const Color BLOCK_COLORS[BLOCK_TYPE_COUNT] = {
+    { 0, 0, 0, 0 },        // BLOCK_EMPTY (transparent)
+    { 34, 139, 34, 255 },  // BLOCK_GRASS (forest green)
+    { 210, 180, 140, 255 },// BLOCK_SAND (tan)
+    { 128, 128, 128, 255 },// BLOCK_STONE (gray)
+    { 223, 64, 64, 150 }  // BLOCK_JELLO (semi-transparent red)
+};
+
+// Brightness of each face direction (+X, -X, +Y, -Y, +Z, -Z) for better visibility
+static const float FACE_SHADE[6] = { 0.9f, 0.8f, 1.0f, 0.7f, 0.85f, 0.75f };
+
+// Unit cube corners and the corners of each face (CCW winding seen from outside)
+static const int CUBE_CORNERS[8][3] = {
+    { 0, 0, 0 }, // 0: bottom-left-back
+    { 1, 0, 0 }, // 1: bottom-right-back
+    { 1, 1, 0 }, // 2: top-right-back
+    { 0, 1, 0 }, // 3: top-left-back
+    { 0, 0, 1 }, // 4: bottom-left-front
+    { 1, 0, 1 }, // 5: bottom-right-front
+    { 1, 1, 1 }, // 6: top-right-front
+    { 0, 1, 1 }  // 7: top-left-front
+};
+
+static const int FACE_CORNERS[6][4] = {
+    { 1, 2, 6, 5 }, // +X face
+    { 0, 4, 7, 3 }, // -X face
+    { 3, 7, 6, 2 }, // +Y face
+    { 0, 1, 5, 4 }, // -Y face
+    { 4, 5, 6, 7 }, // +Z face
+    { 0, 3, 2, 1 }  // -Z face
+};
+
+// Slightly adjust color based on face direction for better visibility
+Color GetBlockFaceColor(BlockType blockType, int faceDir) {
+    Color color = BLOCK_COLORS[blockType];
+    Color faceColor = color;
+    
+    faceColor.r = (unsigned char)(color.r * FACE_SHADE[faceDir]);
+    faceColor.g = (unsigned char)(color.g * FACE_SHADE[faceDir]);
+    faceColor.b = (unsigned char)(color.b * FACE_SHADE[faceDir]);
+    
+    return faceColor;
+}
+
+// Offset to the neighbouring chunk across each face (+X, -X, +Y, -Y, +Z, -Z)
+static const int NEIGHBOUR_OFFSETS[6][3] = {
+    { 1, 0, 0 }, {-1, 0, 0 }, { 0, 1, 0 }, { 0,-1, 0 }, { 0, 0, 1 }, { 0, 0,-1 }
+};
+
+// Whether a chunk is uniformly opaque (see IsChunkUniform)
+static inline bool IsChunkSolid(const Chunk* chunk) {
+    return chunk && IsChunkUniform(chunk) && !IsBlockTransparent((BlockType)chunk->palette[0]);
+}
+
+// Whether a chunk is uniformly opaque and so are its six face neighbours:
+// none of its faces can be visible, at any level of detail. Decided from
+// the chunks' palettes alone, without reading a block.
+static bool IsChunkEnclosed(World* world, const Chunk* chunk) {
+    if (!IsChunkSolid(chunk)) return false;
+    
+    for (int faceDir = 0; faceDir < 6; faceDir++) {
+        if (!IsChunkSolid(GetChunk(world,
+                                   chunk->cx + NEIGHBOUR_OFFSETS[faceDir][0],
+                                   chunk->cy + NEIGHBOUR_OFFSETS[faceDir][1],
+                                   chunk->cz + NEIGHBOUR_OFFSETS[faceDir][2]))) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Copy one face layer of a neighbouring chunk into the snapshot border
+static void CopyNeighbourLayer(World* world, ChunkSnapshot* snapshot, int faceDir) {
+    Chunk* neighbour = GetChunk(world,
+                                snapshot->cx + NEIGHBOUR_OFFSETS[faceDir][0],
+                                snapshot->cy + NEIGHBOUR_OFFSETS[faceDir][1],
+                                snapshot->cz + NEIGHBOUR_OFFSETS[faceDir][2]);
+    if (!neighbour) return;
+    
+    int axis = faceDir / 2;
+    int src = (faceDir % 2 == 0) ? 0 : CHUNK_MASK;   // Layer read from the neighbour
+    int dst = (faceDir % 2 == 0) ? CHUNK_SIZE : -1;  // Border layer in the snapshot
+    
+    for (int i = 0; i < CHUNK_SIZE; i++) {
+        for (int j = 0; j < CHUNK_SIZE; j++) {
+            int s[3], d[3];
+            s[axis] = src;
+            d[axis] = dst;
+            s[(axis + 1) % 3] = d[(axis + 1) % 3] = i;
+            s[(axis + 2) % 3] = d[(axis + 2) % 3] = j;
+            
+            snapshot->blocks[SNAPSHOT_INDEX(d[0], d[1], d[2])] =
+                (BlockId)GetChunkBlock(neighbour, s[0], s[1], s[2]);
+        }
+    }
+}
+
+// Copy a chunk and the adjoining layers of its neighbours into a snapshot.
+// Enclosed chunks (see IsChunkEnclosed) are flagged instead of copied.
+void CreateChunkSnapshot(World* world, int cx, int cy, int cz, ChunkSnapshot* snapshot) {
+    snapshot->cx = cx;
+    snapshot->cy = cy;
+    snapshot->cz = cz;
+    
+    Chunk* chunk = GetChunk(world, cx, cy, cz);
+    snapshot->enclosed = chunk && IsChunkEnclosed(world, chunk);
+    if (snapshot->enclosed) return;
+    
+    memset(snapshot->blocks, BLOCK_EMPTY, sizeof(snapshot->blocks));
+    if (!chunk) return;
+    
+    // Decode the chunk once, then copy rows into the padded layout
+    BlockId blocks[CHUNK_VOLUME];
+    UnpackChunkBlocks(chunk, blocks);
+    
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            memcpy(&snapshot->blocks[SNAPSHOT_INDEX(x, y, 0)], &blocks[CHUNK_INDEX(x, y, 0)], CHUNK_SIZE);
+        }
+    }
+    
+    for (int faceDir = 0; faceDir < 6; faceDir++) {
+        CopyNeighbourLayer(world, snapshot, faceDir);
+    }
+}
+
+// Snapshot a chunk at a level of detail: the chunk is split into cells of
+// (1 << level) blocks per side, and every block of a cell takes the type of
+// the cell's highest non-empty block, so the greedy mesher merges whole
+// cells. A cell is empty only if all of its blocks are, which keeps coarse
+// terrain at or above the real surface. The border is left empty, so faces
+// on the chunk's sides are always emitted; together these close the seams
+// with neighbours meshed at other levels.
+void CreateLodSnapshot(World* world, int cx, int cy, int cz, int level, ChunkSnapshot* snapshot) {
+    snapshot->cx = cx;
+    snapshot->cy = cy;
+    snapshot->cz = cz;
+    
+    Chunk* chunk = GetChunk(world, cx, cy, cz);
+    snapshot->enclosed = chunk && IsChunkEnclosed(world, chunk);
+    if (snapshot->enclosed) return;
+    
+    memset(snapshot->blocks, BLOCK_EMPTY, sizeof(snapshot->blocks));
+    if (!chunk) return;
+    
+    BlockId blocks[CHUNK_VOLUME];
+    UnpackChunkBlocks(chunk, blocks);
+    
+    int cell = 1 << level;
+    
+    for (int x0 = 0; x0 < CHUNK_SIZE; x0 += cell) {
+        for (int y0 = 0; y0 < CHUNK_SIZE; y0 += cell) {
+            for (int z0 = 0; z0 < CHUNK_SIZE; z0 += cell) {
+                // Highest non-empty block of the cell
+                BlockId type = BLOCK_EMPTY;
+                for (int y = y0 + cell - 1; y >= y0 && type == BLOCK_EMPTY; y--) {
+                    for (int x = x0; x < x0 + cell && type == BLOCK_EMPTY; x++) {
+                        for (int z = z0; z < z0 + cell && type == BLOCK_EMPTY; z++) {
+                            type = blocks[CHUNK_INDEX(x, y, z)];
+                        }
+                    }
+                }
+                if (type == BLOCK_EMPTY) continue;
+                
+                for (int x = x0; x < x0 + cell; x++) {
+                    for (int y = y0; y < y0 + cell; y++) {
+                        memset(&snapshot->blocks[SNAPSHOT_INDEX(x, y, z0)], type, cell);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Make room for at least extra more vertices
+static bool ReserveVertices(MeshBuffer* buffer, int extra) {
+    if (buffer->vertexCount + extra <= buffer->vertexCapacity) return true;
+    
+    int capacity = buffer->vertexCapacity ? buffer->vertexCapacity * 2 : 384;
+    while (capacity < buffer->vertexCount + extra) capacity *= 2;
+    
+    float* vertices = (float*)realloc(buffer->vertices, capacity * 3 * sizeof(float));
+    if (!vertices) return false;
+    buffer->vertices = vertices;
+    
+    unsigned char* colors = (unsigned char*)realloc(buffer->colors, capacity * 4);
+    if (!colors) return false;
+    buffer->colors = colors;
+    
+    buffer->vertexCapacity = capacity;
+    return true;
+}
+
+// Append a quad covering the box [min, min + size) on the given face as two triangles
+static bool EmitQuad(MeshBuffer* buffer, const float min[3], const float size[3], int faceDir, Color color) {
+    if (!ReserveVertices(buffer, VERTICES_PER_QUAD)) return false;
+    
+    static const int triangleCorners[VERTICES_PER_QUAD] = { 0, 1, 2, 0, 2, 3 };
+    
+    for (int i = 0; i < VERTICES_PER_QUAD; i++) {
+        const int* corner = CUBE_CORNERS[FACE_CORNERS[faceDir][triangleCorners[i]]];
+        float* v = &buffer->vertices[buffer->vertexCount * 3];
+        unsigned char* c = &buffer->colors[buffer->vertexCount * 4];
+        
+        v[0] = min[0] + corner[0] * size[0];
+        v[1] = min[1] + corner[1] * size[1];
+        v[2] = min[2] + corner[2] * size[2];
+        c[0] = color.r;
+        c[1] = color.g;
+        c[2] = color.b;
+        c[3] = color.a;
+        
+        buffer->vertexCount++;
+    }
+    
+    return true;
+}
+
+// Index of the lowest set bit (bits must not be zero)
+static inline int CountTrailingZeros(uint32_t bits) {
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#else
+    int count = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// Bits of a snapshot column that lie inside the chunk (the lowest and highest
+// bits are the borders copied from the neighbours)
+#define SNAPSHOT_INTERIOR_BITS (((1u << CHUNK_SIZE) - 1) << 1)
+
+// Add one merged quad of a block type to the mesh and grow its bounds
+static bool AddQuad(ChunkMeshData* mesh, const float min[3], const float size[3], int faceDir, BlockType type) {
+    if (mesh->quadCount == 0) {
+        mesh->bounds.min = (Vector3){ min[0], min[1], min[2] };
+        mesh->bounds.max = mesh->bounds.min;
+    }
+    mesh->bounds.min.x = fminf(mesh->bounds.min.x, min[0]);
+    mesh->bounds.min.y = fminf(mesh->bounds.min.y, min[1]);
+    mesh->bounds.min.z = fminf(mesh->bounds.min.z, min[2]);
+    mesh->bounds.max.x = fmaxf(mesh->bounds.max.x, min[0] + size[0]);
+    mesh->bounds.max.y = fmaxf(mesh->bounds.max.y, min[1] + size[1]);
+    mesh->bounds.max.z = fmaxf(mesh->bounds.max.z, min[2] + size[2]);
+    
+    MeshBuffer* buffer = IsBlockTransparent(type) ? &mesh->transparent : &mesh->opaque;
+    if (!EmitQuad(buffer, min, size, faceDir, GetBlockFaceColor(type, faceDir))) return false;
+    
+    mesh->quadCount++;
+    return true;
+}
+
+// Build greedy-merged geometry for a chunk snapshot.
+// Coplanar visible faces of the same block type are merged into maximal rectangles.
+// Faces are culled a whole column at a time with bitsets, and the merge
+// works on one 16-bit row of a slice at a time.
+bool BuildChunkMesh(const ChunkSnapshot* snapshot, ChunkMeshData* mesh) {
+    memset(mesh, 0, sizeof(ChunkMeshData));
+    if (snapshot->enclosed) return true;
+    
+    float origin[3] = {
+        (float)(snapshot->cx * CHUNK_SIZE),
+        (float)(snapshot->cy * CHUNK_SIZE),
+        (float)(snapshot->cz * CHUNK_SIZE)
+    };
+    
+    // Occupancy of every snapshot column along each axis, per block type:
+    // columns[axis][type][a][b] has bit k set when the block k - 1 along the
+    // axis (and a - 1, b - 1 along the axes that follow it) is of that type
+    uint32_t columns[3][BLOCK_TYPE_COUNT][SNAPSHOT_SIZE][SNAPSHOT_SIZE];
+    memset(columns, 0, sizeof(columns));
+    
+    for (int x = 0; x < SNAPSHOT_SIZE; x++) {
+        for (int y = 0; y < SNAPSHOT_SIZE; y++) {
+            const BlockId* row = &snapshot->blocks[SNAPSHOT_INDEX(x - 1, y - 1, -1)];
+            for (int z = 0; z < SNAPSHOT_SIZE; z++) {
+                BlockId block = row[z];
+                if (block == BLOCK_EMPTY) continue;
+                
+                columns[0][block][y][z] |= 1u << x;
+                columns[1][block][z][x] |= 1u << y;
+                columns[2][block][x][y] |= 1u << z;
+            }
+        }
+    }
+    
+    // Visible faces of one direction, as rows of bits along u per slice and v
+    uint16_t planes[BLOCK_TYPE_COUNT][CHUNK_SIZE][CHUNK_SIZE];
+    
+    for (int faceDir = 0; faceDir < 6; faceDir++) {
+        int axis = faceDir / 2;
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        bool positive = (faceDir % 2 == 0);
+        
+        // Cull a whole column per step: a face is visible where the block
+        // shifted one step along the axis is air, or transparent in front of
+        // an opaque block
+        memset(planes, 0, sizeof(planes));
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            for (int j = 0; j < CHUNK_SIZE; j++) {
+                uint32_t filled = 0, opaque = 0;
+                for (int type = 1; type < BLOCK_TYPE_COUNT; type++) {
+                    filled |= columns[axis][type][i + 1][j + 1];
+                    if (!IsBlockTransparent((BlockType)type)) opaque |= columns[axis][type][i + 1][j + 1];
+                }
+                if (!filled) continue;
+                
+                uint32_t neighbourFilled = positive ? filled >> 1 : filled << 1;
+                uint32_t neighbourOpaque = positive ? opaque >> 1 : opaque << 1;
+                uint32_t visible = (uint32_t)GetVisibleFaceBits(filled, opaque, neighbourFilled, neighbourOpaque) &
+                                   SNAPSHOT_INTERIOR_BITS;
+                
+                for (int type = 1; type < BLOCK_TYPE_COUNT && visible; type++) {
+                    uint32_t bits = visible & columns[axis][type][i + 1][j + 1];
+                    while (bits) {
+                        planes[type][CountTrailingZeros(bits) - 1][j] |= (uint16_t)(1u << i);
+                        bits &= bits - 1;
+                    }
+                }
+            }
+        }
+        
+        // Greedily cover each slice with rectangles of a single block type
+        for (int slice = 0; slice < CHUNK_SIZE; slice++) {
+            for (int type = 1; type < BLOCK_TYPE_COUNT; type++) {
+                uint16_t* rows = planes[type][slice];
+                
+                for (int j = 0; j < CHUNK_SIZE; j++) {
+                    while (rows[j]) {
+                        // Take the lowest run of set bits, then extend it
+                        // along v while the next row contains all of it
+                        int i = CountTrailingZeros(rows[j]);
+                        int width = CountTrailingZeros(~((uint32_t)rows[j] >> i));
+                        uint16_t run = (uint16_t)(((1u << width) - 1) << i);
+                        
+                        int height = 1;
+                        while (j + height < CHUNK_SIZE && (rows[j + height] & run) == run) {
+                            rows[j + height] &= (uint16_t)~run;
+                            height++;
+                        }
+                        rows[j] &= (uint16_t)~run;
+                        
+                        float min[3], size[3];
+                        min[axis] = origin[axis] + slice;
+                        min[u] = origin[u] + i;
+                        min[v] = origin[v] + j;
+                        size[axis] = 1.0f;
+                        size[u] = (float)width;
+                        size[v] = (float)height;
+                        
+                        if (!AddQuad(mesh, min, size, faceDir, (BlockType)type)) {
+                            FreeChunkMeshData(mesh);
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    return true;
+}
+
+// A run of blocks claimed by the connectivity flood fill: bits of one row
+// along Z
+typedef struct {
+    uint8_t x, y;
+    uint16_t bits;
+} FillSpan;
+
+// Grow bits of a row to the whole runs of open blocks they touch
+static inline uint16_t ExpandSpan(uint16_t bits, uint16_t open) {
+    uint16_t grown = bits & open;
+    uint16_t previous;
+    do {
+        previous = grown;
+        grown = (uint16_t)((grown | (grown << 1) | (grown >> 1)) & open);
+    } while (grown != previous);
+    return grown;
+}
+
+// Flood fill the transparent blocks of a snapshot's chunk from every face
+// and record which faces each connected region touches. The fill works on
+// runs of blocks along Z held as row bitsets, so it moves a whole run per
+// step. Regions that touch no face cannot be seen through and are skipped.
+uint16_t GetChunkConnectivity(const ChunkSnapshot* snapshot) {
+    if (snapshot->enclosed) return 0;
+    
+    bool transparent[BLOCK_TYPE_COUNT];
+    for (int type = 0; type < BLOCK_TYPE_COUNT; type++) {
+        transparent[type] = IsBlockTransparent((BlockType)type);
+    }
+    
+    // Transparent blocks not yet reached: bit z of open[x][y]
+    uint16_t open[CHUNK_SIZE][CHUNK_SIZE];
+    int openRows = 0, fullRows = 0;
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            const BlockId* row = &snapshot->blocks[SNAPSHOT_INDEX(x, y, 0)];
+            uint16_t bits = 0;
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                bits |= (uint16_t)(transparent[row[z]] << z);
+            }
+            open[x][y] = bits;
+            openRows += (bits != 0);
+            fullRows += (bits == 0xFFFF);
+        }
+    }
+    
+    if (openRows == 0) return 0;
+    if (fullRows == CHUNK_SIZE * CHUNK_SIZE) return CHUNK_ALL_FACES_CONNECTED;
+    
+    FillSpan stack[CHUNK_VOLUME];
+    uint16_t connectivity = 0;
+    
+    for (int sx = 0; sx < CHUNK_SIZE; sx++) {
+        for (int sy = 0; sy < CHUNK_SIZE; sy++) {
+            bool sideRow = sx == 0 || sx == CHUNK_MASK || sy == 0 || sy == CHUNK_MASK;
+            
+            // Start a region from every open block on a face of the chunk
+            while (open[sx][sy] & (sideRow ? 0xFFFF : 0x8001)) {
+                uint16_t seed = open[sx][sy] & (sideRow ? 0xFFFF : 0x8001);
+                seed &= (uint16_t)-seed;
+                
+                int faces = 0;
+                int top = 0;
+                uint16_t span = ExpandSpan(seed, open[sx][sy]);
+                open[sx][sy] &= (uint16_t)~span;
+                stack[top++] = (FillSpan){ (uint8_t)sx, (uint8_t)sy, span };
+                
+                while (top > 0) {
+                    FillSpan fill = stack[--top];
+                    
+                    if (fill.x == CHUNK_MASK) faces |= 1 << 0;
+                    if (fill.x == 0) faces |= 1 << 1;
+                    if (fill.y == CHUNK_MASK) faces |= 1 << 2;
+                    if (fill.y == 0) faces |= 1 << 3;
+                    if (fill.bits & 0x8000) faces |= 1 << 4;
+                    if (fill.bits & 0x0001) faces |= 1 << 5;
+                    
+                    // Claim the runs of the four neighbouring rows this run touches
+                    for (int faceDir = 0; faceDir < 4; faceDir++) {
+                        int nx = fill.x + NEIGHBOUR_OFFSETS[faceDir][0];
+                        int ny = fill.y + NEIGHBOUR_OFFSETS[faceDir][1];
+                        if (nx < 0 || nx > CHUNK_MASK || ny < 0 || ny > CHUNK_MASK) continue;
+                        if (!(open[nx][ny] & fill.bits)) continue;
+                        
+                        uint16_t grown = ExpandSpan(fill.bits, open[nx][ny]);
+                        open[nx][ny] &= (uint16_t)~grown;
+                        stack[top++] = (FillSpan){ (uint8_t)nx, (uint8_t)ny, grown };
+                    }
+                }
+                
+                for (int a = 0; a < 6; a++) {
+                    for (int b = a + 1; b < 6; b++) {
+                        if ((faces >> a) & (faces >> b) & 1) connectivity |= GetFacePairBit(a, b);
+                    }
+                }
+                if (connectivity == CHUNK_ALL_FACES_CONNECTED) return connectivity;
+            }
+        }
+    }
+    
+    return connectivity;
+}
+
+// A quad of a buffer and its squared distance from the view point
+typedef struct {
+    float distanceSq;
+    int quad;
+} QuadDepth;
+
+// Order quads farthest first (ties keep buffer order so sorts are repeatable)
+static int CompareQuadDepths(const void* a, const void* b) {
+    const QuadDepth* qa = (const QuadDepth*)a;
+    const QuadDepth* qb = (const QuadDepth*)b;
+    if (qa->distanceSq != qb->distanceSq) return (qa->distanceSq < qb->distanceSq) ? 1 : -1;
+    return (qa->quad > qb->quad) - (qa->quad < qb->quad);
+}
+
+// Reorder the quads of a buffer back to front as seen from a point, so that
+// blended faces composite correctly when drawn in buffer order. Quads are
+// ranked by the distance to their centres (the midpoint of the diagonal
+// shared by their two triangles).
+bool SortMeshBufferQuads(MeshBuffer* buffer, Vector3 viewPoint) {
+    int quadCount = buffer->vertexCount / VERTICES_PER_QUAD;
+    if (quadCount < 2) return true;
+    
+    QuadDepth* order = (QuadDepth*)malloc(quadCount * sizeof(QuadDepth));
+    float* vertices = (float*)malloc(buffer->vertexCount * 3 * sizeof(float));
+    unsigned char* colors = (unsigned char*)malloc(buffer->vertexCount * 4);
+    if (!order || !vertices || !colors) {
+        free(order);
+        free(vertices);
+        free(colors);
+        return false;
+    }
+    
+    for (int q = 0; q < quadCount; q++) {
+        const float* v = &buffer->vertices[q * VERTICES_PER_QUAD * 3];
+        float dx = (v[0] + v[6]) * 0.5f - viewPoint.x;
+        float dy = (v[1] + v[7]) * 0.5f - viewPoint.y;
+        float dz = (v[2] + v[8]) * 0.5f - viewPoint.z;
+        order[q] = (QuadDepth){ dx * dx + dy * dy + dz * dz, q };
+    }
+    
+    qsort(order, quadCount, sizeof(QuadDepth), CompareQuadDepths);
+    
+    for (int i = 0; i < quadCount; i++) {
+        int q = order[i].quad;
+        memcpy(&vertices[i * VERTICES_PER_QUAD * 3], &buffer->vertices[q * VERTICES_PER_QUAD * 3],
+               VERTICES_PER_QUAD * 3 * sizeof(float));
+        memcpy(&colors[i * VERTICES_PER_QUAD * 4], &buffer->colors[q * VERTICES_PER_QUAD * 4], VERTICES_PER_QUAD * 4);
+    }
+    
+    memcpy(buffer->vertices, vertices, buffer->vertexCount * 3 * sizeof(float));
+    memcpy(buffer->colors, colors, buffer->vertexCount * 4);
+    
+    free(order);
+    free(vertices);
+    free(colors);
+    return true;
+}
+
+// Free the buffers owned by a chunk mesh
+void FreeChunkMeshData(ChunkMeshData* mesh) {
+    if (!mesh) return;
+    
+    free(mesh->opaque.vertices);
+    free(mesh->opaque.colors);
+    free(mesh->transparent.vertices);
+    free(mesh->transparent.colors);
+    memset(mesh, 0, sizeof(ChunkMeshData));
+}
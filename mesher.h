@@ -0,0 +1,79 @@
+#ifndef MESHER_H
+#define MESHER_H
+
+#include "voxel.h"
+
+// A chunk snapshot holds the chunk's blocks plus a one-block border copied
+// from its face neighbours, so meshing never has to look into the world
+#define SNAPSHOT_SIZE (CHUNK_SIZE + 2)
+#define SNAPSHOT_VOLUME (SNAPSHOT_SIZE * SNAPSHOT_SIZE * SNAPSHOT_SIZE)
+
+// Index of a block in a snapshot (local coordinates range from -1 to CHUNK_SIZE)
+#define SNAPSHOT_INDEX(x, y, z) \
+    ((((x) + 1) * SNAPSHOT_SIZE + ((y) + 1)) * SNAPSHOT_SIZE + ((z) + 1))
+
+// Read-only copy of the voxel data needed to mesh one chunk
+typedef struct {
+    int cx, cy, cz;                          // Chunk coordinates
+    bool enclosed;                           // Chunk has no visible faces (blocks were not copied)
+    BlockId blocks[SNAPSHOT_VOLUME];         // Block ids, see SNAPSHOT_INDEX
+} ChunkSnapshot;
+
+// Quads are emitted as two non-indexed triangles
+#define VERTICES_PER_QUAD 6
+
+// Growable CPU vertex buffer of non-indexed triangles
+typedef struct {
+    float* vertices;          // 3 floats (x, y, z) per vertex
+    unsigned char* colors;    // 4 bytes (r, g, b, a) per vertex
+    int vertexCount;          // Number of vertices written
+    int vertexCapacity;       // Number of vertices allocated
+} MeshBuffer;
+
+// CPU-side geometry of one chunk, split by render pass
+typedef struct {
+    MeshBuffer opaque;        // Solid block faces
+    MeshBuffer transparent;   // Faces of transparent blocks (drawn blended)
+    int quadCount;            // Number of merged quads emitted
+    BoundingBox bounds;       // World-space bounds of all quads (valid if quadCount > 0)
+} ChunkMeshData;
+
+// Color definitions for different block types
+extern const Color BLOCK_COLORS[BLOCK_TYPE_COUNT];
+
+// Face shading
+Color GetBlockFaceColor(BlockType blockType, int faceDir);
+
+// Levels of detail: level n meshes a chunk from cells of 2^n blocks per side
+#define MAX_LOD_LEVEL 3
+
+// Snapshot creation (must run on the thread that owns the world)
+void CreateChunkSnapshot(World* world, int cx, int cy, int cz, ChunkSnapshot* snapshot);
+void CreateLodSnapshot(World* world, int cx, int cy, int cz, int level, ChunkSnapshot* snapshot);
+
+// Greedy meshing (pure CPU, safe to call from any thread)
+bool BuildChunkMesh(const ChunkSnapshot* snapshot, ChunkMeshData* mesh);
+void FreeChunkMeshData(ChunkMeshData* mesh);
+
+// Face connectivity of a chunk: one bit per pair of its faces (in faceDir
+// order), set when the two faces are joined by a path of transparent blocks
+// inside the chunk, so the chunk can be seen through from one to the other
+#define CHUNK_ALL_FACES_CONNECTED 0x7FFF
+
+// Bit of a pair of different faces in a face connectivity mask
+static inline uint16_t GetFacePairBit(int faceA, int faceB) {
+    if (faceA > faceB) {
+        int swap = faceA;
+        faceA = faceB;
+        faceB = swap;
+    }
+    return (uint16_t)(1u << (faceA * (11 - faceA) / 2 + faceB - faceA - 1));
+}
+
+// Face connectivity of a snapshot's chunk (pure CPU, safe to call from any thread)
+uint16_t GetChunkConnectivity(const ChunkSnapshot* snapshot);
+
+// Back-to-front ordering of blended quads (pure CPU, safe to call from any thread)
+bool SortMeshBufferQuads(MeshBuffer* buffer, Vector3 viewPoint);
+
+#endif // MESHER_H
@@ -0,0 +1,288 @@
+#include "noise.h"
+#include "terrain.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NOISE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// Octave scales and weights shared by every height kernel
+#define OCTAVE_SCALE_1 (NOISE_SCALE)
+#define OCTAVE_SCALE_2 (NOISE_SCALE * 2.0f)
+#define OCTAVE_SCALE_3 (NOISE_SCALE * 4.0f)
+
+typedef void (*NoiseRowFunction)(float* out, int count, int startX, int z, float coordScale, float scale, unsigned int seed);
+typedef void (*HeightRowFunction)(float* heights, int count, int startX, int z, unsigned int seed);
+
+// Height of one column (the reference the vector kernels must match)
+static float ScalarHeight(int x, int z, unsigned int seed) {
+    // Base terrain using primary noise
+    float noise = GenerateNoise2DSeeded((float)x, (float)z, OCTAVE_SCALE_1, seed);
+    
+    // Add some smaller scale noise for detail
+    noise += 0.5f * GenerateNoise2DSeeded((float)x, (float)z, OCTAVE_SCALE_2, seed);
+    noise += 0.25f * GenerateNoise2DSeeded((float)x, (float)z, OCTAVE_SCALE_3, seed);
+    
+    // Normalize and scale
+    noise = (noise + 1.0f) * 0.5f; // Map from [-1,1] to [0,1]
+    
+    // Convert to height value
+    return noise * TERRAIN_HEIGHT_SCALE + TERRAIN_HEIGHT_OFFSET;
+}
+
+// Scalar fallback kernels
+static void NoiseRowScalar(float* out, int count, int startX, int z, float coordScale, float scale, unsigned int seed) {
+    for (int i = 0; i < count; i++) {
+        out[i] = GenerateNoise2DSeeded((float)(startX + i) * coordScale, (float)z * coordScale, scale, seed);
+    }
+}
+
+static void HeightRowScalar(float* heights, int count, int startX, int z, unsigned int seed) {
+    for (int i = 0; i < count; i++) {
+        heights[i] = ScalarHeight(startX + i, z, seed);
+    }
+}
+
+#ifdef NOISE_X86_KERNELS
+
+// ---------------------------------------------------------------------------
+// AVX2 kernels (8 lanes). Every step uses the same float operations in the
+// same order as GenerateNoise2D, so results match the scalar path bit for bit.
+// ---------------------------------------------------------------------------
+
+// Lattice value NoiseHash(x, z, seed) / 100000.0f for 8 lattice points;
+// seedTerm is the seed's (constant) contribution to the hash
+__attribute__((target("avx2")))
+static __m256 LatticeValueAVX2(__m256i x, __m256i z, __m256i seedTerm) {
+    __m256i hash = _mm256_xor_si256(_mm256_mullo_epi32(x, _mm256_set1_epi32(73856093)),
+                                    _mm256_mullo_epi32(z, _mm256_set1_epi32(19349663)));
+    hash = _mm256_xor_si256(hash, seedTerm);
+    
+    // hash % 100000: the double quotient truncates exactly for any 32-bit hash
+    __m256d divisor = _mm256_set1_pd(100000.0);
+    __m128i quotientLo = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(hash)), divisor));
+    __m128i quotientHi = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(hash, 1)), divisor));
+    __m256i quotient = _mm256_inserti128_si256(_mm256_castsi128_si256(quotientLo), quotientHi, 1);
+    __m256i remainder = _mm256_sub_epi32(hash, _mm256_mullo_epi32(quotient, _mm256_set1_epi32(100000)));
+    
+    return _mm256_div_ps(_mm256_cvtepi32_ps(remainder), _mm256_set1_ps(100000.0f));
+}
+
+// Cubic fade t * t * (3 - 2t)
+__attribute__((target("avx2")))
+static __m256 SmoothFadeAVX2(__m256 t) {
+    return _mm256_mul_ps(_mm256_mul_ps(t, t), _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), t)));
+}
+
+// Linear interpolation a + t * (b - a)
+__attribute__((target("avx2")))
+static __m256 InterpolateAVX2(__m256 a, __m256 b, __m256 t) {
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+// GenerateNoise2D for 8 points
+__attribute__((target("avx2")))
+static __m256 Noise2DAVX2(__m256 x, __m256 z, float scale, __m256i seedTerm) {
+    x = _mm256_mul_ps(x, _mm256_set1_ps(scale));
+    z = _mm256_mul_ps(z, _mm256_set1_ps(scale));
+    
+    __m256i x0 = _mm256_cvttps_epi32(_mm256_floor_ps(x));
+    __m256i z0 = _mm256_cvttps_epi32(_mm256_floor_ps(z));
+    __m256i x1 = _mm256_add_epi32(x0, _mm256_set1_epi32(1));
+    __m256i z1 = _mm256_add_epi32(z0, _mm256_set1_epi32(1));
+    
+    __m256 sxFade = SmoothFadeAVX2(_mm256_sub_ps(x, _mm256_cvtepi32_ps(x0)));
+    __m256 szFade = SmoothFadeAVX2(_mm256_sub_ps(z, _mm256_cvtepi32_ps(z0)));
+    
+    __m256 n00 = LatticeValueAVX2(x0, z0, seedTerm);
+    __m256 n10 = LatticeValueAVX2(x1, z0, seedTerm);
+    __m256 n01 = LatticeValueAVX2(x0, z1, seedTerm);
+    __m256 n11 = LatticeValueAVX2(x1, z1, seedTerm);
+    
+    __m256 nx0 = InterpolateAVX2(n00, n10, sxFade);
+    __m256 nx1 = InterpolateAVX2(n01, n11, sxFade);
+    __m256 nxz = InterpolateAVX2(nx0, nx1, szFade);
+    
+    return _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), nxz), _mm256_set1_ps(1.0f));
+}
+
+// Integer x coordinates startX + i .. startX + i + 7 as floats
+__attribute__((target("avx2")))
+static __m256 RowCoordsAVX2(int firstX) {
+    return _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(firstX), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+}
+
+__attribute__((target("avx2")))
+static void NoiseRowAVX2(float* out, int count, int startX, int z, float coordScale, float scale, unsigned int seed) {
+    __m256 pz = _mm256_set1_ps((float)z * coordScale);
+    __m256i seedTerm = _mm256_set1_epi32(NoiseSeedTerm(seed));
+    int i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_mul_ps(RowCoordsAVX2(startX + i), _mm256_set1_ps(coordScale));
+        _mm256_storeu_ps(&out[i], Noise2DAVX2(px, pz, scale, seedTerm));
+    }
+    
+    NoiseRowScalar(&out[i], count - i, startX + i, z, coordScale, scale, seed);
+}
+
+__attribute__((target("avx2")))
+static void HeightRowAVX2(float* heights, int count, int startX, int z, unsigned int seed) {
+    __m256 pz = _mm256_set1_ps((float)z);
+    __m256i seedTerm = _mm256_set1_epi32(NoiseSeedTerm(seed));
+    int i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = RowCoordsAVX2(startX + i);
+        __m256 noise = Noise2DAVX2(px, pz, OCTAVE_SCALE_1, seedTerm);
+        noise = _mm256_add_ps(noise, _mm256_mul_ps(_mm256_set1_ps(0.5f), Noise2DAVX2(px, pz, OCTAVE_SCALE_2, seedTerm)));
+        noise = _mm256_add_ps(noise, _mm256_mul_ps(_mm256_set1_ps(0.25f), Noise2DAVX2(px, pz, OCTAVE_SCALE_3, seedTerm)));
+        noise = _mm256_mul_ps(_mm256_add_ps(noise, _mm256_set1_ps(1.0f)), _mm256_set1_ps(0.5f));
+        
+        __m256 height = _mm256_add_ps(_mm256_mul_ps(noise, _mm256_set1_ps((float)TERRAIN_HEIGHT_SCALE)),
+                                      _mm256_set1_ps((float)TERRAIN_HEIGHT_OFFSET));
+        _mm256_storeu_ps(&heights[i], height);
+    }
+    
+    HeightRowScalar(&heights[i], count - i, startX + i, z, seed);
+}
+
+// ---------------------------------------------------------------------------
+// SSE4.1 kernels (4 lanes), same structure as the AVX2 ones
+// ---------------------------------------------------------------------------
+
+__attribute__((target("sse4.1")))
+static __m128 LatticeValueSSE41(__m128i x, __m128i z, __m128i seedTerm) {
+    __m128i hash = _mm_xor_si128(_mm_mullo_epi32(x, _mm_set1_epi32(73856093)),
+                                 _mm_mullo_epi32(z, _mm_set1_epi32(19349663)));
+    hash = _mm_xor_si128(hash, seedTerm);
+    
+    __m128d divisor = _mm_set1_pd(100000.0);
+    __m128i quotientLo = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(hash), divisor));
+    __m128i quotientHi = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(hash, 8)), divisor));
+    __m128i quotient = _mm_unpacklo_epi64(quotientLo, quotientHi);
+    __m128i remainder = _mm_sub_epi32(hash, _mm_mullo_epi32(quotient, _mm_set1_epi32(100000)));
+    
+    return _mm_div_ps(_mm_cvtepi32_ps(remainder), _mm_set1_ps(100000.0f));
+}
+
+__attribute__((target("sse4.1")))
+static __m128 SmoothFadeSSE41(__m128 t) {
+    return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), t)));
+}
+
+__attribute__((target("sse4.1")))
+static __m128 InterpolateSSE41(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+__attribute__((target("sse4.1")))
+static __m128 Noise2DSSE41(__m128 x, __m128 z, float scale, __m128i seedTerm) {
+    x = _mm_mul_ps(x, _mm_set1_ps(scale));
+    z = _mm_mul_ps(z, _mm_set1_ps(scale));
+    
+    __m128i x0 = _mm_cvttps_epi32(_mm_floor_ps(x));
+    __m128i z0 = _mm_cvttps_epi32(_mm_floor_ps(z));
+    __m128i x1 = _mm_add_epi32(x0, _mm_set1_epi32(1));
+    __m128i z1 = _mm_add_epi32(z0, _mm_set1_epi32(1));
+    
+    __m128 sxFade = SmoothFadeSSE41(_mm_sub_ps(x, _mm_cvtepi32_ps(x0)));
+    __m128 szFade = SmoothFadeSSE41(_mm_sub_ps(z, _mm_cvtepi32_ps(z0)));
+    
+    __m128 n00 = LatticeValueSSE41(x0, z0, seedTerm);
+    __m128 n10 = LatticeValueSSE41(x1, z0, seedTerm);
+    __m128 n01 = LatticeValueSSE41(x0, z1, seedTerm);
+    __m128 n11 = LatticeValueSSE41(x1, z1, seedTerm);
+    
+    __m128 nx0 = InterpolateSSE41(n00, n10, sxFade);
+    __m128 nx1 = InterpolateSSE41(n01, n11, sxFade);
+    __m128 nxz = InterpolateSSE41(nx0, nx1, szFade);
+    
+    return _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.0f), nxz), _mm_set1_ps(1.0f));
+}
+
+__attribute__((target("sse4.1")))
+static __m128 RowCoordsSSE41(int firstX) {
+    return _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(firstX), _mm_setr_epi32(0, 1, 2, 3)));
+}
+
+__attribute__((target("sse4.1")))
+static void NoiseRowSSE41(float* out, int count, int startX, int z, float coordScale, float scale, unsigned int seed) {
+    __m128 pz = _mm_set1_ps((float)z * coordScale);
+    __m128i seedTerm = _mm_set1_epi32(NoiseSeedTerm(seed));
+    int i = 0;
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_mul_ps(RowCoordsSSE41(startX + i), _mm_set1_ps(coordScale));
+        _mm_storeu_ps(&out[i], Noise2DSSE41(px, pz, scale, seedTerm));
+    }
+    
+    NoiseRowScalar(&out[i], count - i, startX + i, z, coordScale, scale, seed);
+}
+
+__attribute__((target("sse4.1")))
+static void HeightRowSSE41(float* heights, int count, int startX, int z, unsigned int seed) {
+    __m128 pz = _mm_set1_ps((float)z);
+    __m128i seedTerm = _mm_set1_epi32(NoiseSeedTerm(seed));
+    int i = 0;
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = RowCoordsSSE41(startX + i);
+        __m128 noise = Noise2DSSE41(px, pz, OCTAVE_SCALE_1, seedTerm);
+        noise = _mm_add_ps(noise, _mm_mul_ps(_mm_set1_ps(0.5f), Noise2DSSE41(px, pz, OCTAVE_SCALE_2, seedTerm)));
+        noise = _mm_add_ps(noise, _mm_mul_ps(_mm_set1_ps(0.25f), Noise2DSSE41(px, pz, OCTAVE_SCALE_3, seedTerm)));
+        noise = _mm_mul_ps(_mm_add_ps(noise, _mm_set1_ps(1.0f)), _mm_set1_ps(0.5f));
+        
+        __m128 height = _mm_add_ps(_mm_mul_ps(noise, _mm_set1_ps((float)TERRAIN_HEIGHT_SCALE)),
+                                   _mm_set1_ps((float)TERRAIN_HEIGHT_OFFSET));
+        _mm_storeu_ps(&heights[i], height);
+    }
+    
+    HeightRowScalar(&heights[i], count - i, startX + i, z, seed);
+}
+
+#endif // NOISE_X86_KERNELS
+
+// Kernel selected for this CPU (chosen on first use)
+typedef struct {
+    const char* name;
+    NoiseRowFunction noiseRow;
+    HeightRowFunction heightRow;
+} NoiseKernel;
+
+static const NoiseKernel SCALAR_KERNEL = { "scalar", NoiseRowScalar, HeightRowScalar };
+#ifdef NOISE_X86_KERNELS
+static const NoiseKernel AVX2_KERNEL = { "avx2", NoiseRowAVX2, HeightRowAVX2 };
+static const NoiseKernel SSE41_KERNEL = { "sse4.1", NoiseRowSSE41, HeightRowSSE41 };
+#endif
+
+static const NoiseKernel* GetNoiseKernel(void) {
+    static const NoiseKernel* selected = NULL;
+    const NoiseKernel* kernel = __atomic_load_n(&selected, __ATOMIC_ACQUIRE);
+    if (kernel) return kernel;
+    
+    kernel = &SCALAR_KERNEL;
+#ifdef NOISE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernel = &AVX2_KERNEL;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        kernel = &SSE41_KERNEL;
+    }
+#endif
+    
+    __atomic_store_n(&selected, kernel, __ATOMIC_RELEASE);
+    return kernel;
+}
+
+void GenerateNoise2DRow(float* out, int count, int startX, int z, float coordScale, float scale, unsigned int seed) {
+    GetNoiseKernel()->noiseRow(out, count, startX, z, coordScale, scale, seed);
+}
+
+void GenerateHeightRow(float* heights, int count, int startX, int z, unsigned int seed) {
+    GetNoiseKernel()->heightRow(heights, count, startX, z, seed);
+}
+
+const char* GetNoiseKernelName(void) {
+    return GetNoiseKernel()->name;
+}
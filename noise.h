@@ -0,0 +1,32 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+// Contribution of the world seed to every lattice hash. Seed 0 adds nothing,
+// so the default seed reproduces the original unseeded terrain. The mask only
+// keeps the product in int range for the conversion.
+static inline int NoiseSeedTerm(unsigned int seed) {
+    return (int)((seed * 83492791u) & 0x7fffffffu);
+}
+
+// Pseudo-random hash used at the noise lattice points
+static inline int NoiseHash(int x, int z, unsigned int seed) {
+    // Multiply as unsigned so the wrap-around is well defined
+    int hash = (int)((unsigned int)x * 73856093u ^ (unsigned int)z * 19349663u ^ (unsigned int)NoiseSeedTerm(seed));
+    hash = hash % 100000;
+    return hash;
+}
+
+// Batch noise: fill out[i] with GenerateNoise2DSeeded(px, pz, scale, seed) where
+// px = (float)(startX + i) * coordScale and pz = (float)z * coordScale.
+// Results are bit-identical to the scalar function. Uses AVX2 or SSE4.1
+// kernels when the CPU supports them and falls back to scalar code otherwise.
+void GenerateNoise2DRow(float* out, int count, int startX, int z, float coordScale, float scale, unsigned int seed);
+
+// Fill heights[i] with the terrain height of column (startX + i, z) for the
+// given world seed: three octaves of noise combined
+void GenerateHeightRow(float* heights, int count, int startX, int z, unsigned int seed);
+
+// Name of the kernel selected for this CPU ("avx2", "sse4.1" or "scalar")
+const char* GetNoiseKernelName(void);
+
+#endif // NOISE_H
@@ -1,63 +1,66 @@
 #include "player.h"
+#include "profiler.h"
 #include <stdlib.h>
 #include <math.h>
 
-// Create and initialize a new player
-Player* CreatePlayer(World* world) {
+// Create and initialize a new player with a body in the entity store
+Player* CreatePlayer(World* world, EntityStore* entities) {
+    if (!entities) return NULL;
+    
     Player* player = (Player*)malloc(sizeof(Player));
     
     if (player) {
-        // Initialize player position above the center of the world
-        player->position = (Vector3){ 
+        // Place the player's body on the surface at the center of the world,
+        // or high up if the column there is empty
+        Vector3 position = { 
             WORLD_SIZE_X / 2.0f,  // Center X 
             WORLD_SIZE_Y * 0.75f, // High up in the world
             WORLD_SIZE_Z / 2.0f   // Center Z
         };
+        int surface = GetSolidHeight(world, WORLD_SIZE_X / 2, WORLD_SIZE_Z / 2);
+        int jello = GetJelloHeight(world, WORLD_SIZE_X / 2, WORLD_SIZE_Z / 2);
+        if (jello > surface) surface = jello;
+        if (surface >= 0) position.y = (float)(surface + 1);
+        Vector3 size = { PLAYER_WIDTH, PLAYER_HEIGHT, PLAYER_DEPTH };
         
-        // Initialize player velocity
-        player->velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
-        
-        // Set player size for collision detection
-        player->size = (Vector3){ PLAYER_WIDTH, PLAYER_HEIGHT, PLAYER_DEPTH };
+        player->entities = entities;
+        player->entity = CreateEntity(entities, position, size);
+        if (player->entity < 0) {
+            free(player);
+            return NULL;
+        }
         
         // Initialize rotation (looking forward along Z-axis)
         player->rotationAngle = 0.0f;
         player->pitchAngle = 0.0f;
-        
-        // Initialize state
-        player->isOnGround = false;
-        player->isJumping = false;
-        player->isInWater = false;
-        player->isFullyUnderwater = false;
     }
     
     return player;
 }
 
-// Free player memory
+// Free player memory and remove its body from the store
 void DestroyPlayer(Player* player) {
     if (player) {
+        RemoveEntity(player->entities, player->entity);
         free(player);
     }
 }
 
-// Update player state (called once per frame)
-void UpdatePlayer(Player* player, World* world) {
-    // First handle user input
-    HandlePlayerInput(player);
+// Read the mouse and keyboard (called once per frame). The input steers the
+// player's body on the entity ticks that follow (see UpdateEntities).
+void UpdatePlayer(Player* player) {
+    if (!player) return;
     
-    // Then update physics
-    UpdatePlayerPhysics(player, world);
+    PROFILE_BEGIN("UpdatePlayer");
+    HandlePlayerLook(player);
+    HandlePlayerInput(player);
+    PROFILE_END();
 }
 
-// Handle keyboard and mouse input for player controls
-void HandlePlayerInput(Player* player) {
+// Turn the view with the mouse
+void HandlePlayerLook(Player* player) {
     if (!player) return;
     
-    // Reset lateral velocity
-    player->velocity.x = 0;
-    player->velocity.z = 0;
-    
     // Get mouse movement for camera rotation (yaw and pitch)
     Vector2 mouseDelta = GetMouseDelta();
     
@@ -68,6 +71,11 @@ void HandlePlayerInput(Player* player) {
     // Clamp pitch to prevent camera flipping
     if (player->pitchAngle > 1.5f) player->pitchAngle = 1.5f;
     if (player->pitchAngle < -1.5f) player->pitchAngle = -1.5f;
+}
+
+// Turn keyboard state into input for the player's body
+void HandlePlayerInput(Player* player) {
+    if (!player) return;
     
     // Calculate forward and right vectors based on player rotation
     Vector3 forward = { 
@@ -82,214 +90,64 @@ void HandlePlayerInput(Player* player) {
         cosf(player->rotationAngle + PI/2) 
     };
     
-    // Calculate the movement speed (reduced in water)
-    float moveSpeed = player->isInWater ? PLAYER_MOVE_SPEED * WATER_MOVEMENT_FACTOR : PLAYER_MOVE_SPEED;
+    // Requested horizontal velocity (the physics step slows it in water)
+    float moveX = 0.0f;
+    float moveZ = 0.0f;
     
     // Move forward/backward (W/S keys)
     if (IsKeyDown(KEY_W)) {
-        player->velocity.x += forward.x * moveSpeed;
-        player->velocity.z += forward.z * moveSpeed;
+        moveX += forward.x * PLAYER_MOVE_SPEED;
+        moveZ += forward.z * PLAYER_MOVE_SPEED;
     }
     if (IsKeyDown(KEY_S)) {
-        player->velocity.x -= forward.x * moveSpeed;
-        player->velocity.z -= forward.z * moveSpeed;
+        moveX -= forward.x * PLAYER_MOVE_SPEED;
+        moveZ -= forward.z * PLAYER_MOVE_SPEED;
     }
     
     // Strafe left/right (A/D keys)
     if (IsKeyDown(KEY_A)) {
-        player->velocity.x += right.x * moveSpeed;
-        player->velocity.z += right.z * moveSpeed;
+        moveX += right.x * PLAYER_MOVE_SPEED;
+        moveZ += right.z * PLAYER_MOVE_SPEED;
     }
     if (IsKeyDown(KEY_D)) {
-        player->velocity.x -= right.x * moveSpeed;
-        player->velocity.z -= right.z * moveSpeed;
+        moveX -= right.x * PLAYER_MOVE_SPEED;
+        moveZ -= right.z * PLAYER_MOVE_SPEED;
     }
     
-    // Jump (Space key) or swim up
-    if (IsKeyDown(KEY_SPACE)) {
-        if (player->isInWater) {
-            // Swim up when in water
-            player->velocity.y += PLAYER_SWIM_SPEED;
-        } else if (player->isOnGround) {
-            // Jump when on ground
-            player->velocity.y = PLAYER_JUMP_FORCE;
-            player->isJumping = true;
-            player->isOnGround = false;
-        }
-    }
+    // Jump or swim up (Space key), swim down (Left Control key)
+    uint8_t input = 0;
+    if (IsKeyDown(KEY_SPACE)) input |= ENTITY_INPUT_JUMP;
+    if (IsKeyDown(KEY_LEFT_CONTROL)) input |= ENTITY_INPUT_SINK;
     
-    // Swim down (Left Control key)
-    if (IsKeyDown(KEY_LEFT_CONTROL) && player->isInWater) {
-        player->velocity.y -= PLAYER_SWIM_SPEED;
-    }
+    SetEntityInput(player->entities, player->entity, moveX, moveZ, input);
 }
 
-// Update player physics including gravity and collision
-void UpdatePlayerPhysics(Player* player, World* world) {
-    if (!player || !world) return;
-    
-    // Store old position for collision resolution
-    Vector3 oldPosition = player->position;
-    
-    // Check if player is in water
-    int playerX = (int)player->position.x;
-    int playerY = (int)player->position.y;
-    int playerZ = (int)player->position.z;
-    int headY = (int)(player->position.y + player->size.y * 0.9f); // Check at head level
-    
-    // Get block at player's position
-    BlockType blockAtPlayer = GetBlock(world, playerX, playerY, playerZ);
-    BlockType blockAtHead = GetBlock(world, playerX, headY, playerZ);
-    
-    // Update water state
-    bool wasInWater = player->isInWater;
-    bool wasFullyUnderwater = player->isFullyUnderwater;
-    
-    // Check current state
-    player->isInWater = (blockAtPlayer == BLOCK_JELLO || blockAtHead == BLOCK_JELLO);
-    player->isFullyUnderwater = (blockAtHead == BLOCK_JELLO);
-    
-    // Apply appropriate physics based on environment
-    if (player->isInWater) {
-        float buoyancyForce = PLAYER_BUOYANCY;
-        float gravityFactor;
-        
-        // Apply different physics based on whether player is fully underwater or at surface
-        if (player->isFullyUnderwater) {
-            // Fully underwater - minimal gravity for more "flying-like" controls
-            gravityFactor = UNDERWATER_GRAVITY_FACTOR;
-            
-            // Basic buoyancy when fully underwater
-            if (!player->isOnGround) {
-                player->velocity.y += buoyancyForce;
-            }
-        } else {
-            // At surface - stronger buoyancy to push player up and keep them there
-            gravityFactor = SURFACE_GRAVITY_FACTOR;
-            
-            // Apply stronger buoyancy near the surface to create floating effect
-            if (!player->isOnGround) {
-                player->velocity.y += buoyancyForce * SURFACE_BUOYANCY_FACTOR;
-            }
-        }
-        
-        // Apply appropriate gravity based on water state
-        player->velocity.y -= PLAYER_GRAVITY * gravityFactor;
-        
-        // Implement smooth transitions between underwater and surface states
-        // This creates a more natural feeling when entering/exiting water
-        if ((wasInWater != player->isInWater) || (wasFullyUnderwater != player->isFullyUnderwater)) {
-            // Dampen velocity for smoother transition
-            player->velocity.y *= 0.7f;
-        }
-        
-        // Cap vertical velocity in water for smooth swimming
-        // Higher limit when actively swimming, lower limit for passive floating
-        float maxSpeed = IsKeyDown(KEY_SPACE) || IsKeyDown(KEY_LEFT_CONTROL) ? 
-                         WATER_MAX_VERTICAL_SPEED : WATER_MAX_VERTICAL_SPEED * 0.5f;
-                         
-        if (player->velocity.y > maxSpeed) player->velocity.y = maxSpeed;
-        if (player->velocity.y < -maxSpeed) player->velocity.y = -maxSpeed;
-    } else {
-        // Apply normal gravity if not in water and not on ground
-        if (!player->isOnGround) {
-            player->velocity.y -= PLAYER_GRAVITY;
-        }
-        
-        // If just exited water, apply a small upward boost for smoother transition
-        if (wasInWater && !player->isInWater) {
-            player->velocity.y += PLAYER_BUOYANCY * 0.5f;
-        }
-    }
-    
-    // Update position based on velocity
-    player->position.x += player->velocity.x;
-    player->position.y += player->velocity.y;
-    player->position.z += player->velocity.z;
-    
-    // Get player bounding box at new position
-    BoundingBox playerBox = GetPlayerBoundingBox(player);
-    
-    // Check collision with world
-    if (CheckCollision(world, playerBox)) {
-        // Collision occurred, resolve it
-        
-        // Try to resolve X axis collision first
-        player->position.x = oldPosition.x;
-        playerBox = GetPlayerBoundingBox(player);
-        
-        // If still colliding, try Z axis
-        if (CheckCollision(world, playerBox)) {
-            player->position.z = oldPosition.z;
-            playerBox = GetPlayerBoundingBox(player);
-            
-            // If still colliding, must be Y axis
-            if (CheckCollision(world, playerBox)) {
-                player->position.y = oldPosition.y;
-                
-                // If we were moving down, we've hit the ground
-                if (player->velocity.y < 0) {
-                    player->isOnGround = true;
-                }
-                
-                // Stop vertical movement
-                player->velocity.y = 0;
-            }
-        }
-    } else {
-        // No collision, check if we're still on ground
-        
-        // Create a "feet sensor" box slightly below the player
-        Vector3 feetPosition = player->position;
-        feetPosition.y -= 0.1f;  // Small distance below player
-        
-        // Create a small box for the feet
-        BoundingBox feetBox = {
-            (Vector3){ feetPosition.x - player->size.x/2, feetPosition.y, feetPosition.z - player->size.z/2 },
-            (Vector3){ feetPosition.x + player->size.x/2, feetPosition.y + 0.1f, feetPosition.z + player->size.z/2 }
-        };
-        
-        // Check if feet are touching ground
-        player->isOnGround = CheckCollision(world, feetBox);
-    }
-    
-    // Ensure player doesn't fall through the bottom of the world
-    if (player->position.y < 0) {
-        player->position.y = 0;
-        player->velocity.y = 0;
-        player->isOnGround = true;
-    }
+// Get the player's position (bottom centre of the body)
+Vector3 GetPlayerPosition(Player* player) {
+    return GetEntityPosition(player->entities, player->entity);
 }
 
 // Get the bounding box for the player at their current position
 BoundingBox GetPlayerBoundingBox(Player* player) {
-    BoundingBox box;
-    
-    // Player box is centered on X and Z, but bottom-aligned on Y
-    box.min = (Vector3){ 
-        player->position.x - player->size.x/2,  // Left
-        player->position.y,                     // Bottom
-        player->position.z - player->size.z/2   // Back
-    };
-    
-    box.max = (Vector3){ 
-        player->position.x + player->size.x/2,  // Right
-        player->position.y + player->size.y,    // Top
-        player->position.z + player->size.z/2   // Front
-    };
-    
-    return box;
+    return GetEntityBoundingBox(player->entities, player->entity);
+}
+
+// Position to draw the player at, interpolated between physics ticks
+Vector3 GetPlayerRenderPosition(Player* player) {
+    return GetEntityRenderPosition(player->entities, player->entity);
 }
 
 // Update camera position and orientation based on player
 void UpdateCameraFromPlayer(Camera* camera, Player* player) {
     if (!camera || !player) return;
     
-    // Set camera position to player's head position (offset a bit from player position)
+    // Set camera position to player's head position (offset a bit from player position),
+    // interpolated so motion stays smooth between physics ticks
+    Vector3 position = GetPlayerRenderPosition(player);
     camera->position = (Vector3){ 
-        player->position.x,
-        player->position.y + player->size.y * 0.9f, // Place at eye level (90% of height)
-        player->position.z 
+        position.x,
+        position.y + GetEntitySize(player->entities, player->entity).y * 0.9f, // Place at eye level (90% of height)
+        position.z 
     };
     
     // Calculate the look direction based on player rotation and pitch
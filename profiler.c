@@ -0,0 +1,290 @@
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Events recorded by one thread. The owning thread is the only writer of
+// writePos and the draining thread the only writer of readPos, so the ring
+// needs no locks; the positions sit on separate cache lines.
+typedef struct {
+    ProfileEvent ring[PROFILER_RING_SIZE];
+    char padding0[64];
+    size_t writePos;      // Next slot the owner writes (atomic)
+    char padding1[64];
+    size_t readPos;       // Next slot the drain reads (atomic)
+    char padding2[64];
+    
+    // Zones begun but not yet ended (owner only)
+    const char* openNames[PROFILER_MAX_DEPTH];
+    uint64_t openStarts[PROFILER_MAX_DEPTH];
+    int depth;            // Open zones, including any deeper than PROFILER_MAX_DEPTH
+    
+    int index;            // Position in the profiler's thread list
+    long dropped;         // Zones lost because the ring was full (atomic, written by the owner)
+} ProfileThread;
+
+// Running totals of one zone name
+typedef struct {
+    const char* name;
+    uint64_t frameNs;     // Time accumulated in the current frame
+    int frameCalls;       // Zones accumulated in the current frame
+    double lastMs;        // Time in the last finished frame
+    double averageMs;     // Moving average of lastMs
+    int lastCalls;        // Zones in the last finished frame
+} ProfileZone;
+
+// Weight of the newest frame in the moving averages
+#define PROFILER_AVERAGE_WEIGHT 0.05
+
+static struct {
+    bool running;         // Between InitProfiler and ShutdownProfiler
+    unsigned int generation; // Changes on every init, so threads re-register
+    uint64_t origin;      // Clock reading at InitProfiler
+    uint64_t frameStart;  // Clock reading at the last ProfileFrame
+    
+    ProfileThread* threads[PROFILER_MAX_THREADS]; // Published by the threads themselves (atomic)
+    int threadCount;      // Thread slots claimed (atomic; may exceed the limit)
+    
+    ProfileZone zones[PROFILER_MAX_ZONES];
+    int zoneCount;
+    
+    ProfileEvent* trace;  // Every drained zone, in drain order
+    int traceCount;
+    long dropped;         // Zones lost because the trace was full
+} profiler;
+
+// This thread's ring (NULL when every slot is taken) and the profiler
+// generation it belongs to
+static __thread ProfileThread* currentThread;
+static __thread unsigned int currentGeneration;
+
+// Monotonic clock in nanoseconds
+static uint64_t GetProfileClock(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+// Get the calling thread's ring, claiming a slot on first use
+static ProfileThread* GetProfileThread(void) {
+    unsigned int generation = __atomic_load_n(&profiler.generation, __ATOMIC_ACQUIRE);
+    if (currentGeneration == generation) return currentThread;
+    
+    currentGeneration = generation;
+    currentThread = NULL;
+    
+    int index = __atomic_fetch_add(&profiler.threadCount, 1, __ATOMIC_RELAXED);
+    if (index >= PROFILER_MAX_THREADS) return NULL;
+    
+    ProfileThread* thread = (ProfileThread*)calloc(1, sizeof(ProfileThread));
+    if (!thread) return NULL;
+    
+    thread->index = index;
+    __atomic_store_n(&profiler.threads[index], thread, __ATOMIC_RELEASE);
+    currentThread = thread;
+    
+    return thread;
+}
+
+// Start recording. Returns false if the profiler is already running or
+// memory runs out.
+bool InitProfiler(void) {
+    if (profiler.running) return false;
+    
+    ProfileEvent* trace = (ProfileEvent*)malloc(PROFILER_MAX_TRACE_EVENTS * sizeof(ProfileEvent));
+    if (!trace) return false;
+    
+    unsigned int generation = profiler.generation + 1;
+    memset(&profiler, 0, sizeof(profiler));
+    profiler.trace = trace;
+    profiler.origin = GetProfileClock();
+    profiler.frameStart = profiler.origin;
+    __atomic_store_n(&profiler.generation, generation, __ATOMIC_RELEASE);
+    profiler.running = true;
+    
+    return true;
+}
+
+// Find the totals of a zone name, adding them if there is room
+static ProfileZone* GetProfileZone(const char* name) {
+    for (int i = 0; i < profiler.zoneCount; i++) {
+        if (profiler.zones[i].name == name || strcmp(profiler.zones[i].name, name) == 0) {
+            return &profiler.zones[i];
+        }
+    }
+    
+    if (profiler.zoneCount == PROFILER_MAX_ZONES) return NULL;
+    
+    ProfileZone* zone = &profiler.zones[profiler.zoneCount++];
+    memset(zone, 0, sizeof(ProfileZone));
+    zone->name = name;
+    return zone;
+}
+
+// Add a finished zone to the frame totals and the trace
+static void AddProfileEvent(const ProfileEvent* event) {
+    ProfileZone* zone = GetProfileZone(event->name);
+    if (zone) {
+        zone->frameNs += event->end - event->start;
+        zone->frameCalls++;
+    }
+    
+    if (profiler.traceCount < PROFILER_MAX_TRACE_EVENTS) {
+        profiler.trace[profiler.traceCount++] = *event;
+    } else {
+        profiler.dropped++;
+    }
+}
+
+// Move every thread's finished zones out of its ring
+static void DrainProfileThreads(void) {
+    int threadCount = __atomic_load_n(&profiler.threadCount, __ATOMIC_ACQUIRE);
+    if (threadCount > PROFILER_MAX_THREADS) threadCount = PROFILER_MAX_THREADS;
+    
+    for (int i = 0; i < threadCount; i++) {
+        ProfileThread* thread = __atomic_load_n(&profiler.threads[i], __ATOMIC_ACQUIRE);
+        if (!thread) continue; // Slot claimed but not published yet
+        
+        size_t read = thread->readPos;
+        size_t write = __atomic_load_n(&thread->writePos, __ATOMIC_ACQUIRE);
+        for (; read != write; read++) {
+            AddProfileEvent(&thread->ring[read & (PROFILER_RING_SIZE - 1)]);
+        }
+        __atomic_store_n(&thread->readPos, read, __ATOMIC_RELEASE);
+    }
+}
+
+// Stop recording, write the trace to tracePath (unless it is NULL) and free
+// everything. Threads must have stopped recording first.
+void ShutdownProfiler(const char* tracePath) {
+    if (!profiler.running) return;
+    
+    DrainProfileThreads();
+    if (tracePath) WriteProfileTrace(tracePath);
+    
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        free(profiler.threads[i]);
+        profiler.threads[i] = NULL;
+    }
+    free(profiler.trace);
+    profiler.trace = NULL;
+    profiler.traceCount = 0;
+    profiler.running = false;
+}
+
+// Open a zone on the calling thread (name must outlive the profiler; use a
+// string literal)
+void ProfileBegin(const char* name) {
+    if (!profiler.running) return;
+    
+    ProfileThread* thread = GetProfileThread();
+    if (!thread) return;
+    
+    if (thread->depth < PROFILER_MAX_DEPTH) {
+        thread->openNames[thread->depth] = name;
+        thread->openStarts[thread->depth] = GetProfileClock();
+    }
+    thread->depth++;
+}
+
+// Close the zone opened last on the calling thread
+void ProfileEnd(void) {
+    if (!profiler.running) return;
+    
+    ProfileThread* thread = GetProfileThread();
+    if (!thread || thread->depth == 0) return;
+    
+    int depth = --thread->depth;
+    if (depth >= PROFILER_MAX_DEPTH) return;
+    
+    size_t write = thread->writePos;
+    if (write - __atomic_load_n(&thread->readPos, __ATOMIC_ACQUIRE) == PROFILER_RING_SIZE) {
+        __atomic_add_fetch(&thread->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    
+    uint64_t end = GetProfileClock();
+    thread->ring[write & (PROFILER_RING_SIZE - 1)] = (ProfileEvent){
+        thread->openNames[depth],
+        thread->openStarts[depth] - profiler.origin,
+        end - profiler.origin,
+        thread->index,
+        depth
+    };
+    __atomic_store_n(&thread->writePos, write + 1, __ATOMIC_RELEASE);
+}
+
+// Mark the end of a frame (call once per frame from the main thread): the
+// frame itself is recorded as the zone "Frame", every ring is drained and
+// the per-zone totals move on to the next frame
+void ProfileFrame(void) {
+    if (!profiler.running) return;
+    
+    uint64_t now = GetProfileClock();
+    ProfileThread* thread = GetProfileThread();
+    ProfileEvent frame = {
+        "Frame", profiler.frameStart - profiler.origin, now - profiler.origin, thread ? thread->index : 0, 0
+    };
+    profiler.frameStart = now;
+    
+    DrainProfileThreads();
+    AddProfileEvent(&frame);
+    
+    for (int i = 0; i < profiler.zoneCount; i++) {
+        ProfileZone* zone = &profiler.zones[i];
+        zone->lastMs = (double)zone->frameNs / 1e6;
+        zone->lastCalls = zone->frameCalls;
+        zone->averageMs += (zone->lastMs - zone->averageMs) * PROFILER_AVERAGE_WEIGHT;
+        zone->frameNs = 0;
+        zone->frameCalls = 0;
+    }
+}
+
+// Copy the totals of the last finished frame, in order of first appearance.
+// Returns the number of zones written.
+int GetProfileZoneStats(ProfileZoneStats* stats, int maxStats) {
+    if (!stats) return 0;
+    
+    int count = (profiler.zoneCount < maxStats) ? profiler.zoneCount : maxStats;
+    for (int i = 0; i < count; i++) {
+        const ProfileZone* zone = &profiler.zones[i];
+        stats[i] = (ProfileZoneStats){ zone->name, zone->lastMs, zone->averageMs, zone->lastCalls };
+    }
+    
+    return count;
+}
+
+// Number of zones lost to full rings or a full trace (the zones of threads
+// beyond PROFILER_MAX_THREADS are not counted)
+long GetProfileDroppedEvents(void) {
+    long dropped = profiler.dropped;
+    
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        ProfileThread* thread = __atomic_load_n(&profiler.threads[i], __ATOMIC_ACQUIRE);
+        if (thread) dropped += __atomic_load_n(&thread->dropped, __ATOMIC_RELAXED);
+    }
+    
+    return dropped;
+}
+
+// Write the drained zones as a Chrome trace event file (complete events,
+// times in microseconds)
+bool WriteProfileTrace(const char* path) {
+    if (!path || !profiler.trace) return false;
+    
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (int i = 0; i < profiler.traceCount; i++) {
+        const ProfileEvent* event = &profiler.trace[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                event->name, event->thread, (double)event->start / 1e3,
+                (double)(event->end - event->start) / 1e3, (i + 1 < profiler.traceCount) ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    
+    bool success = !ferror(file);
+    return (fclose(file) == 0) && success;
+}
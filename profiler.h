@@ -0,0 +1,66 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Built-in frame profiler. Code is instrumented with PROFILE_BEGIN/PROFILE_END
+// pairs around hot paths; they only record anything when the program is
+// built with -DENABLE_PROFILER (make profile), and otherwise compile to
+// nothing. The functions below are always available, so headless programs
+// can drive the profiler directly.
+//
+// Every thread records its zones into its own ring buffer with no locks
+// (a single-producer, single-consumer queue); the main thread drains them
+// once per frame into per-zone totals for the overlay and into the event
+// list written out as a Chrome trace (chrome://tracing or ui.perfetto.dev).
+
+// Limits
+#define PROFILER_MAX_THREADS 64           // Threads that can record zones
+#define PROFILER_RING_SIZE 4096           // Zones a thread can hold between drains (a power of two)
+#define PROFILER_MAX_DEPTH 32             // Deepest zone nesting per thread
+#define PROFILER_MAX_ZONES 64             // Distinct zone names tracked for the overlay
+#define PROFILER_MAX_TRACE_EVENTS (1 << 20) // Zones kept for the trace (later ones are dropped)
+
+// A finished zone
+typedef struct {
+    const char* name;     // Zone name (a string literal)
+    uint64_t start;       // Start in nanoseconds since InitProfiler
+    uint64_t end;         // End in nanoseconds since InitProfiler
+    int thread;           // Recording thread, in order of first use
+    int depth;            // Nesting depth within the thread (0 is outermost)
+} ProfileEvent;
+
+// Time spent in one zone name, summed over every thread
+typedef struct {
+    const char* name;
+    double frameMs;       // Time during the last frame
+    double averageMs;     // Moving average of frameMs
+    int calls;            // Zones finished during the last frame
+} ProfileZoneStats;
+
+// Function prototypes
+bool InitProfiler(void);
+void ShutdownProfiler(const char* tracePath);
+void ProfileBegin(const char* name);
+void ProfileEnd(void);
+void ProfileFrame(void);
+int GetProfileZoneStats(ProfileZoneStats* stats, int maxStats);
+long GetProfileDroppedEvents(void);
+bool WriteProfileTrace(const char* path);
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_INIT() InitProfiler()
+#define PROFILE_SHUTDOWN(tracePath) ShutdownProfiler(tracePath)
+#define PROFILE_BEGIN(name) ProfileBegin(name)
+#define PROFILE_END() ProfileEnd()
+#define PROFILE_FRAME() ProfileFrame()
+#else
+#define PROFILE_INIT() ((void)0)
+#define PROFILE_SHUTDOWN(tracePath) ((void)0)
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
+
+#endif // PROFILER_H
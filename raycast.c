@@ -0,0 +1,212 @@
+#include "raycast.h"
+#include <string.h>
+#include <math.h>
+
+// Number of chunks a raycast remembers (must be a power of two)
+#define RAYCAST_CACHE_SIZE 16
+
+// A chunk looked up by a raycast
+typedef struct {
+    int cx, cy, cz;       // Chunk coordinates
+    bool valid;           // Entry holds a lookup
+    Chunk* chunk;         // NULL for a chunk without blocks
+} CachedChunk;
+
+// Direct-mapped cache of chunk lookups, shared by the rays of a batch
+typedef struct {
+    CachedChunk entries[RAYCAST_CACHE_SIZE];
+} ChunkCache;
+
+// Look up a chunk through the cache
+static Chunk* GetCachedChunk(World* world, ChunkCache* cache, int cx, int cy, int cz) {
+    CachedChunk* entry = &cache->entries[HashChunkCoords(cx, cy, cz) & (RAYCAST_CACHE_SIZE - 1)];
+    
+    if (!entry->valid || entry->cx != cx || entry->cy != cy || entry->cz != cz) {
+        *entry = (CachedChunk){ cx, cy, cz, true, GetChunk(world, cx, cy, cz) };
+    }
+    
+    return entry->chunk;
+}
+
+// Whether a ray can cross a chunk without hitting anything: the chunk has
+// no blocks, or is uniformly jello and the ray ignores jello
+static inline bool IsChunkPassable(const Chunk* chunk, bool ignoreJello) {
+    return !chunk || (ignoreJello && IsChunkUniform(chunk) && IsBlockTransparent((BlockType)chunk->palette[0]));
+}
+
+// Advance a grid walk out of the chunk holding the current block in one go:
+// the axis whose chunk boundary comes first is crossed, and every other axis
+// takes the block steps it would have taken before then. Returns the axis
+// the ray left the chunk through; *t becomes the distance at that point.
+static int SkipChunk(int block[3], const int step[3], float tMax[3], const float tDelta[3], float* t) {
+    // Blocks left to cross on each axis before leaving the chunk, and the
+    // distance at which the last of those crossings happens
+    int stepsOut[3];
+    float tExit[3];
+    int exitAxis = 0;
+    
+    for (int axis = 0; axis < 3; axis++) {
+        int local = block[axis] & CHUNK_MASK;
+        stepsOut[axis] = (step[axis] > 0) ? CHUNK_SIZE - local : local + 1;
+        tExit[axis] = (step[axis] != 0) ? tMax[axis] + (float)(stepsOut[axis] - 1) * tDelta[axis] : INFINITY;
+        if (tExit[axis] < tExit[exitAxis]) exitAxis = axis;
+    }
+    
+    for (int axis = 0; axis < 3; axis++) {
+        int steps;
+        if (axis == exitAxis) {
+            steps = stepsOut[axis];
+        } else if (tMax[axis] >= tExit[exitAxis]) {
+            steps = 0;
+        } else {
+            steps = (int)((tExit[exitAxis] - tMax[axis]) / tDelta[axis]) + 1;
+            if (steps > stepsOut[axis] - 1) steps = stepsOut[axis] - 1;
+        }
+        
+        if (steps > 0) {
+            block[axis] += step[axis] * steps;
+            tMax[axis] += tDelta[axis] * (float)steps;
+        }
+    }
+    
+    *t = tExit[exitAxis];
+    return exitAxis;
+}
+
+// Walk the grid block by block along the ray (Amanatides & Woo) until a
+// block is hit. Chunks without blocks (or uniformly jello when jello is
+// ignored) are crossed in a single jump, and blocks are tested with the
+// column occupancy bits instead of the palette.
+static RaycastHit CastRay(World* world, ChunkCache* cache, Ray ray, float maxDistance, int flags) {
+    RaycastHit result;
+    memset(&result, 0, sizeof(result));
+    
+    float length = sqrtf(ray.direction.x * ray.direction.x +
+                         ray.direction.y * ray.direction.y +
+                         ray.direction.z * ray.direction.z);
+    if (length == 0.0f) return result;
+    
+    float origin[3] = { ray.position.x, ray.position.y, ray.position.z };
+    float direction[3] = { ray.direction.x / length, ray.direction.y / length, ray.direction.z / length };
+    
+    // Current block, step direction, distance to the next boundary on each
+    // axis and distance between boundaries on each axis
+    int block[3], step[3];
+    float tMax[3], tDelta[3];
+    
+    for (int axis = 0; axis < 3; axis++) {
+        block[axis] = (int)floorf(origin[axis]);
+        
+        if (direction[axis] > 0.0f) {
+            step[axis] = 1;
+            tDelta[axis] = 1.0f / direction[axis];
+            tMax[axis] = ((float)(block[axis] + 1) - origin[axis]) * tDelta[axis];
+        } else if (direction[axis] < 0.0f) {
+            step[axis] = -1;
+            tDelta[axis] = -1.0f / direction[axis];
+            tMax[axis] = (origin[axis] - (float)block[axis]) * tDelta[axis];
+        } else {
+            step[axis] = 0;
+            tDelta[axis] = INFINITY;
+            tMax[axis] = INFINITY;
+        }
+    }
+    
+    bool ignoreJello = (flags & RAYCAST_IGNORE_JELLO) != 0;
+    float t = 0.0f;
+    int enteredAxis = -1;
+    
+    // Chunk holding the current block (looked up again only when the ray leaves it)
+    int cx = BlockToChunkCoord(block[0]);
+    int cy = BlockToChunkCoord(block[1]);
+    int cz = BlockToChunkCoord(block[2]);
+    Chunk* chunk = GetCachedChunk(world, cache, cx, cy, cz);
+    bool passable = IsChunkPassable(chunk, ignoreJello);
+    
+    while (t <= maxDistance) {
+        // Nothing can be hit above or below the world once the ray heads away from it
+        if ((block[1] < 0 && step[1] <= 0) || (block[1] >= WORLD_SIZE_Y && step[1] >= 0)) break;
+        
+        if (BlockToChunkCoord(block[0]) != cx || BlockToChunkCoord(block[1]) != cy ||
+            BlockToChunkCoord(block[2]) != cz) {
+            cx = BlockToChunkCoord(block[0]);
+            cy = BlockToChunkCoord(block[1]);
+            cz = BlockToChunkCoord(block[2]);
+            chunk = GetCachedChunk(world, cache, cx, cy, cz);
+            passable = IsChunkPassable(chunk, ignoreJello);
+        }
+        
+        if (passable) {
+            // Nothing in the chunk can stop the ray: jump straight to where it leaves
+            enteredAxis = SkipChunk(block, step, tMax, tDelta, &t);
+            continue;
+        }
+        
+        int lx = block[0] & CHUNK_MASK;
+        int ly = block[1] & CHUNK_MASK;
+        int lz = block[2] & CHUNK_MASK;
+        int column = CHUNK_COLUMN_INDEX(lx, lz);
+        uint16_t occupied = ignoreJello ? chunk->opaqueColumns[column] : chunk->filledColumns[column];
+        
+        if ((occupied >> ly) & 1) {
+            result.hit = true;
+            result.x = block[0];
+            result.y = block[1];
+            result.z = block[2];
+            result.distance = t;
+            result.block = GetChunkBlock(chunk, lx, ly, lz);
+            
+            if (enteredAxis >= 0) {
+                int normal[3] = { 0, 0, 0 };
+                normal[enteredAxis] = -step[enteredAxis];
+                result.normalX = normal[0];
+                result.normalY = normal[1];
+                result.normalZ = normal[2];
+            }
+            
+            return result;
+        }
+        
+        // Step to the next block
+        int axis = (tMax[0] < tMax[1]) ? ((tMax[0] < tMax[2]) ? 0 : 2) : ((tMax[1] < tMax[2]) ? 1 : 2);
+        t = tMax[axis];
+        block[axis] += step[axis];
+        tMax[axis] += tDelta[axis];
+        enteredAxis = axis;
+    }
+    
+    return result;
+}
+
+// Find the first block along a ray within maxDistance (the direction need
+// not be normalized). With RAYCAST_IGNORE_JELLO the ray passes through jello.
+RaycastHit RaycastWorld(World* world, Ray ray, float maxDistance, int flags) {
+    if (!world) {
+        RaycastHit miss;
+        memset(&miss, 0, sizeof(miss));
+        return miss;
+    }
+    
+    ChunkCache cache;
+    memset(&cache, 0, sizeof(cache));
+    
+    return CastRay(world, &cache, ray, maxDistance, flags);
+}
+
+// Cast many rays in one call (line of sight checks, explosion occlusion,
+// picking). The rays share one chunk cache, so bundles of rays through the
+// same area skip most chunk lookups.
+void RaycastWorldBatch(World* world, const Ray* rays, int count, float maxDistance, int flags, RaycastHit* hits) {
+    if (!rays || !hits) return;
+    
+    ChunkCache cache;
+    memset(&cache, 0, sizeof(cache));
+    
+    for (int i = 0; i < count; i++) {
+        if (world) {
+            hits[i] = CastRay(world, &cache, rays[i], maxDistance, flags);
+        } else {
+            memset(&hits[i], 0, sizeof(RaycastHit));
+        }
+    }
+}
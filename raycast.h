@@ -0,0 +1,23 @@
+#ifndef RAYCAST_H
+#define RAYCAST_H
+
+#include "raylib.h"
+#include "voxel.h"
+
+// Raycast flags
+#define RAYCAST_IGNORE_JELLO 1    // Rays pass through jello as if it were air
+
+// Result of casting a ray into the world
+typedef struct {
+    bool hit;             // A block was reached within the maximum distance
+    int x, y, z;          // Block that was hit
+    int normalX, normalY, normalZ; // Outward normal of the face the ray entered (zero if it started inside the block)
+    float distance;       // Distance along the ray to the point where it entered the block
+    BlockType block;      // Type of the block that was hit
+} RaycastHit;
+
+// Function prototypes
+RaycastHit RaycastWorld(World* world, Ray ray, float maxDistance, int flags);
+void RaycastWorldBatch(World* world, const Ray* rays, int count, float maxDistance, int flags, RaycastHit* hits);
+
+#endif // RAYCAST_H
@@ -0,0 +1,739 @@
+#include "region.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// Size of the fixed header and of one offset table entry, in bytes
+#define REGION_HEADER_SIZE 16
+#define REGION_ENTRY_SIZE 8
+
+// Largest encoded chunk: every block in its own run
+#define MAX_CHUNK_RECORD_SIZE (4 + CHUNK_VOLUME * 3)
+
+// World metadata file: "VXWD", uint32 version, uint32 seed
+#define WORLD_INFO_FILE "world.dat"
+#define WORLD_INFO_SIZE 12
+
+// Longest path built for a world file
+#define REGION_PATH_LENGTH 1024
+
+// Location of a chunk record inside a region file
+typedef struct {
+    uint32_t offset;      // Byte offset of the record (0 when never saved)
+    uint32_t size;        // Record size in bytes
+} RegionEntry;
+
+// A region file held in memory for lazy loading
+typedef struct {
+    int rx, rz;           // Region coordinates
+    const uint8_t* data;  // File contents
+    size_t size;          // File size in bytes
+    bool mapped;          // data is a memory mapping rather than a heap copy
+    uint32_t faulted[REGION_SIZE * REGION_SIZE / 32]; // Columns already handed to the world
+} MappedRegion;
+
+// Column source that decodes chunks straight out of mapped region files
+typedef struct {
+    MappedRegion* regions;
+    int count;
+    int capacity;
+    int lastRegion;       // Region that served the previous lookup
+    char directory[REGION_PATH_LENGTH]; // Directory the regions were mapped from
+} RegionSource;
+
+// Serializes region file access between the main thread and the workers
+static pthread_mutex_t regionLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Little-endian integer helpers
+static void WriteU32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t ReadU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Build the path of a file inside the world directory
+static bool GetWorldFilePath(char* path, const char* directory, const char* name) {
+    int length = snprintf(path, REGION_PATH_LENGTH, "%s/%s", directory, name);
+    return length > 0 && length < REGION_PATH_LENGTH;
+}
+
+// Build the path of a region file
+static bool GetRegionPath(char* path, const char* directory, int rx, int rz) {
+    char name[64];
+    snprintf(name, sizeof(name), "r.%d.%d.vxr", rx, rz);
+    return GetWorldFilePath(path, directory, name);
+}
+
+// Index of a column within its region
+static int GetRegionColumnIndex(int cx, int cz) {
+    return (cz & REGION_MASK) * REGION_SIZE + (cx & REGION_MASK);
+}
+
+// Open a region file and check its header; optionally create it with an empty table
+static FILE* OpenRegionFile(const char* directory, int rx, int rz, bool create) {
+    char path[REGION_PATH_LENGTH];
+    if (!GetRegionPath(path, directory, rx, rz)) return NULL;
+    
+    uint8_t header[REGION_HEADER_SIZE];
+    FILE* file = fopen(path, "r+b");
+    
+    if (file) {
+        if (fread(header, 1, REGION_HEADER_SIZE, file) != REGION_HEADER_SIZE ||
+            memcmp(header, "VXRG", 4) != 0 ||
+            ReadU32(&header[4]) != REGION_FORMAT_VERSION ||
+            (int32_t)ReadU32(&header[8]) != rx ||
+            (int32_t)ReadU32(&header[12]) != rz) {
+            fclose(file);
+            return NULL;
+        }
+        return file;
+    }
+    
+    if (!create) return NULL;
+    
+    file = fopen(path, "w+b");
+    if (!file) return NULL;
+    
+    memcpy(header, "VXRG", 4);
+    WriteU32(&header[4], REGION_FORMAT_VERSION);
+    WriteU32(&header[8], (uint32_t)rx);
+    WriteU32(&header[12], (uint32_t)rz);
+    
+    uint8_t* table = (uint8_t*)calloc(REGION_CHUNK_COUNT, REGION_ENTRY_SIZE);
+    bool ok = table &&
+              fwrite(header, 1, REGION_HEADER_SIZE, file) == REGION_HEADER_SIZE &&
+              fwrite(table, REGION_ENTRY_SIZE, REGION_CHUNK_COUNT, file) == REGION_CHUNK_COUNT;
+    free(table);
+    
+    if (!ok) {
+        fclose(file);
+        return NULL;
+    }
+    
+    return file;
+}
+
+// Read or write the table entries of one column
+static bool ReadColumnEntries(FILE* file, int columnIndex, RegionEntry entries[WORLD_CHUNKS_Y]) {
+    uint8_t bytes[WORLD_CHUNKS_Y * REGION_ENTRY_SIZE];
+    long position = REGION_HEADER_SIZE + (long)columnIndex * WORLD_CHUNKS_Y * REGION_ENTRY_SIZE;
+    
+    if (fseek(file, position, SEEK_SET) != 0 || fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) {
+        return false;
+    }
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        entries[cy].offset = ReadU32(&bytes[cy * REGION_ENTRY_SIZE]);
+        entries[cy].size = ReadU32(&bytes[cy * REGION_ENTRY_SIZE + 4]);
+    }
+    
+    return true;
+}
+
+static bool WriteColumnEntries(FILE* file, int columnIndex, const RegionEntry entries[WORLD_CHUNKS_Y]) {
+    uint8_t bytes[WORLD_CHUNKS_Y * REGION_ENTRY_SIZE];
+    long position = REGION_HEADER_SIZE + (long)columnIndex * WORLD_CHUNKS_Y * REGION_ENTRY_SIZE;
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        WriteU32(&bytes[cy * REGION_ENTRY_SIZE], entries[cy].offset);
+        WriteU32(&bytes[cy * REGION_ENTRY_SIZE + 4], entries[cy].size);
+    }
+    
+    return fseek(file, position, SEEK_SET) == 0 && fwrite(bytes, 1, sizeof(bytes), file) == sizeof(bytes);
+}
+
+// Run-length encode a chunk (NULL encodes an empty chunk); returns the record size
+static size_t EncodeChunk(const Chunk* chunk, uint8_t* record) {
+    BlockId blocks[CHUNK_VOLUME];
+    if (chunk) {
+        UnpackChunkBlocks(chunk, blocks);
+    } else {
+        memset(blocks, BLOCK_EMPTY, sizeof(blocks));
+    }
+    
+    uint32_t runCount = 0;
+    uint8_t* out = record + 4;
+    int runLength = 0;
+    BlockId runBlock = 0;
+    
+    // Walk layer by layer: terrain is mostly horizontal, so runs stay long
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                BlockId block = blocks[CHUNK_INDEX(x, y, z)];
+                
+                if (runLength > 0 && block == runBlock && runLength < 0xFFFF) {
+                    runLength++;
+                    continue;
+                }
+                
+                if (runLength > 0) {
+                    out[0] = (uint8_t)runLength;
+                    out[1] = (uint8_t)(runLength >> 8);
+                    out[2] = runBlock;
+                    out += 3;
+                    runCount++;
+                }
+                runBlock = block;
+                runLength = 1;
+            }
+        }
+    }
+    
+    out[0] = (uint8_t)runLength;
+    out[1] = (uint8_t)(runLength >> 8);
+    out[2] = runBlock;
+    out += 3;
+    runCount++;
+    
+    WriteU32(record, runCount);
+    return (size_t)(out - record);
+}
+
+// Decode a chunk record; *chunk is NULL for a chunk without blocks
+static bool DecodeChunk(const uint8_t* record, size_t size, int cx, int cy, int cz, Chunk** chunk) {
+    *chunk = NULL;
+    if (size < 4) return false;
+    
+    uint32_t runCount = ReadU32(record);
+    if (size != 4 + (size_t)runCount * 3) return false;
+    
+    BlockId layers[CHUNK_VOLUME];
+    int filled = 0;
+    const uint8_t* in = record + 4;
+    
+    for (uint32_t run = 0; run < runCount; run++, in += 3) {
+        int runLength = in[0] | (in[1] << 8);
+        BlockId block = in[2];
+        if (block >= BLOCK_TYPE_COUNT || runLength > CHUNK_VOLUME - filled) return false;
+        
+        memset(&layers[filled], block, runLength);
+        filled += runLength;
+    }
+    
+    if (filled != CHUNK_VOLUME) return false;
+    
+    // Undo the layer-by-layer order one z row at a time
+    BlockId blocks[CHUNK_VOLUME];
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            memcpy(&blocks[CHUNK_INDEX(x, y, 0)], &layers[(y << (2 * CHUNK_SHIFT)) | (x << CHUNK_SHIFT)], CHUNK_SIZE);
+        }
+    }
+    
+    *chunk = CreateChunkFromBlocks(cx, cy, cz, blocks);
+    if (!*chunk) {
+        // NULL is only correct for a chunk with nothing in it
+        for (int i = 0; i < CHUNK_VOLUME; i++) {
+            if (blocks[i] != BLOCK_EMPTY) return false;
+        }
+    }
+    
+    return true;
+}
+
+// Read a column with the given table entries from an open region file;
+// returns false if it was never saved or is corrupt
+static bool ReadColumn(FILE* file, int cx, int cz, const RegionEntry entries[WORLD_CHUNKS_Y], Chunk* chunks[WORLD_CHUNKS_Y]) {
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        chunks[cy] = NULL;
+    }
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        if (entries[cy].offset == 0) return false;
+    }
+    
+    uint8_t* record = (uint8_t*)malloc(MAX_CHUNK_RECORD_SIZE);
+    if (!record) return false;
+    
+    bool ok = true;
+    for (int cy = 0; cy < WORLD_CHUNKS_Y && ok; cy++) {
+        ok = entries[cy].size <= MAX_CHUNK_RECORD_SIZE &&
+             fseek(file, (long)entries[cy].offset, SEEK_SET) == 0 &&
+             fread(record, 1, entries[cy].size, file) == entries[cy].size &&
+             DecodeChunk(record, entries[cy].size, cx, cy, cz, &chunks[cy]);
+    }
+    free(record);
+    
+    if (!ok) {
+        for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+            FreeChunk(chunks[cy]);
+            chunks[cy] = NULL;
+        }
+    }
+    
+    return ok;
+}
+
+// Save every chunk of a column into its region file. Records are rewritten in
+// place when they still fit and appended to the file otherwise.
+bool SaveChunkColumn(const char* directory, int cx, int cz, Chunk* const chunks[WORLD_CHUNKS_Y]) {
+    if (!directory) return false;
+    
+    uint8_t* record = (uint8_t*)malloc(MAX_CHUNK_RECORD_SIZE);
+    if (!record) return false;
+    
+    pthread_mutex_lock(&regionLock);
+    
+    int columnIndex = GetRegionColumnIndex(cx, cz);
+    RegionEntry entries[WORLD_CHUNKS_Y];
+    FILE* file = OpenRegionFile(directory, cx >> REGION_SHIFT, cz >> REGION_SHIFT, true);
+    bool ok = file && ReadColumnEntries(file, columnIndex, entries);
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y && ok; cy++) {
+        size_t size = EncodeChunk(chunks[cy], record);
+        
+        if (entries[cy].offset == 0 || entries[cy].size < size) {
+            ok = fseek(file, 0, SEEK_END) == 0;
+            long end = ok ? ftell(file) : -1;
+            ok = end > 0;
+            entries[cy].offset = (uint32_t)end;
+        } else {
+            ok = fseek(file, (long)entries[cy].offset, SEEK_SET) == 0;
+        }
+        entries[cy].size = (uint32_t)size;
+        
+        ok = ok && fwrite(record, 1, size, file) == size;
+    }
+    
+    // The table is updated last so a failed write never points at partial data
+    ok = ok && WriteColumnEntries(file, columnIndex, entries);
+    if (file && fclose(file) != 0) ok = false;
+    
+    pthread_mutex_unlock(&regionLock);
+    free(record);
+    
+    return ok;
+}
+
+// Load a column saved with SaveChunkColumn; returns false if it is not on disk
+bool LoadChunkColumn(const char* directory, int cx, int cz, Chunk* chunks[WORLD_CHUNKS_Y]) {
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        chunks[cy] = NULL;
+    }
+    if (!directory) return false;
+    
+    pthread_mutex_lock(&regionLock);
+    
+    bool ok = false;
+    RegionEntry entries[WORLD_CHUNKS_Y];
+    FILE* file = OpenRegionFile(directory, cx >> REGION_SHIFT, cz >> REGION_SHIFT, false);
+    if (file) {
+        ok = ReadColumnEntries(file, GetRegionColumnIndex(cx, cz), entries) &&
+             ReadColumn(file, cx, cz, entries, chunks);
+        fclose(file);
+    }
+    
+    pthread_mutex_unlock(&regionLock);
+    
+    return ok;
+}
+
+// Order columns so that columns of the same region are saved together
+static int CompareColumnCoords(const void* a, const void* b) {
+    const ChunkCoord* ca = (const ChunkCoord*)a;
+    const ChunkCoord* cb = (const ChunkCoord*)b;
+    
+    int ra = ca->cz >> REGION_SHIFT, rb = cb->cz >> REGION_SHIFT;
+    if (ra != rb) return (ra > rb) - (ra < rb);
+    ra = ca->cx >> REGION_SHIFT;
+    rb = cb->cx >> REGION_SHIFT;
+    if (ra != rb) return (ra > rb) - (ra < rb);
+    if (ca->cz != cb->cz) return (ca->cz > cb->cz) - (ca->cz < cb->cz);
+    return (ca->cx > cb->cx) - (ca->cx < cb->cx);
+}
+
+static bool LoadMappedColumn(void* context, int cx, int cz, Chunk* chunks[WORLD_CHUNKS_Y]);
+
+// Bring every saved column of a lazily opened world that was never reached
+// into the world, so that it is saved along with the rest. Not needed when
+// saving back into the directory the world was opened from, where those
+// columns' records already are.
+static void LoadUnreachedColumns(World* world, const char* directory) {
+    if (world->columnSource.loadColumn != LoadMappedColumn) return;
+    
+    RegionSource* source = (RegionSource*)world->columnSource.context;
+    if (strcmp(source->directory, directory) == 0) return;
+    
+    for (int i = 0; i < source->count; i++) {
+        const MappedRegion* region = &source->regions[i];
+        
+        for (int columnIndex = 0; columnIndex < REGION_SIZE * REGION_SIZE; columnIndex++) {
+            if (region->faulted[columnIndex >> 5] & (1u << (columnIndex & 31))) continue;
+            
+            // Offset 0 means the column was never saved
+            const uint8_t* entry = region->data + REGION_HEADER_SIZE + (size_t)columnIndex * WORLD_CHUNKS_Y * REGION_ENTRY_SIZE;
+            if (ReadU32(entry) == 0) continue;
+            
+            // Reaching the column decodes all of its chunks
+            int cx = region->rx * REGION_SIZE + (columnIndex & REGION_MASK);
+            int cz = region->rz * REGION_SIZE + (columnIndex >> REGION_SHIFT);
+            GetChunk(world, cx, 0, cz);
+        }
+    }
+}
+
+// Save every chunk column of the world and the world's seed into a directory
+bool SaveWorld(World* world, const char* directory) {
+    if (!world || !directory) return false;
+
+#ifdef _WIN32
+    if (mkdir(directory) != 0 && errno != EEXIST) return false;
+#else
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) return false;
+#endif
+    
+    // World metadata
+    char path[REGION_PATH_LENGTH];
+    if (!GetWorldFilePath(path, directory, WORLD_INFO_FILE)) return false;
+    
+    uint8_t info[WORLD_INFO_SIZE];
+    memcpy(info, "VXWD", 4);
+    WriteU32(&info[4], REGION_FORMAT_VERSION);
+    WriteU32(&info[8], world->seed);
+    
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(info, 1, WORLD_INFO_SIZE, file) == WORLD_INFO_SIZE;
+    if (fclose(file) != 0) ok = false;
+    if (!ok) return false;
+    
+    // Collect the distinct columns that hold chunks
+    LoadUnreachedColumns(world, directory);
+    ChunkCoord* columns = (ChunkCoord*)malloc((world->chunkCount + 1) * sizeof(ChunkCoord));
+    if (!columns) return false;
+    
+    int columnCount = 0;
+    for (int i = 0; i < world->capacity; i++) {
+        Chunk* chunk = world->slots[i];
+        if (chunk) {
+            columns[columnCount++] = (ChunkCoord){ chunk->cx, 0, chunk->cz };
+        }
+    }
+    qsort(columns, columnCount, sizeof(ChunkCoord), CompareColumnCoords);
+    
+    for (int i = 0; i < columnCount && ok; i++) {
+        if (i > 0 && columns[i].cx == columns[i - 1].cx && columns[i].cz == columns[i - 1].cz) continue;
+        
+        Chunk* chunks[WORLD_CHUNKS_Y];
+        for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+            chunks[cy] = GetChunk(world, columns[i].cx, cy, columns[i].cz);
+        }
+        
+        ok = SaveChunkColumn(directory, columns[i].cx, columns[i].cz, chunks);
+        
+        for (int cy = 0; cy < WORLD_CHUNKS_Y && ok; cy++) {
+            if (chunks[cy]) chunks[cy]->modified = false;
+        }
+    }
+    
+    free(columns);
+    return ok;
+}
+
+// Read every saved column of a region file into the world
+static bool LoadRegionFile(World* world, const char* directory, int rx, int rz) {
+    FILE* file = OpenRegionFile(directory, rx, rz, false);
+    if (!file) return false;
+    
+    // Read the whole offset table at once
+    RegionEntry* table = (RegionEntry*)malloc(REGION_CHUNK_COUNT * sizeof(RegionEntry));
+    bool ok = table != NULL;
+    for (int column = 0; column < REGION_SIZE * REGION_SIZE && ok; column++) {
+        ok = ReadColumnEntries(file, column, &table[column * WORLD_CHUNKS_Y]);
+    }
+    
+    for (int lz = 0; lz < REGION_SIZE && ok; lz++) {
+        for (int lx = 0; lx < REGION_SIZE && ok; lx++) {
+            int cx = rx * REGION_SIZE + lx;
+            int cz = rz * REGION_SIZE + lz;
+            const RegionEntry* entries = &table[GetRegionColumnIndex(cx, cz) * WORLD_CHUNKS_Y];
+            Chunk* chunks[WORLD_CHUNKS_Y];
+            
+            // Columns that were never saved are simply absent
+            if (entries[0].offset == 0 || !ReadColumn(file, cx, cz, entries, chunks)) continue;
+            
+            for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+                if (chunks[cy] && !InsertChunk(world, chunks[cy])) {
+                    FreeChunk(chunks[cy]);
+                    ok = false;
+                }
+            }
+        }
+    }
+    
+    free(table);
+    fclose(file);
+    return ok;
+}
+
+// Read the world metadata file; returns false if the directory holds no world
+static bool ReadWorldInfo(const char* directory, unsigned int* seed) {
+    char path[REGION_PATH_LENGTH];
+    if (!GetWorldFilePath(path, directory, WORLD_INFO_FILE)) return false;
+    
+    uint8_t info[WORLD_INFO_SIZE];
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    bool ok = fread(info, 1, WORLD_INFO_SIZE, file) == WORLD_INFO_SIZE &&
+              memcmp(info, "VXWD", 4) == 0 &&
+              ReadU32(&info[4]) == REGION_FORMAT_VERSION;
+    fclose(file);
+    
+    if (ok) *seed = ReadU32(&info[8]);
+    return ok;
+}
+
+// Match a region file name, returning its region coordinates
+static bool ParseRegionFileName(const char* name, int* rx, int* rz) {
+    char suffix[8];
+    return sscanf(name, "r.%d.%d.%7s", rx, rz, suffix) == 3 && strcmp(suffix, "vxr") == 0;
+}
+
+// Load a world saved with SaveWorld; returns NULL if the directory holds no world
+World* LoadWorld(const char* directory) {
+    if (!directory) return NULL;
+    
+    unsigned int seed;
+    if (!ReadWorldInfo(directory, &seed)) return NULL;
+    
+    DIR* dir = opendir(directory);
+    if (!dir) return NULL;
+    
+    World* world = CreateWorld();
+    if (!world) {
+        closedir(dir);
+        return NULL;
+    }
+    world->seed = seed;
+    
+    pthread_mutex_lock(&regionLock);
+    
+    bool ok = true;
+    struct dirent* dirEntry;
+    while (ok && (dirEntry = readdir(dir)) != NULL) {
+        int rx, rz;
+        if (ParseRegionFileName(dirEntry->d_name, &rx, &rz)) {
+            ok = LoadRegionFile(world, directory, rx, rz);
+        }
+    }
+    
+    pthread_mutex_unlock(&regionLock);
+    closedir(dir);
+    
+    if (!ok) {
+        DestroyWorld(world);
+        return NULL;
+    }
+    
+    return world;
+}
+
+// Release a region file held by MapRegionFile
+static void UnmapRegionFile(MappedRegion* region) {
+#ifndef _WIN32
+    if (region->mapped) {
+        munmap((void*)region->data, region->size);
+        return;
+    }
+#endif
+    free((void*)region->data);
+}
+
+// Map a region file into memory (or read it whole where mmap is unavailable)
+// and check its header and offset table fit
+static bool MapRegionFile(const char* directory, int rx, int rz, MappedRegion* region) {
+    char path[REGION_PATH_LENGTH];
+    if (!GetRegionPath(path, directory, rx, rz)) return false;
+    
+    *region = (MappedRegion){ rx, rz, NULL, 0, false, { 0 } };
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                region->data = (const uint8_t*)data;
+                region->size = (size_t)info.st_size;
+                region->mapped = true;
+            }
+        }
+        close(fd); // The mapping outlives the descriptor
+    }
+#endif
+    
+    if (!region->data) {
+        FILE* file = fopen(path, "rb");
+        if (!file) return false;
+        
+        long size = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+        uint8_t* data = (size > 0) ? (uint8_t*)malloc((size_t)size) : NULL;
+        
+        if (data && fseek(file, 0, SEEK_SET) == 0 && fread(data, 1, (size_t)size, file) == (size_t)size) {
+            region->data = data;
+            region->size = (size_t)size;
+        } else {
+            free(data);
+        }
+        fclose(file);
+        
+        if (!region->data) return false;
+    }
+    
+    if (region->size < REGION_HEADER_SIZE + (size_t)REGION_CHUNK_COUNT * REGION_ENTRY_SIZE ||
+        memcmp(region->data, "VXRG", 4) != 0 ||
+        ReadU32(&region->data[4]) != REGION_FORMAT_VERSION ||
+        (int32_t)ReadU32(&region->data[8]) != rx ||
+        (int32_t)ReadU32(&region->data[12]) != rz) {
+        UnmapRegionFile(region);
+        return false;
+    }
+    
+    return true;
+}
+
+// Find the mapped region holding a column (NULL if it has no region file)
+static MappedRegion* FindMappedRegion(RegionSource* source, int rx, int rz) {
+    if (source->lastRegion < source->count) {
+        MappedRegion* region = &source->regions[source->lastRegion];
+        if (region->rx == rx && region->rz == rz) return region;
+    }
+    
+    for (int i = 0; i < source->count; i++) {
+        if (source->regions[i].rx == rx && source->regions[i].rz == rz) {
+            source->lastRegion = i;
+            return &source->regions[i];
+        }
+    }
+    
+    return NULL;
+}
+
+// ChunkColumnSource callback: decode a column from its mapped region the
+// first time it is asked for. Later requests return false because the
+// column may since have been edited, evicted and saved, leaving the
+// mapped copy stale.
+static bool LoadMappedColumn(void* context, int cx, int cz, Chunk* chunks[WORLD_CHUNKS_Y]) {
+    RegionSource* source = (RegionSource*)context;
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        chunks[cy] = NULL;
+    }
+    
+    MappedRegion* region = FindMappedRegion(source, cx >> REGION_SHIFT, cz >> REGION_SHIFT);
+    if (!region) return false;
+    
+    int columnIndex = GetRegionColumnIndex(cx, cz);
+    uint32_t bit = 1u << (columnIndex & 31);
+    if (region->faulted[columnIndex >> 5] & bit) return false;
+    region->faulted[columnIndex >> 5] |= bit;
+    
+    const uint8_t* entries = region->data + REGION_HEADER_SIZE + (size_t)columnIndex * WORLD_CHUNKS_Y * REGION_ENTRY_SIZE;
+    
+    bool ok = true;
+    for (int cy = 0; cy < WORLD_CHUNKS_Y && ok; cy++) {
+        uint32_t offset = ReadU32(&entries[cy * REGION_ENTRY_SIZE]);
+        uint32_t size = ReadU32(&entries[cy * REGION_ENTRY_SIZE + 4]);
+        
+        // Offset 0 means the column was never saved
+        ok = offset != 0 && offset <= region->size && size <= region->size - offset &&
+             DecodeChunk(region->data + offset, size, cx, cy, cz, &chunks[cy]);
+    }
+    
+    if (!ok) {
+        for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+            FreeChunk(chunks[cy]);
+            chunks[cy] = NULL;
+        }
+    }
+    
+    return ok;
+}
+
+// ChunkColumnSource callback: unmap every region file
+static void FreeRegionSource(void* context) {
+    RegionSource* source = (RegionSource*)context;
+    
+    for (int i = 0; i < source->count; i++) {
+        UnmapRegionFile(&source->regions[i]);
+    }
+    free(source->regions);
+    free(source);
+}
+
+// Open a world saved with SaveWorld without reading any chunks: region files
+// are mapped and each column is decoded the first time GetChunk reaches it.
+// Returns NULL if the directory holds no world.
+World* LoadWorldLazy(const char* directory) {
+    if (!directory) return NULL;
+    
+    unsigned int seed;
+    if (!ReadWorldInfo(directory, &seed)) return NULL;
+    
+    DIR* dir = opendir(directory);
+    if (!dir) return NULL;
+    
+    RegionSource* source = (RegionSource*)calloc(1, sizeof(RegionSource));
+    World* world = source ? CreateWorld() : NULL;
+    if (!world) {
+        free(source);
+        closedir(dir);
+        return NULL;
+    }
+    world->seed = seed;
+    snprintf(source->directory, sizeof(source->directory), "%s", directory);
+    
+    // The world frees the source from here on
+    world->columnSource = (ChunkColumnSource){ source, LoadMappedColumn, FreeRegionSource };
+    
+    pthread_mutex_lock(&regionLock);
+    
+    bool ok = true;
+    struct dirent* dirEntry;
+    while (ok && (dirEntry = readdir(dir)) != NULL) {
+        int rx, rz;
+        if (!ParseRegionFileName(dirEntry->d_name, &rx, &rz)) continue;
+        
+        if (source->count == source->capacity) {
+            int capacity = source->capacity ? source->capacity * 2 : 4;
+            MappedRegion* regions = (MappedRegion*)realloc(source->regions, capacity * sizeof(MappedRegion));
+            if (!regions) {
+                ok = false;
+                break;
+            }
+            source->regions = regions;
+            source->capacity = capacity;
+        }
+        
+        ok = MapRegionFile(directory, rx, rz, &source->regions[source->count]);
+        if (ok) source->count++;
+    }
+    
+    pthread_mutex_unlock(&regionLock);
+    closedir(dir);
+    
+    if (!ok) {
+        DestroyWorld(world);
+        return NULL;
+    }
+    
+    return world;
+}
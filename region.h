@@ -0,0 +1,31 @@
+#ifndef REGION_H
+#define REGION_H
+
+#include "voxel.h"
+
+// Region files group REGION_SIZE x REGION_SIZE chunk columns
+#define REGION_SHIFT 5
+#define REGION_SIZE (1 << REGION_SHIFT)
+#define REGION_MASK (REGION_SIZE - 1)
+#define REGION_CHUNK_COUNT (REGION_SIZE * REGION_SIZE * WORLD_CHUNKS_Y)
+
+// On-disk format version (bump when the layout changes)
+#define REGION_FORMAT_VERSION 1
+
+// Region file layout (all integers little-endian):
+//   header   "VXRG", uint32 version, int32 regionX, int32 regionZ
+//   table    REGION_CHUNK_COUNT entries of { uint32 offset, uint32 size },
+//            indexed by ((lz * REGION_SIZE) + lx) * WORLD_CHUNKS_Y + cy;
+//            offset 0 means the chunk was never saved
+//   records  uint32 runCount, then runCount runs of { uint16 length, uint8 block }
+//            covering the chunk layer by layer (y, then x, then z)
+//
+// A saved column always stores all WORLD_CHUNKS_Y chunks; chunks without
+// blocks are stored as a single empty run so they are not regenerated.
+
+// Save or load one chunk column (chunks[cy] may be NULL for empty chunks).
+// Safe to call from worker threads.
+bool SaveChunkColumn(const char* directory, int cx, int cz, Chunk* const chunks[WORLD_CHUNKS_Y]);
+bool LoadChunkColumn(const char* directory, int cx, int cz, Chunk* chunks[WORLD_CHUNKS_Y]);
+
+#endif // REGION_H
@@ -0,0 +1,563 @@
+#include "renderer.h"
+#include "mesher.h"
+#include "profiler.h"
+#include "raymath.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+
+// Initial number of hash table slots (must be a power of two)
+#define RENDERER_INITIAL_CAPACITY 256
+
+// Upper bound on chunks in the view range, and so on chunks held for the
+// transparent pass or remesh queue in one frame
+#define MAX_FRAME_CHUNKS ((VIEW_DISTANCE / CHUNK_SIZE + 2) * (VIEW_DISTANCE / CHUNK_SIZE + 2) * WORLD_CHUNKS_Y)
+
+// A chunk waiting to be meshed this frame
+typedef struct {
+    ChunkRenderEntry* entry;
+    int distanceSq;       // Squared chunk distance from the player
+} RemeshCandidate;
+
+// Range of chunk coordinates within render distance of the player
+typedef struct {
+    int startX, startY, startZ;
+    int endX, endY, endZ;
+} ChunkRange;
+
+// Work item for building a chunk mesh on a worker thread
+typedef struct {
+    JobQueue* completed;        // Where the finished job is delivered
+    unsigned int version;       // Entry version the snapshot was taken at
+    int lodLevel;               // Level of detail of the snapshot
+    bool success;               // Whether meshing succeeded
+    uint16_t connectivity;      // Face connectivity of the chunk
+    ChunkSnapshot snapshot;     // Read-only copy of the voxel data
+    ChunkMeshData mesh;         // Output geometry
+} MeshJob;
+
+// Find the slot holding an entry, or the free slot where it would be inserted
+static int FindEntrySlot(WorldRenderer* renderer, int cx, int cy, int cz) {
+    int mask = renderer->capacity - 1;
+    int slot = (int)(HashChunkCoords(cx, cy, cz) & (unsigned int)mask);
+    
+    while (renderer->slots[slot]) {
+        ChunkRenderEntry* entry = renderer->slots[slot];
+        if (entry->cx == cx && entry->cy == cy && entry->cz == cz) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    
+    return slot;
+}
+
+// Double the hash table size and reinsert every entry
+static bool GrowRenderer(WorldRenderer* renderer) {
+    int newCapacity = renderer->capacity * 2;
+    ChunkRenderEntry** newSlots = (ChunkRenderEntry**)calloc(newCapacity, sizeof(ChunkRenderEntry*));
+    if (!newSlots) return false;
+    
+    ChunkRenderEntry** oldSlots = renderer->slots;
+    int oldCapacity = renderer->capacity;
+    renderer->slots = newSlots;
+    renderer->capacity = newCapacity;
+    
+    for (int i = 0; i < oldCapacity; i++) {
+        ChunkRenderEntry* entry = oldSlots[i];
+        if (entry) {
+            renderer->slots[FindEntrySlot(renderer, entry->cx, entry->cy, entry->cz)] = entry;
+        }
+    }
+    
+    free(oldSlots);
+    return true;
+}
+
+// Upload a CPU vertex buffer to the GPU, releasing the CPU copy
+static Mesh UploadMeshBuffer(RenderBackend* backend, MeshBuffer* buffer) {
+    Mesh mesh = { 0 };
+    
+    if (buffer->vertexCount > 0) {
+        mesh.vertexCount = buffer->vertexCount;
+        mesh.triangleCount = buffer->vertexCount / 3;
+        mesh.vertices = buffer->vertices;
+        mesh.colors = buffer->colors;
+        UploadRenderMesh(backend, &mesh, false);
+        
+        // The GPU holds the geometry now
+        mesh.vertices = NULL;
+        mesh.colors = NULL;
+    }
+    
+    free(buffer->vertices);
+    free(buffer->colors);
+    buffer->vertices = NULL;
+    buffer->colors = NULL;
+    
+    return mesh;
+}
+
+// Upload the transparent faces of a chunk to a dynamic GPU buffer (they are
+// rewritten whenever they are re-sorted) and keep the CPU copy in the entry
+static void UploadTransparentQuads(RenderBackend* backend, ChunkRenderEntry* entry, MeshBuffer* buffer) {
+    entry->transparent = (Mesh){ 0 };
+    entry->transparentQuads = *buffer;
+    entry->sorted = false;
+    *buffer = (MeshBuffer){ 0 };
+    
+    if (entry->transparentQuads.vertexCount > 0) {
+        entry->transparent.vertexCount = entry->transparentQuads.vertexCount;
+        entry->transparent.triangleCount = entry->transparentQuads.vertexCount / 3;
+        entry->transparent.vertices = entry->transparentQuads.vertices;
+        entry->transparent.colors = entry->transparentQuads.colors;
+        UploadRenderMesh(backend, &entry->transparent, true);
+        
+        // The entry owns the CPU copy, not the mesh
+        entry->transparent.vertices = NULL;
+        entry->transparent.colors = NULL;
+    }
+}
+
+// Release the GPU geometry of an entry
+static void UnloadChunkEntryMeshes(RenderBackend* backend, ChunkRenderEntry* entry) {
+    if (entry->opaque.vertexCount > 0) UnloadRenderMesh(backend, entry->opaque);
+    if (entry->transparent.vertexCount > 0) UnloadRenderMesh(backend, entry->transparent);
+    entry->opaque = (Mesh){ 0 };
+    entry->transparent = (Mesh){ 0 };
+    
+    free(entry->transparentQuads.vertices);
+    free(entry->transparentQuads.colors);
+    entry->transparentQuads = (MeshBuffer){ 0 };
+    entry->sorted = false;
+}
+
+// Flag an entry for remeshing and give it a new version
+static void MarkEntryDirty(WorldRenderer* renderer, ChunkRenderEntry* entry) {
+    entry->dirty = true;
+    entry->version = ++renderer->nextVersion;
+}
+
+// Add an entry without geometry for a chunk; it is meshed later within the frame budget
+static ChunkRenderEntry* CreateChunkEntry(WorldRenderer* renderer, int cx, int cy, int cz) {
+    // Keep the load factor at or below one half
+    if ((renderer->entryCount + 1) * 2 > renderer->capacity && !GrowRenderer(renderer)) {
+        return NULL;
+    }
+    
+    ChunkRenderEntry* entry = (ChunkRenderEntry*)malloc(sizeof(ChunkRenderEntry));
+    if (!entry) return NULL;
+    
+    entry->cx = cx;
+    entry->cy = cy;
+    entry->cz = cz;
+    entry->opaque = (Mesh){ 0 };
+    entry->transparent = (Mesh){ 0 };
+    entry->transparentQuads = (MeshBuffer){ 0 };
+    entry->sorted = false;
+    entry->bounds = (BoundingBox){ 0 };
+    entry->lodLevel = 0;
+    entry->connectivity = CHUNK_ALL_FACES_CONNECTED;
+    entry->meshing = false;
+    MarkEntryDirty(renderer, entry);
+    
+    renderer->slots[FindEntrySlot(renderer, cx, cy, cz)] = entry;
+    renderer->entryCount++;
+    
+    return entry;
+}
+
+// Remove an entry from the cache and free its geometry
+static void RemoveChunkEntry(WorldRenderer* renderer, ChunkRenderEntry* entry) {
+    int mask = renderer->capacity - 1;
+    int slot = FindEntrySlot(renderer, entry->cx, entry->cy, entry->cz);
+    
+    renderer->slots[slot] = NULL;
+    renderer->entryCount--;
+    UnloadChunkEntryMeshes(renderer->backend, entry);
+    free(entry);
+    
+    // Shift back any following entries that can no longer be reached
+    int next = (slot + 1) & mask;
+    while (renderer->slots[next]) {
+        ChunkRenderEntry* moved = renderer->slots[next];
+        int home = (int)(HashChunkCoords(moved->cx, moved->cy, moved->cz) & (unsigned int)mask);
+        
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            renderer->slots[slot] = moved;
+            renderer->slots[next] = NULL;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+// Apply the world's queued block changes to the mesh cache
+static void ProcessDirtyChunks(WorldRenderer* renderer, World* world) {
+    ChunkCoord coord;
+    
+    while (PopDirtyChunk(world, &coord)) {
+        ChunkRenderEntry* entry = renderer->slots[FindEntrySlot(renderer, coord.cx, coord.cy, coord.cz)];
+        if (!entry) continue; // Never meshed; built when it comes into range
+        
+        if (GetChunk(world, coord.cx, coord.cy, coord.cz)) {
+            MarkEntryDirty(renderer, entry);
+        } else {
+            // The chunk lost its last block
+            RemoveChunkEntry(renderer, entry);
+        }
+    }
+}
+
+// Worker thread: build the mesh for a snapshot and hand it back to the main thread
+static void RunMeshJob(void* data) {
+    MeshJob* job = (MeshJob*)data;
+    
+    PROFILE_BEGIN("MeshChunk");
+    job->success = BuildChunkMesh(&job->snapshot, &job->mesh);
+    
+    // Downsampled chunks are fuller than the real ones, so they never occlude
+    job->connectivity = (job->lodLevel > 0) ? CHUNK_ALL_FACES_CONNECTED : GetChunkConnectivity(&job->snapshot);
+    PROFILE_END();
+    
+    // The completion queue is sized for every job in flight, so this only
+    // spins if the main thread has fallen far behind
+    while (!PushJob(job->completed, (Job){ NULL, job })) {
+        sched_yield();
+    }
+}
+
+// Snapshot a chunk and queue it for meshing on the workers
+static bool StartMeshJob(WorldRenderer* renderer, World* world, ChunkRenderEntry* entry) {
+    MeshJob* job = (MeshJob*)malloc(sizeof(MeshJob));
+    if (!job) return false;
+    
+    job->completed = &renderer->completedJobs;
+    job->version = entry->version;
+    job->lodLevel = entry->lodLevel;
+    job->success = false;
+    if (entry->lodLevel > 0) {
+        CreateLodSnapshot(world, entry->cx, entry->cy, entry->cz, entry->lodLevel, &job->snapshot);
+    } else {
+        CreateChunkSnapshot(world, entry->cx, entry->cy, entry->cz, &job->snapshot);
+    }
+    
+    if (!SubmitJob(renderer->jobs, RunMeshJob, job)) {
+        free(job);
+        return false;
+    }
+    
+    entry->meshing = true;
+    renderer->jobsInFlight++;
+    return true;
+}
+
+// Upload the meshes finished by the workers since the last frame
+static void CollectMeshJobs(WorldRenderer* renderer) {
+    Job completed;
+    
+    while (PopJob(&renderer->completedJobs, &completed)) {
+        MeshJob* job = (MeshJob*)completed.data;
+        ChunkSnapshot* snapshot = &job->snapshot;
+        ChunkRenderEntry* entry = renderer->slots[FindEntrySlot(renderer, snapshot->cx, snapshot->cy, snapshot->cz)];
+        renderer->jobsInFlight--;
+        
+        if (entry && entry->version == job->version) {
+            entry->meshing = false;
+            
+            if (job->success) {
+                UnloadChunkEntryMeshes(renderer->backend, entry);
+                entry->opaque = UploadMeshBuffer(renderer->backend, &job->mesh.opaque);
+                UploadTransparentQuads(renderer->backend, entry, &job->mesh.transparent);
+                entry->bounds = job->mesh.bounds;
+                entry->connectivity = job->connectivity;
+                entry->dirty = false;
+            }
+        } else if (entry) {
+            // The chunk changed while it was being meshed; it is still dirty
+            entry->meshing = false;
+        }
+        
+        if (job->success) FreeChunkMeshData(&job->mesh);
+        free(job);
+    }
+}
+
+// Order remesh candidates nearest first
+static int CompareRemeshCandidates(const void* a, const void* b) {
+    int da = ((const RemeshCandidate*)a)->distanceSq;
+    int db = ((const RemeshCandidate*)b)->distanceSq;
+    return (da > db) - (da < db);
+}
+
+// Get the range of chunks overlapping the cube of VIEW_DISTANCE around the player
+static ChunkRange GetRenderChunkRange(Player* player) {
+    // Calculate the maximum distance to render blocks
+    int renderHalfDistance = VIEW_DISTANCE / 2;
+
+    // Convert player position to integer coordinates
+    Vector3 position = GetPlayerPosition(player);
+    int playerX = (int)floorf(position.x);
+    int playerY = (int)floorf(position.y);
+    int playerZ = (int)floorf(position.z);
+
+    ChunkRange range = {
+        BlockToChunkCoord(playerX - renderHalfDistance),
+        BlockToChunkCoord(playerY - renderHalfDistance),
+        BlockToChunkCoord(playerZ - renderHalfDistance),
+        BlockToChunkCoord(playerX + renderHalfDistance),
+        BlockToChunkCoord(playerY + renderHalfDistance),
+        BlockToChunkCoord(playerZ + renderHalfDistance)
+    };
+
+    // Clamp to the vertical world bounds
+    range.startY = (range.startY < 0) ? 0 : range.startY;
+    range.endY = (range.endY >= WORLD_CHUNKS_Y) ? WORLD_CHUNKS_Y - 1 : range.endY;
+
+    return range;
+}
+
+// Level of detail for a chunk at a horizontal chunk distance from the
+// player: full resolution within RENDER_DISTANCE, then one level coarser
+// per LOD_BAND_WIDTH blocks up to MAX_LOD_LEVEL
+static int GetChunkLodLevel(int dx, int dz) {
+    int distance = ((abs(dx) > abs(dz)) ? abs(dx) : abs(dz)) * CHUNK_SIZE;
+    if (distance <= RENDER_DISTANCE / 2) return 0;
+    
+    int level = 1 + (distance - RENDER_DISTANCE / 2 - 1) / LOD_BAND_WIDTH;
+    return (level > MAX_LOD_LEVEL) ? MAX_LOD_LEVEL : level;
+}
+
+// Create a renderer with an empty mesh cache that submits its geometry to a
+// backend (the backend must outlive the renderer)
+WorldRenderer* CreateWorldRenderer(JobSystem* jobs, RenderBackend* backend) {
+    if (!jobs || !backend) return NULL;
+    
+    WorldRenderer* renderer = (WorldRenderer*)malloc(sizeof(WorldRenderer));
+    
+    if (renderer) {
+        renderer->capacity = RENDERER_INITIAL_CAPACITY;
+        renderer->entryCount = 0;
+        renderer->slots = (ChunkRenderEntry**)calloc(renderer->capacity, sizeof(ChunkRenderEntry*));
+        
+        renderer->visibility = CreateChunkVisibility(MAX_FRAME_CHUNKS);
+        
+        if (!renderer->slots || !renderer->visibility ||
+            !InitJobQueue(&renderer->completedJobs, MAX_MESH_JOBS_IN_FLIGHT)) {
+            DestroyChunkVisibility(renderer->visibility);
+            free(renderer->slots);
+            free(renderer);
+            return NULL;
+        }
+        
+        renderer->jobs = jobs;
+        renderer->jobsInFlight = 0;
+        renderer->nextVersion = 0;
+        renderer->stats = (RenderStats){ 0 };
+        renderer->backend = backend;
+    }
+    
+    return renderer;
+}
+
+// Free the renderer and all cached chunk meshes
+void DestroyWorldRenderer(WorldRenderer* renderer) {
+    if (renderer) {
+        // Wait for the workers to hand back every job that references the renderer
+        while (renderer->jobsInFlight > 0) {
+            CollectMeshJobs(renderer);
+            if (renderer->jobsInFlight > 0) sched_yield();
+        }
+        
+        for (int i = 0; i < renderer->capacity; i++) {
+            if (renderer->slots[i]) {
+                UnloadChunkEntryMeshes(renderer->backend, renderer->slots[i]);
+                free(renderer->slots[i]);
+            }
+        }
+        free(renderer->slots);
+        DestroyChunkVisibility(renderer->visibility);
+        FreeJobQueue(&renderer->completedJobs);
+        free(renderer);
+    }
+}
+
+// Upload finished meshes and start mesh jobs for the nearest out-of-date chunks.
+// Never waits for the workers: stale geometry is drawn until its replacement arrives.
+void UpdateWorldRenderer(WorldRenderer* renderer, World* world, Player* player) {
+    if (!renderer || !world || !player) return;
+
+    PROFILE_BEGIN("UpdateWorldRenderer");
+    CollectMeshJobs(renderer);
+
+    // Pick up block edits made since the last frame
+    ProcessDirtyChunks(renderer, world);
+
+    ChunkRange range = GetRenderChunkRange(player);
+    Vector3 position = GetPlayerPosition(player);
+    int playerCX = BlockToChunkCoord((int)floorf(position.x));
+    int playerCY = BlockToChunkCoord((int)floorf(position.y));
+    int playerCZ = BlockToChunkCoord((int)floorf(position.z));
+
+    int candidateCount = 0;
+    RemeshCandidate candidates[MAX_FRAME_CHUNKS];
+
+    for (int cx = range.startX; cx <= range.endX; cx++) {
+        for (int cy = range.startY; cy <= range.endY; cy++) {
+            for (int cz = range.startZ; cz <= range.endZ; cz++) {
+                ChunkRenderEntry* entry = renderer->slots[FindEntrySlot(renderer, cx, cy, cz)];
+                
+                if (!entry) {
+                    // Chunks that hold no blocks have no geometry
+                    if (!GetChunk(world, cx, cy, cz)) continue;
+                    
+                    entry = CreateChunkEntry(renderer, cx, cy, cz);
+                    if (!entry) continue;
+                }
+                
+                // Remesh at a new level of detail when the player moves between bands
+                int lodLevel = GetChunkLodLevel(cx - playerCX, cz - playerCZ);
+                if (lodLevel != entry->lodLevel) {
+                    entry->lodLevel = lodLevel;
+                    MarkEntryDirty(renderer, entry);
+                }
+                
+                if (entry->dirty && !entry->meshing && candidateCount < MAX_FRAME_CHUNKS) {
+                    int dx = cx - playerCX, dy = cy - playerCY, dz = cz - playerCZ;
+                    candidates[candidateCount++] = (RemeshCandidate){ entry, dx*dx + dy*dy + dz*dz };
+                }
+            }
+        }
+    }
+
+    // Start jobs for the nearest chunks, up to the per-frame budget
+    qsort(candidates, candidateCount, sizeof(RemeshCandidate), CompareRemeshCandidates);
+    for (int i = 0; i < candidateCount && i < REMESH_BUDGET_PER_FRAME; i++) {
+        if (renderer->jobsInFlight >= MAX_MESH_JOBS_IN_FLIGHT) break;
+        if (!StartMeshJob(renderer, world, candidates[i].entry)) break;
+    }
+    PROFILE_END();
+}
+
+// A chunk with transparent faces queued for the blended pass
+typedef struct {
+    ChunkRenderEntry* entry;
+    float distanceSq;     // Squared distance from the camera to the chunk's centre
+} TransparentChunk;
+
+// Order transparent chunks farthest first
+static int CompareTransparentChunks(const void* a, const void* b) {
+    float da = ((const TransparentChunk*)a)->distanceSq;
+    float db = ((const TransparentChunk*)b)->distanceSq;
+    return (da < db) - (da > db);
+}
+
+// Camera cell or octant that decides when a chunk's transparent faces need
+// sorting again. Close to the chunk, the order changes as the camera passes
+// between blocks, so the key is the camera's block. Farther away the faces
+// are seen from one side, so the key is the octant around the chunk's centre.
+static void GetTransparentSortKey(const ChunkRenderEntry* entry, Vector3 camera, int key[4]) {
+    BoundingBox bounds = entry->bounds;
+    float dx = fmaxf(fmaxf(bounds.min.x - camera.x, camera.x - bounds.max.x), 0.0f);
+    float dy = fmaxf(fmaxf(bounds.min.y - camera.y, camera.y - bounds.max.y), 0.0f);
+    float dz = fmaxf(fmaxf(bounds.min.z - camera.z, camera.z - bounds.max.z), 0.0f);
+    bool nearby = fmaxf(dx, fmaxf(dy, dz)) < TRANSPARENT_SORT_NEAR_DISTANCE;
+    
+    if (nearby) {
+        key[0] = (int)floorf(camera.x);
+        key[1] = (int)floorf(camera.y);
+        key[2] = (int)floorf(camera.z);
+    } else {
+        key[0] = camera.x > (bounds.min.x + bounds.max.x) * 0.5f;
+        key[1] = camera.y > (bounds.min.y + bounds.max.y) * 0.5f;
+        key[2] = camera.z > (bounds.min.z + bounds.max.z) * 0.5f;
+    }
+    key[3] = nearby;
+}
+
+// Sort a chunk's transparent faces back to front for the camera, unless
+// they are already sorted for its cell or octant
+static void SortTransparentQuads(WorldRenderer* renderer, ChunkRenderEntry* entry, Vector3 camera) {
+    int key[4];
+    GetTransparentSortKey(entry, camera, key);
+    
+    if (entry->sorted && memcmp(key, entry->sortKey, sizeof(key)) == 0) return;
+    
+    MeshBuffer* quads = &entry->transparentQuads;
+    if (!SortMeshBufferQuads(quads, camera)) return;
+    
+    UpdateRenderMeshBuffer(renderer->backend, entry->transparent, 0, quads->vertices, quads->vertexCount * 3 * sizeof(float));
+    UpdateRenderMeshBuffer(renderer->backend, entry->transparent, 3, quads->colors, quads->vertexCount * 4);
+    
+    memcpy(entry->sortKey, key, sizeof(key));
+    entry->sorted = true;
+    renderer->stats.transparentSorts++;
+}
+
+// Face connectivity of a chunk for the visibility search: chunks without an
+// entry hold no blocks (or have not been seen yet) and hide nothing
+static uint16_t GetEntryConnectivity(void* context, int cx, int cy, int cz) {
+    WorldRenderer* renderer = (WorldRenderer*)context;
+    ChunkRenderEntry* entry = renderer->slots[FindEntrySlot(renderer, cx, cy, cz)];
+    
+    return entry ? entry->connectivity : CHUNK_ALL_FACES_CONNECTED;
+}
+
+// Render the voxel world. Only chunks the visibility search reaches from the
+// camera are considered, and those are still tested against the frustum
+// with the tighter bounds of their geometry.
+void RenderWorld(WorldRenderer* renderer, World* world, Player* player, Camera camera) {
+    if (!renderer || !world || !player) return;
+
+    PROFILE_BEGIN("RenderWorld");
+    ChunkRange range = GetRenderChunkRange(player);
+    ChunkBox box = { range.startX, range.startY, range.startZ, range.endX, range.endY, range.endZ };
+    Frustum frustum = GetCameraFrustum(camera, GetRenderAspectRatio(renderer->backend));
+    Matrix transform = MatrixIdentity();
+    int visibleCount = 0;
+    TransparentChunk visible[MAX_FRAME_CHUNKS];
+    ChunkCoord reached[MAX_FRAME_CHUNKS];
+
+    renderer->stats = (RenderStats){ 0 };
+    renderer->stats.chunksReached = FindVisibleChunks(renderer->visibility, box, camera.position, &frustum,
+                                                      GetEntryConnectivity, renderer, reached, MAX_FRAME_CHUNKS);
+
+    // First pass: Render opaque geometry
+    for (int i = 0; i < renderer->stats.chunksReached; i++) {
+        ChunkRenderEntry* entry = renderer->slots[FindEntrySlot(renderer, reached[i].cx, reached[i].cy, reached[i].cz)];
+        if (!entry) continue;
+        if (entry->opaque.vertexCount == 0 && entry->transparent.vertexCount == 0) continue;
+        
+        renderer->stats.chunksTested++;
+        if (!IsBoxInFrustum(&frustum, entry->bounds)) {
+            renderer->stats.chunksCulled++;
+            continue;
+        }
+        renderer->stats.chunksDrawn++;
+        if (entry->lodLevel > 0) renderer->stats.lodChunksDrawn++;
+        
+        if (entry->opaque.vertexCount > 0) {
+            DrawRenderMesh(renderer->backend, entry->opaque, transform);
+        }
+        if (entry->transparent.vertexCount > 0 && visibleCount < MAX_FRAME_CHUNKS) {
+            float dx = (entry->bounds.min.x + entry->bounds.max.x) * 0.5f - camera.position.x;
+            float dy = (entry->bounds.min.y + entry->bounds.max.y) * 0.5f - camera.position.y;
+            float dz = (entry->bounds.min.z + entry->bounds.max.z) * 0.5f - camera.position.z;
+            visible[visibleCount++] = (TransparentChunk){ entry, dx * dx + dy * dy + dz * dz };
+        }
+    }
+
+    // Second pass: Render transparent geometry back to front, chunk by chunk
+    // and face by face within each chunk, so the blending composites correctly
+    qsort(visible, visibleCount, sizeof(TransparentChunk), CompareTransparentChunks);
+    
+    // Enable alpha blending for transparent objects
+    SetRenderBlending(renderer->backend, true);
+    for (int i = 0; i < visibleCount; i++) {
+        SortTransparentQuads(renderer, visible[i].entry, camera.position);
+        DrawRenderMesh(renderer->backend, visible[i].entry->transparent, transform);
+    }
+    SetRenderBlending(renderer->backend, false);
+    PROFILE_END();
+}
@@ -0,0 +1,83 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include "raylib.h"
+#include "voxel.h"
+#include "player.h"
+#include "jobs.h"
+#include "frustum.h"
+#include "mesher.h"
+#include "visibility.h"
+#include "backend.h"
+
+// Side of the cube around the player drawn at full 1-block resolution;
+// chunks beyond it are drawn from downsampled data (see LOD_BAND_WIDTH)
+#define RENDER_DISTANCE 48
+
+// Side of the cube around the player that is drawn at all
+#define VIEW_DISTANCE 160
+
+// Width in blocks of each level-of-detail band past RENDER_DISTANCE: the
+// first band is meshed from 2x2x2 cells, the next from 4x4x4 cells and
+// everything farther from 8x8x8 cells
+#define LOD_BAND_WIDTH 24
+
+// Maximum number of chunk mesh jobs started per frame
+#define REMESH_BUDGET_PER_FRAME 8
+
+// Maximum number of chunk mesh jobs running on the workers at once
+#define MAX_MESH_JOBS_IN_FLIGHT 64
+
+// Within this many blocks of a chunk, its transparent faces are re-sorted
+// whenever the camera enters another block; farther away, only when the
+// camera moves into another octant around the chunk
+#define TRANSPARENT_SORT_NEAR_DISTANCE CHUNK_SIZE
+
+// GPU geometry cached for one chunk
+typedef struct {
+    int cx, cy, cz;       // Chunk coordinates
+    Mesh opaque;          // Solid faces (vertexCount is 0 when there are none)
+    Mesh transparent;     // Transparent faces, drawn in the blended pass
+    MeshBuffer transparentQuads; // CPU copy of the transparent faces, in their last sorted order
+    int sortKey[4];       // Camera cell or octant the transparent faces were sorted for
+    bool sorted;          // sortKey is valid
+    BoundingBox bounds;   // World-space bounds of the geometry, used for culling
+    int lodLevel;         // Level of detail the chunk is meshed at (0 is full resolution)
+    uint16_t connectivity; // Faces the chunk can be seen through, from the last mesh (see GetChunkConnectivity)
+    bool dirty;           // Blocks changed since the mesh was built
+    bool meshing;         // A mesh job for this chunk is running
+    unsigned int version; // Changes every time the chunk is marked dirty
+} ChunkRenderEntry;
+
+// Per-frame culling counters
+typedef struct {
+    int chunksReached;    // Chunks reached by the visibility search (the rest are occluded or outside the frustum)
+    int chunksTested;     // Chunks with geometry checked against the frustum
+    int chunksCulled;     // Chunks rejected by the frustum test
+    int chunksDrawn;      // Chunks submitted for drawing
+    int lodChunksDrawn;   // Drawn chunks meshed at a reduced level of detail
+    int transparentSorts; // Chunks whose transparent faces were re-sorted
+} RenderStats;
+
+// Renderer state: a hash map of chunk meshes keyed by chunk coordinates
+typedef struct {
+    ChunkRenderEntry** slots;   // Hash table slots (NULL when free)
+    int capacity;               // Number of slots (always a power of two)
+    int entryCount;             // Number of cached chunk meshes
+    RenderBackend* backend;     // Where geometry is uploaded and drawn (not owned)
+    RenderStats stats;          // Counters from the last RenderWorld call
+    ChunkVisibility* visibility; // Occlusion search state
+    
+    JobSystem* jobs;            // Worker pool that builds meshes
+    JobQueue completedJobs;     // Finished mesh jobs waiting to be uploaded
+    int jobsInFlight;           // Mesh jobs submitted but not yet collected
+    unsigned int nextVersion;   // Source of entry versions
+} WorldRenderer;
+
+// Function prototypes
+WorldRenderer* CreateWorldRenderer(JobSystem* jobs, RenderBackend* backend);
+void DestroyWorldRenderer(WorldRenderer* renderer);
+void UpdateWorldRenderer(WorldRenderer* renderer, World* world, Player* player);
+void RenderWorld(WorldRenderer* renderer, World* world, Player* player, Camera camera);
+
+#endif // RENDERER_H
@@ -0,0 +1,545 @@
+#include "streaming.h"
+#include "terrain.h"
+#include "region.h"
+#include "profiler.h"
+#include <stdlib.h>
+#include <math.h>
+#include <sched.h>
+
+// Initial number of column slots (must be a power of two)
+#define STREAMER_INITIAL_CAPACITY 256
+
+// How strongly the view direction favours columns ahead of the player:
+// a column straight ahead is served as if it were this much closer
+#define STREAM_VIEW_BIAS 0.5f
+
+// Work item for loading, generating or saving one column on a worker thread
+typedef struct {
+    JobQueue* completed;            // Where the finished job is delivered
+    int cx, cz;                     // Column coordinates
+    unsigned int seed;              // World seed
+    const char* saveDirectory;      // Region file directory (may be NULL)
+    bool saving;                    // Save the chunks instead of producing them
+    bool success;                   // Whether the job succeeded
+    Chunk* chunks[WORLD_CHUNKS_Y];  // Column chunks (NULL for empty ones)
+} StreamJob;
+
+// Find the slot holding a column, or the free slot where it would be inserted
+static int FindColumnSlot(WorldStreamer* streamer, int cx, int cz) {
+    int mask = streamer->capacity - 1;
+    int slot = (int)(HashChunkCoords(cx, 0, cz) & (unsigned int)mask);
+    
+    while (streamer->slots[slot].used) {
+        StreamColumn* column = &streamer->slots[slot];
+        if (column->cx == cx && column->cz == cz) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    
+    return slot;
+}
+
+// Get a tracked column (NULL if the streamer does not know it)
+static StreamColumn* GetStreamColumn(WorldStreamer* streamer, int cx, int cz) {
+    StreamColumn* column = &streamer->slots[FindColumnSlot(streamer, cx, cz)];
+    return column->used ? column : NULL;
+}
+
+// Double the column table size and reinsert every column
+static bool GrowStreamer(WorldStreamer* streamer) {
+    int newCapacity = streamer->capacity * 2;
+    StreamColumn* newSlots = (StreamColumn*)calloc(newCapacity, sizeof(StreamColumn));
+    if (!newSlots) return false;
+    
+    StreamColumn* oldSlots = streamer->slots;
+    int oldCapacity = streamer->capacity;
+    streamer->slots = newSlots;
+    streamer->capacity = newCapacity;
+    
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i].used) {
+            streamer->slots[FindColumnSlot(streamer, oldSlots[i].cx, oldSlots[i].cz)] = oldSlots[i];
+        }
+    }
+    
+    free(oldSlots);
+    return true;
+}
+
+// Start tracking a column
+static StreamColumn* AddStreamColumn(WorldStreamer* streamer, int cx, int cz, ColumnState state) {
+    // Keep the load factor at or below one half
+    if ((streamer->columnCount + 1) * 2 > streamer->capacity && !GrowStreamer(streamer)) {
+        return NULL;
+    }
+    
+    StreamColumn* column = &streamer->slots[FindColumnSlot(streamer, cx, cz)];
+    column->cx = cx;
+    column->cz = cz;
+    column->used = true;
+    column->state = state;
+    column->lastUsed = streamer->frame;
+    column->chunkCount = 0;
+    streamer->columnCount++;
+    
+    return column;
+}
+
+// Stop tracking a column
+static void RemoveStreamColumn(WorldStreamer* streamer, int cx, int cz) {
+    int mask = streamer->capacity - 1;
+    int slot = FindColumnSlot(streamer, cx, cz);
+    if (!streamer->slots[slot].used) return;
+    
+    streamer->slots[slot].used = false;
+    streamer->columnCount--;
+    
+    // Shift back any following columns that can no longer be reached
+    int next = (slot + 1) & mask;
+    while (streamer->slots[next].used) {
+        StreamColumn* moved = &streamer->slots[next];
+        int home = (int)(HashChunkCoords(moved->cx, 0, moved->cz) & (unsigned int)mask);
+        
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            streamer->slots[slot] = *moved;
+            moved->used = false;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+// Add a request to the priority queue
+static bool PushStreamRequest(StreamQueue* queue, StreamRequest request) {
+    if (queue->count == queue->capacity) {
+        int capacity = queue->capacity ? queue->capacity * 2 : 128;
+        StreamRequest* items = (StreamRequest*)realloc(queue->items, capacity * sizeof(StreamRequest));
+        if (!items) return false;
+        
+        queue->items = items;
+        queue->capacity = capacity;
+    }
+    
+    // Sift up
+    int i = queue->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (queue->items[parent].priority <= request.priority) break;
+        queue->items[i] = queue->items[parent];
+        i = parent;
+    }
+    queue->items[i] = request;
+    
+    return true;
+}
+
+// Take the request with the lowest priority value; returns false when the queue is empty
+static bool PopStreamRequest(StreamQueue* queue, StreamRequest* request) {
+    if (queue->count == 0) return false;
+    
+    *request = queue->items[0];
+    StreamRequest last = queue->items[--queue->count];
+    
+    // Sift the last item down from the root
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= queue->count) break;
+        if (child + 1 < queue->count && queue->items[child + 1].priority < queue->items[child].priority) {
+            child++;
+        }
+        if (last.priority <= queue->items[child].priority) break;
+        queue->items[i] = queue->items[child];
+        i = child;
+    }
+    if (queue->count > 0) queue->items[i] = last;
+    
+    return true;
+}
+
+// Check whether the world already holds any chunk of a column
+static bool IsColumnInWorld(World* world, int cx, int cz) {
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        if (GetChunk(world, cx, cy, cz)) return true;
+    }
+    return false;
+}
+
+// Number of chunks the world holds for a column
+static int CountColumnChunks(World* world, int cx, int cz) {
+    int count = 0;
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        if (GetChunk(world, cx, cy, cz)) count++;
+    }
+    return count;
+}
+
+// Bytes of chunk storage used by a column
+static size_t GetColumnMemoryUsage(World* world, int cx, int cz) {
+    size_t bytes = 0;
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        bytes += GetChunkMemoryUsage(GetChunk(world, cx, cy, cz));
+    }
+    return bytes;
+}
+
+// Check whether a column differs from what was loaded: a chunk was edited,
+// or edits created or emptied (and so freed) a chunk
+static bool IsColumnModified(World* world, const StreamColumn* column) {
+    int count = 0;
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        Chunk* chunk = GetChunk(world, column->cx, cy, column->cz);
+        if (chunk) {
+            if (chunk->modified) return true;
+            count++;
+        }
+    }
+    return count != column->chunkCount;
+}
+
+// Worker thread: save a column, or load it (generating it if it was never
+// saved), and hand it back to the main thread
+static void RunStreamJob(void* data) {
+    StreamJob* job = (StreamJob*)data;
+    
+    if (job->saving) {
+        PROFILE_BEGIN("SaveColumn");
+        job->success = SaveChunkColumn(job->saveDirectory, job->cx, job->cz, job->chunks);
+        PROFILE_END();
+    } else {
+        PROFILE_BEGIN("LoadColumn");
+        job->success = LoadChunkColumn(job->saveDirectory, job->cx, job->cz, job->chunks) ||
+                       GenerateChunkColumn(job->cx, job->cz, job->seed, job->chunks);
+        PROFILE_END();
+    }
+    
+    // The completion queue is sized for every job in flight
+    while (!PushJob(job->completed, (Job){ NULL, job })) {
+        sched_yield();
+    }
+}
+
+// Allocate a job for a column
+static StreamJob* CreateStreamJob(WorldStreamer* streamer, int cx, int cz, bool saving) {
+    StreamJob* job = (StreamJob*)malloc(sizeof(StreamJob));
+    if (!job) return NULL;
+    
+    job->completed = &streamer->completedJobs;
+    job->cx = cx;
+    job->cz = cz;
+    job->seed = streamer->seed;
+    job->saveDirectory = streamer->saveDirectory;
+    job->saving = saving;
+    job->success = false;
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        job->chunks[cy] = NULL;
+    }
+    
+    return job;
+}
+
+// Queue a column for loading or generation on the workers. The world holds
+// the column until it arrives, so edits made meanwhile land on top of it.
+static bool StartStreamJob(WorldStreamer* streamer, World* world, int cx, int cz) {
+    StreamJob* job = CreateStreamJob(streamer, cx, cz, false);
+    if (!job) return false;
+    
+    if (!HoldColumn(world, cx, cz)) {
+        free(job);
+        return false;
+    }
+    
+    if (!AddStreamColumn(streamer, cx, cz, COLUMN_GENERATING)) {
+        free(job);
+        return false;
+    }
+    
+    if (!SubmitJob(streamer->jobs, RunStreamJob, job)) {
+        RemoveStreamColumn(streamer, cx, cz);
+        free(job);
+        return false;
+    }
+    
+    streamer->jobsInFlight++;
+    return true;
+}
+
+// Insert the columns finished by the workers since the last update
+// (world may be NULL when shutting down, in which case the chunks are dropped)
+static void CollectStreamJobs(WorldStreamer* streamer, World* world) {
+    Job completed;
+    
+    while (PopJob(&streamer->completedJobs, &completed)) {
+        StreamJob* job = (StreamJob*)completed.data;
+        streamer->jobsInFlight--;
+        if (job->saving) streamer->stats.savingColumns--;
+        
+        if (job->saving && job->success && world && GetHeldEditCount(world, job->cx, job->cz) > 0) {
+            // Edited while it was being saved: load the column back from disk
+            // and release it on top of that (the completion queue has room
+            // for the job again, so it can also run here)
+            for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+                FreeChunk(job->chunks[cy]);
+                job->chunks[cy] = NULL;
+            }
+            job->saving = false;
+            job->success = false;
+            
+            StreamColumn* column = GetStreamColumn(streamer, job->cx, job->cz);
+            if (column) column->state = COLUMN_GENERATING;
+            streamer->jobsInFlight++;
+            if (!SubmitJob(streamer->jobs, RunStreamJob, job)) {
+                RunStreamJob(job);
+            }
+            continue;
+        }
+        
+        if (job->saving && (job->success || !world)) {
+            // The column is on disk now; it is loaded from there next time
+            for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+                FreeChunk(job->chunks[cy]);
+            }
+            ReleaseColumn(world, job->cx, job->cz);
+            RemoveStreamColumn(streamer, job->cx, job->cz);
+        } else if (world && (job->success || job->saving)) {
+            // A column that failed to save goes back into the world rather than being lost
+            for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+                if (job->chunks[cy] && !InsertChunk(world, job->chunks[cy])) {
+                    FreeChunk(job->chunks[cy]);
+                }
+            }
+            
+            StreamColumn* column = GetStreamColumn(streamer, job->cx, job->cz);
+            if (column) {
+                column->state = COLUMN_LOADED;
+                column->chunkCount = job->saving ? -1 : CountColumnChunks(world, job->cx, job->cz);
+            }
+            
+            // Edits made while the column was away go on top (and mark it modified)
+            ReleaseColumn(world, job->cx, job->cz);
+        } else {
+            for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+                FreeChunk(job->chunks[cy]);
+            }
+            
+            // Forget the column so it is requested again (the world keeps
+            // holding it, and any edits, until it arrives)
+            RemoveStreamColumn(streamer, job->cx, job->cz);
+        }
+        
+        free(job);
+    }
+}
+
+// Order eviction candidates least recently used first
+static int CompareColumnsByLastUse(const void* a, const void* b) {
+    unsigned long ua = (*(StreamColumn* const*)a)->lastUsed;
+    unsigned long ub = (*(StreamColumn* const*)b)->lastUsed;
+    return (ua > ub) - (ua < ub);
+}
+
+// Hand an evicted column's chunks to a worker that writes them to disk
+static bool StartSaveJob(WorldStreamer* streamer, World* world, StreamColumn* column) {
+    StreamJob* job = CreateStreamJob(streamer, column->cx, column->cz, true);
+    if (!job) return false;
+    
+    // Edits made while the chunks are away are applied once they are on disk
+    if (!HoldColumn(world, column->cx, column->cz)) {
+        free(job);
+        return false;
+    }
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        job->chunks[cy] = DetachChunk(world, column->cx, cy, column->cz);
+    }
+    column->state = COLUMN_SAVING;
+    streamer->jobsInFlight++;
+    streamer->stats.savingColumns++;
+    
+    // The completion queue has room for this job, so it can also run here
+    if (!SubmitJob(streamer->jobs, RunStreamJob, job)) {
+        RunStreamJob(job);
+    }
+    
+    return true;
+}
+
+// Evict loaded columns outside the radius, least recently used first, until
+// the world fits its memory budget (or the per-update limit is reached).
+// Edited columns are written to the save directory on the workers first.
+static void EvictStreamColumns(WorldStreamer* streamer, World* world) {
+    size_t usage = GetWorldMemoryUsage(world);
+    streamer->stats.evictedColumns = 0;
+    
+    if (usage > streamer->memoryBudget) {
+        StreamColumn** candidates = (StreamColumn**)malloc(streamer->columnCount * sizeof(StreamColumn*));
+        if (candidates) {
+            int candidateCount = 0;
+            for (int i = 0; i < streamer->capacity; i++) {
+                StreamColumn* column = &streamer->slots[i];
+                if (column->used && column->state == COLUMN_LOADED && column->lastUsed != streamer->frame) {
+                    candidates[candidateCount++] = column;
+                }
+            }
+            
+            qsort(candidates, candidateCount, sizeof(StreamColumn*), CompareColumnsByLastUse);
+            
+            // Collect the coordinates first: removing columns moves slots around
+            int evictCount = 0;
+            ChunkCoord evicted[MAX_STREAM_EVICTIONS_PER_FRAME];
+            for (int i = 0; i < candidateCount && evictCount < MAX_STREAM_EVICTIONS_PER_FRAME; i++) {
+                if (usage <= streamer->memoryBudget) break;
+                
+                StreamColumn* column = candidates[i];
+                size_t columnBytes = GetColumnMemoryUsage(world, column->cx, column->cz);
+                
+                if (streamer->saveDirectory && IsColumnModified(world, column)) {
+                    // Wait for a free job slot rather than dropping the edits
+                    if (streamer->jobsInFlight >= MAX_STREAM_JOBS_IN_FLIGHT) continue;
+                    if (!StartSaveJob(streamer, world, column)) continue;
+                    
+                    // Already out of the world; cy -1 marks it as handled
+                    evicted[evictCount] = (ChunkCoord){ column->cx, -1, column->cz };
+                } else {
+                    evicted[evictCount] = (ChunkCoord){ column->cx, 0, column->cz };
+                }
+                
+                usage = (usage > columnBytes) ? usage - columnBytes : 0;
+                evictCount++;
+            }
+            free(candidates);
+            
+            for (int i = 0; i < evictCount; i++) {
+                if (evicted[i].cy < 0) continue;
+                
+                for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+                    UnloadChunk(world, evicted[i].cx, cy, evicted[i].cz);
+                }
+                RemoveStreamColumn(streamer, evicted[i].cx, evicted[i].cz);
+            }
+            streamer->stats.evictedColumns = evictCount;
+        }
+    }
+    
+    streamer->stats.memoryUsage = usage;
+}
+
+// Create a streamer that keeps the columns within radius of the player loaded
+// (saveDirectory, if given, must outlive the streamer)
+WorldStreamer* CreateWorldStreamer(JobSystem* jobs, unsigned int seed, int radius, size_t memoryBudget,
+                                   const char* saveDirectory) {
+    if (!jobs) return NULL;
+    
+    WorldStreamer* streamer = (WorldStreamer*)malloc(sizeof(WorldStreamer));
+    
+    if (streamer) {
+        streamer->capacity = STREAMER_INITIAL_CAPACITY;
+        streamer->columnCount = 0;
+        streamer->slots = (StreamColumn*)calloc(streamer->capacity, sizeof(StreamColumn));
+        
+        if (!streamer->slots || !InitJobQueue(&streamer->completedJobs, MAX_STREAM_JOBS_IN_FLIGHT)) {
+            free(streamer->slots);
+            free(streamer);
+            return NULL;
+        }
+        
+        streamer->queue = (StreamQueue){ NULL, 0, 0 };
+        streamer->jobs = jobs;
+        streamer->jobsInFlight = 0;
+        streamer->seed = seed;
+        streamer->saveDirectory = saveDirectory;
+        streamer->radius = radius;
+        streamer->memoryBudget = memoryBudget;
+        streamer->frame = 0;
+        streamer->stats = (StreamStats){ 0 };
+    }
+    
+    return streamer;
+}
+
+// Free the streamer once pending saves are on disk. Columns finished in the
+// meantime go into world (they are dropped if it is NULL); the world keeps
+// the columns that are loaded.
+void DestroyWorldStreamer(WorldStreamer* streamer, World* world) {
+    if (streamer) {
+        // Wait for the workers to hand back every job that references the streamer
+        while (streamer->jobsInFlight > 0) {
+            CollectStreamJobs(streamer, world);
+            if (streamer->jobsInFlight > 0) sched_yield();
+        }
+        
+        free(streamer->slots);
+        free(streamer->queue.items);
+        FreeJobQueue(&streamer->completedJobs);
+        free(streamer);
+    }
+}
+
+// Insert finished columns, request the missing columns around position
+// (nearest and most directly ahead first) and evict far columns over the
+// memory budget. Never waits for the workers.
+void UpdateWorldStreamer(WorldStreamer* streamer, World* world, Vector3 position, Vector3 forward) {
+    if (!streamer || !world) return;
+    
+    PROFILE_BEGIN("UpdateWorldStreamer");
+    streamer->frame++;
+    CollectStreamJobs(streamer, world);
+    
+    int centerX = BlockToChunkCoord((int)floorf(position.x));
+    int centerZ = BlockToChunkCoord((int)floorf(position.z));
+    
+    // Horizontal view direction
+    float forwardLength = sqrtf(forward.x * forward.x + forward.z * forward.z);
+    float forwardX = (forwardLength > 0.0f) ? forward.x / forwardLength : 0.0f;
+    float forwardZ = (forwardLength > 0.0f) ? forward.z / forwardLength : 0.0f;
+    
+    int radius = streamer->radius;
+    streamer->queue.count = 0;
+    streamer->stats.loadedColumns = 0;
+    streamer->stats.generatingColumns = 0;
+    
+    for (int dx = -radius; dx <= radius; dx++) {
+        for (int dz = -radius; dz <= radius; dz++) {
+            if (dx * dx + dz * dz > radius * radius) continue;
+            
+            int cx = centerX + dx;
+            int cz = centerZ + dz;
+            StreamColumn* column = GetStreamColumn(streamer, cx, cz);
+            
+            // Columns that are already in the world (generated at startup or
+            // edited into existence) only need to be tracked
+            if (!column && IsColumnInWorld(world, cx, cz)) {
+                column = AddStreamColumn(streamer, cx, cz, COLUMN_LOADED);
+                if (column) column->chunkCount = CountColumnChunks(world, cx, cz);
+            }
+            
+            // Columns still being saved are requested again once they are on disk
+            if (column) {
+                column->lastUsed = streamer->frame;
+                if (column->state == COLUMN_LOADED) {
+                    streamer->stats.loadedColumns++;
+                } else if (column->state == COLUMN_GENERATING) {
+                    streamer->stats.generatingColumns++;
+                }
+                continue;
+            }
+            
+            float distance = sqrtf((float)(dx * dx + dz * dz));
+            float facing = (distance > 0.0f) ? (dx * forwardX + dz * forwardZ) / distance : 1.0f;
+            float priority = distance * (1.0f - STREAM_VIEW_BIAS * facing);
+            PushStreamRequest(&streamer->queue, (StreamRequest){ cx, cz, priority });
+        }
+    }
+    
+    // Start jobs for the most urgent columns while there is room on the workers
+    StreamRequest request;
+    while (streamer->jobsInFlight < MAX_STREAM_JOBS_IN_FLIGHT && PopStreamRequest(&streamer->queue, &request)) {
+        if (!StartStreamJob(streamer, world, request.cx, request.cz)) break;
+        streamer->stats.generatingColumns++;
+    }
+    streamer->stats.pendingColumns = streamer->queue.count;
+    
+    EvictStreamColumns(streamer, world);
+    PROFILE_END();
+}
@@ -0,0 +1,84 @@
+#ifndef STREAMING_H
+#define STREAMING_H
+
+#include "raylib.h"
+#include "voxel.h"
+#include "jobs.h"
+
+// Radius (in chunk columns) kept loaded around the player
+#define STREAM_RADIUS 5
+
+// Default upper bound on chunk storage before far columns are evicted
+#define STREAM_MEMORY_BUDGET (16 * 1024 * 1024)
+
+// Maximum number of column generation jobs running on the workers at once
+#define MAX_STREAM_JOBS_IN_FLIGHT 16
+
+// Maximum number of columns evicted in one update (keeps frame times flat)
+#define MAX_STREAM_EVICTIONS_PER_FRAME 32
+
+// State of a column known to the streamer
+typedef enum {
+    COLUMN_GENERATING,    // A job is loading or generating the column
+    COLUMN_LOADED,        // The column's chunks are in the world
+    COLUMN_SAVING         // Evicted; a job is writing the column to disk
+} ColumnState;
+
+// A chunk column (every chunk at cx, cz) tracked by the streamer
+typedef struct {
+    int cx, cz;           // Column coordinates
+    bool used;            // Slot holds a column
+    ColumnState state;    // Where the column is in its lifetime
+    unsigned long lastUsed; // Last update in which the column was within the radius
+    int chunkCount;       // Chunks the column had when it was loaded
+} StreamColumn;
+
+// A column waiting to be generated; lower priority values are served first
+typedef struct {
+    int cx, cz;
+    float priority;
+} StreamRequest;
+
+// Binary min-heap of stream requests
+typedef struct {
+    StreamRequest* items;
+    int count;
+    int capacity;
+} StreamQueue;
+
+// Per-update streaming counters
+typedef struct {
+    int loadedColumns;    // Columns resident in the world
+    int pendingColumns;   // Columns in the radius still waiting for a job
+    int generatingColumns; // Columns being generated on the workers
+    int evictedColumns;   // Columns evicted in the last update
+    int savingColumns;    // Evicted columns still being written to disk
+    size_t memoryUsage;   // Bytes of chunk storage after the last update
+} StreamStats;
+
+// Streams chunk columns in and out of a world around a moving point
+typedef struct {
+    StreamColumn* slots;        // Hash map of known columns (open addressing)
+    int capacity;               // Number of slots (always a power of two)
+    int columnCount;            // Number of used slots
+    StreamQueue queue;          // Missing columns ordered by priority
+    
+    JobSystem* jobs;            // Worker pool that generates columns
+    JobQueue completedJobs;     // Finished columns waiting to be inserted
+    int jobsInFlight;           // Jobs submitted but not yet collected
+    
+    unsigned int seed;          // World seed passed to the generator
+    const char* saveDirectory;  // Region file directory (NULL disables saving and loading)
+    int radius;                 // Columns within this radius are kept loaded
+    size_t memoryBudget;        // Evict far columns while usage is above this
+    unsigned long frame;        // Update counter used as the LRU clock
+    StreamStats stats;          // Counters from the last update
+} WorldStreamer;
+
+// Function prototypes
+WorldStreamer* CreateWorldStreamer(JobSystem* jobs, unsigned int seed, int radius, size_t memoryBudget,
+                                   const char* saveDirectory);
+void DestroyWorldStreamer(WorldStreamer* streamer, World* world);
+void UpdateWorldStreamer(WorldStreamer* streamer, World* world, Vector3 position, Vector3 forward);
+
+#endif // STREAMING_H
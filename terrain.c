@@ -1,13 +1,12 @@
 #include "terrain.h"
+#include "noise.h"
+#include "profiler.h"
 #include <stdlib.h>
 #include <math.h>
-#include <time.h>
 
 // Pseudo-random hash function for noise generation
-static int Hash(int x, int z) {
-    int hash = x * 73856093 ^ z * 19349663;
-    hash = hash % 100000;
-    return hash;
+static int Hash(int x, int z, unsigned int seed) {
+    return NoiseHash(x, z, seed);
 }
 
 // Linear interpolation helper
@@ -21,7 +20,7 @@ float SmoothFade(float t) {
 }
 
 // Generate 2D noise similar to Perlin noise (simplified implementation)
-float GenerateNoise2D(float x, float z, float scale) {
+float GenerateNoise2DSeeded(float x, float z, float scale, unsigned int seed) {
     // Scale the coordinates
     x *= scale;
     z *= scale;
@@ -41,10 +40,10 @@ float GenerateNoise2D(float x, float z, float scale) {
     float sz_fade = SmoothFade(sz);
     
     // Generate random values at the corners of the cell
-    float n00 = (float)Hash(x0, z0) / 100000.0f;
-    float n10 = (float)Hash(x1, z0) / 100000.0f;
-    float n01 = (float)Hash(x0, z1) / 100000.0f;
-    float n11 = (float)Hash(x1, z1) / 100000.0f;
+    float n00 = (float)Hash(x0, z0, seed) / 100000.0f;
+    float n10 = (float)Hash(x1, z0, seed) / 100000.0f;
+    float n01 = (float)Hash(x0, z1, seed) / 100000.0f;
+    float n11 = (float)Hash(x1, z1, seed) / 100000.0f;
     
     // Bilinear interpolation
     float nx0 = Interpolate(n00, n10, sx_fade);
@@ -55,116 +54,162 @@ float GenerateNoise2D(float x, float z, float scale) {
     return 2.0f * nxz - 1.0f;
 }
 
-// Generate a height map for the terrain
-void GenerateHeightMap(World* world, float* heightMap) {
-    // Seed random number generator
-    srand((unsigned int)time(NULL));
-    
-    // Generate primary noise for height
-    for (int x = 0; x < WORLD_SIZE_X; x++) {
-        for (int z = 0; z < WORLD_SIZE_Z; z++) {
-            int idx = x + z * WORLD_SIZE_X;
-            
-            // Base terrain using primary noise
-            float noise = GenerateNoise2D((float)x, (float)z, NOISE_SCALE);
-            
-            // Add some smaller scale noise for detail
-            noise += 0.5f * GenerateNoise2D((float)x, (float)z, NOISE_SCALE * 2.0f);
-            noise += 0.25f * GenerateNoise2D((float)x, (float)z, NOISE_SCALE * 4.0f);
-            
-            // Normalize and scale
-            noise = (noise + 1.0f) * 0.5f; // Map from [-1,1] to [0,1]
-            
-            // Convert to height value
-            heightMap[idx] = noise * TERRAIN_HEIGHT_SCALE + TERRAIN_HEIGHT_OFFSET;
-        }
+// Generate 2D noise for the default seed
+float GenerateNoise2D(float x, float z, float scale) {
+    return GenerateNoise2DSeeded(x, z, scale, DEFAULT_WORLD_SEED);
+}
+
+// Generate a height map for the sizeX x sizeZ columns starting at (startX, startZ)
+void GenerateHeightMap(float* heightMap, int startX, int startZ, int sizeX, int sizeZ, unsigned int seed) {
+    // Generate three octaves of noise a whole row at a time
+    for (int z = 0; z < sizeZ; z++) {
+        GenerateHeightRow(&heightMap[z * sizeX], sizeX, startX, startZ + z, seed);
     }
 }
 
-// Generate the terrain based on the height map
-void GenerateTerrain(World* world) {
-    if (!world) return;
+// Generate one column of chunks. Every block is a function of the seed and its
+// own position, so columns can be generated independently and in any order.
+bool GenerateChunkColumn(int cx, int cz, unsigned int seed, Chunk* chunks[WORLD_CHUNKS_Y]) {
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        chunks[cy] = NULL;
+    }
     
-    // Create height map
-    float* heightMap = (float*)malloc(WORLD_SIZE_X * WORLD_SIZE_Z * sizeof(float));
-    if (!heightMap) return;
+    BlockId* blocks = (BlockId*)malloc((size_t)WORLD_CHUNKS_Y * CHUNK_VOLUME);
+    if (!blocks) return false;
     
-    // Generate the height map
-    GenerateHeightMap(world, heightMap);
+    int startX = cx * CHUNK_SIZE;
+    int startZ = cz * CHUNK_SIZE;
     
-    // Secondary noise map for sand patches
-    float* sandNoise = (float*)malloc(WORLD_SIZE_X * WORLD_SIZE_Z * sizeof(float));
-    if (!sandNoise) {
-        free(heightMap);
-        return;
-    }
+    // Height map for the column
+    float heightMap[CHUNK_SIZE * CHUNK_SIZE];
+    GenerateHeightMap(heightMap, startX, startZ, CHUNK_SIZE, CHUNK_SIZE, seed);
     
-    // Generate sand distribution noise
-    for (int x = 0; x < WORLD_SIZE_X; x++) {
-        for (int z = 0; z < WORLD_SIZE_Z; z++) {
-            int idx = x + z * WORLD_SIZE_X;
-            sandNoise[idx] = GenerateNoise2D((float)x * 2.5f, (float)z * 2.5f, NOISE_SCALE * 3.0f);
-            // Normalize to [0,1]
-            sandNoise[idx] = (sandNoise[idx] + 1.0f) * 0.5f;
+    // Secondary noise map for sand patches
+    float sandNoise[CHUNK_SIZE * CHUNK_SIZE];
+    for (int z = 0; z < CHUNK_SIZE; z++) {
+        float* row = &sandNoise[z * CHUNK_SIZE];
+        GenerateNoise2DRow(row, CHUNK_SIZE, startX, startZ + z, 2.5f, NOISE_SCALE * 3.0f, seed);
+        
+        // Normalize to [0,1]
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            row[x] = (row[x] + 1.0f) * 0.5f;
         }
     }
     
-    // Generate blocks based on height map
-    for (int x = 0; x < WORLD_SIZE_X; x++) {
-        for (int z = 0; z < WORLD_SIZE_Z; z++) {
-            int idx = x + z * WORLD_SIZE_X;
-            float height = heightMap[idx];
-            int intHeight = (int)floorf(height);
+    // Generate blocks based on height map, with jello filling the gap up to WATER_LEVEL
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            int idx = x + z * CHUNK_SIZE;
+            int intHeight = (int)floorf(heightMap[idx]);
+            
+            bool sandPatch = sandNoise[idx] > BEACH_NOISE_THRESHOLD;
             
-            // Set blocks from bottom up to the height
             for (int y = 0; y < WORLD_SIZE_Y; y++) {
-                // Empty above terrain height
+                BlockId block;
+                
                 if (y > intHeight) {
-                    SetBlock(world, x, y, z, BLOCK_EMPTY);
-                }
-                // Surface layer
-                else if (y == intHeight) {
-                    // Determine block type based on height and secondary noise
-                    if (y < SAND_HEIGHT_THRESHOLD || sandNoise[idx] > BEACH_NOISE_THRESHOLD) {
-                        SetBlock(world, x, y, z, BLOCK_SAND);
-                    } else {
-                        SetBlock(world, x, y, z, BLOCK_GRASS);
-                    }
-                }
-                // Underground (1-3 blocks deep is still surface material, deeper is stone)
-                else if (y >= intHeight - 3) {
-                    if (y < SAND_HEIGHT_THRESHOLD || sandNoise[idx] > BEACH_NOISE_THRESHOLD) {
-                        SetBlock(world, x, y, z, BLOCK_SAND);
-                    } else {
-                        SetBlock(world, x, y, z, BLOCK_GRASS);
-                    }
-                }
-                // Deep underground
-                else {
-                    SetBlock(world, x, y, z, BLOCK_STONE);
+                    block = (y <= WATER_LEVEL) ? BLOCK_JELLO : BLOCK_EMPTY;
+                } else if (y >= intHeight - 3) {
+                    // Surface layer (1-3 blocks deep is still surface material)
+                    block = (y < SAND_HEIGHT_THRESHOLD || sandPatch) ? BLOCK_SAND : BLOCK_GRASS;
+                } else {
+                    block = BLOCK_STONE;
                 }
+                
+                blocks[(y >> CHUNK_SHIFT) * CHUNK_VOLUME + CHUNK_INDEX(x, y & CHUNK_MASK, z)] = block;
             }
         }
     }
     
-    // Add jello at or below WATER_LEVEL
-    for (int x = 0; x < WORLD_SIZE_X; x++) {
-        for (int z = 0; z < WORLD_SIZE_Z; z++) {
-            int idx = x + z * WORLD_SIZE_X;
-            float height = heightMap[idx];
-            int intHeight = (int)floorf(height);
-            
-            // Add jello from terrain height up to WATER_LEVEL
-            for (int y = intHeight + 1; y <= WATER_LEVEL; y++) {
-                // Only replace empty blocks with jello
-                if (GetBlock(world, x, y, z) == BLOCK_EMPTY) {
-                    SetBlock(world, x, y, z, BLOCK_JELLO);
-                }
+    // Pack each chunk of the column with the smallest palette that fits
+    bool ok = true;
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        const BlockId* chunkBlocks = &blocks[cy * CHUNK_VOLUME];
+        chunks[cy] = CreateChunkFromBlocks(cx, cy, cz, chunkBlocks);
+        
+        // NULL is only expected for chunks with nothing in them
+        if (!chunks[cy]) {
+            for (int i = 0; i < CHUNK_VOLUME && ok; i++) {
+                if (chunkBlocks[i] != BLOCK_EMPTY) ok = false;
+            }
+        }
+    }
+    
+    free(blocks);
+    
+    if (!ok) {
+        for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+            FreeChunk(chunks[cy]);
+            chunks[cy] = NULL;
+        }
+    }
+    
+    return ok;
+}
+
+// One chunk column generated on a worker thread
+typedef struct {
+    int cx, cz;
+    unsigned int seed;
+    Chunk* chunks[WORLD_CHUNKS_Y];
+    bool ok;
+} TerrainColumnJob;
+
+static void RunTerrainColumnJob(void* data) {
+    TerrainColumnJob* job = (TerrainColumnJob*)data;
+    
+    PROFILE_BEGIN("GenerateColumn");
+    job->ok = GenerateChunkColumn(job->cx, job->cz, job->seed, job->chunks);
+    PROFILE_END();
+}
+
+// Generate the starting area of the world from a seed. Columns are generated
+// in parallel when a job system is given (NULL runs them on this thread); the
+// chunks are inserted afterwards in a fixed order, so the result does not
+// depend on the number of threads.
+void GenerateTerrainSeeded(World* world, unsigned int seed, JobSystem* jobs) {
+    if (!world) return;
+    
+    world->seed = seed;
+    
+    int columnsX = WORLD_SIZE_X / CHUNK_SIZE;
+    int columnsZ = WORLD_SIZE_Z / CHUNK_SIZE;
+    int columnCount = columnsX * columnsZ;
+    
+    TerrainColumnJob* columns = (TerrainColumnJob*)malloc(columnCount * sizeof(TerrainColumnJob));
+    if (!columns) return;
+    
+    PROFILE_BEGIN("GenerateTerrain");
+    
+    for (int i = 0; i < columnCount; i++) {
+        TerrainColumnJob* job = &columns[i];
+        job->cx = i % columnsX;
+        job->cz = i / columnsX;
+        job->seed = seed;
+        
+        if (!jobs || !SubmitJob(jobs, RunTerrainColumnJob, job)) {
+            RunTerrainColumnJob(job);
+        }
+    }
+    
+    if (jobs) {
+        WaitForJobs(jobs);
+    }
+    
+    for (int i = 0; i < columnCount; i++) {
+        for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+            Chunk* chunk = columns[i].chunks[cy];
+            if (chunk && !InsertChunk(world, chunk)) {
+                FreeChunk(chunk);
             }
         }
     }
     
-    // Cleanup
-    free(heightMap);
-    free(sandNoise);
-}
\ No newline at end of file
+    free(columns);
+    PROFILE_END();
+}
+
+// Generate the terrain for the default seed on the calling thread
+void GenerateTerrain(World* world) {
+    GenerateTerrainSeeded(world, DEFAULT_WORLD_SEED, NULL);
+}
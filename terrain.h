@@ -2,6 +2,7 @@
 #define TERRAIN_H
 
 #include "voxel.h"
+#include "jobs.h"
 
 // Noise generation parameters
 #define NOISE_SCALE 0.1f        // Controls the "zoom" of the noise pattern
@@ -15,13 +16,19 @@
 // Water level
 #define WATER_LEVEL 16  // Height at which water will be placed
 
+// Seed used when none is given (reproduces the original terrain)
+#define DEFAULT_WORLD_SEED 0u
+
 // Function prototypes for noise generation
 float GenerateNoise2D(float x, float z, float scale);
+float GenerateNoise2DSeeded(float x, float z, float scale, unsigned int seed);
 float Interpolate(float a, float b, float t);
 float SmoothFade(float t); // For smooth interpolation
 
 // Function prototypes for terrain generation
-void GenerateHeightMap(World* world, float* heightMap);
+void GenerateHeightMap(float* heightMap, int startX, int startZ, int sizeX, int sizeZ, unsigned int seed);
+bool GenerateChunkColumn(int cx, int cz, unsigned int seed, Chunk* chunks[WORLD_CHUNKS_Y]);
+void GenerateTerrainSeeded(World* world, unsigned int seed, JobSystem* jobs);
 void GenerateTerrain(World* world);
 
 #endif // TERRAIN_H
\ No newline at end of file
@@ -1,5 +1,93 @@
 #include "voxel.h"
+#include "mesher.h"
+#include "jobs.h"
+#include "frustum.h"
+#include "terrain.h"
+#include "noise.h"
+#include "streaming.h"
+#include "raycast.h"
+#include "entity.h"
+#include "broadphase.h"
+#include "visibility.h"
+#include "profiler.h"
+#include "renderer.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+
+// Scratch directories for the persistence tests
+#define TEST_SAVE_DIRECTORY "test_world_save"
+#define TEST_COPY_DIRECTORY "test_world_copy"
+
+// Delete a saved world directory and the files in it
+static void RemoveSavedWorld(const char* directory) {
+    DIR* dir = opendir(directory);
+    if (!dir) return;
+    
+    struct dirent* entry;
+    char path[512];
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        remove(path);
+    }
+    closedir(dir);
+    remove(directory);
+}
+
+// Block-by-block reference for CheckCollision: any solid block whose box
+// overlaps or touches the given box
+static bool CheckCollisionPerBlock(World* world, BoundingBox box) {
+    for (int x = (int)floorf(box.min.x); x <= (int)floorf(box.max.x) + 1; x++) {
+        for (int y = (int)floorf(box.min.y); y <= (int)floorf(box.max.y) + 1; y++) {
+            for (int z = (int)floorf(box.min.z); z <= (int)floorf(box.max.z) + 1; z++) {
+                BlockType type = GetBlock(world, x, y, z);
+                if (type == BLOCK_EMPTY || type == BLOCK_JELLO) continue;
+                if (CheckCollisionBoxes(box, GetBlockBoundingBox(x, y, z))) return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+// Connectivity callback for the occlusion test: flood fill a fresh snapshot
+static uint16_t GetWorldChunkConnectivity(void* context, int cx, int cy, int cz) {
+    World* world = (World*)context;
+    if (!GetChunk(world, cx, cy, cz)) return CHUNK_ALL_FACES_CONNECTED;
+    
+    ChunkSnapshot snapshot;
+    CreateChunkSnapshot(world, cx, cy, cz, &snapshot);
+    return GetChunkConnectivity(&snapshot);
+}
+
+// Job used by the job system test: mesh a snapshot and count its quads
+static void CountQuadsJob(void* data) {
+    ChunkSnapshot* snapshot = (ChunkSnapshot*)data;
+    ChunkMeshData meshData;
+    
+    if (BuildChunkMesh(snapshot, &meshData)) {
+        snapshot->cx = meshData.quadCount;
+        FreeChunkMeshData(&meshData);
+    }
+}
+
+// Job that records one profiler zone on a worker thread
+static void ProfileZoneJob(void* data) {
+    (void)data;
+    ProfileBegin("WorkerZone");
+    ProfileEnd();
+}
+
+// Find the stats of a zone by name (NULL if it was not recorded)
+static const ProfileZoneStats* FindProfileZone(const ProfileZoneStats* zones, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(zones[i].name, name) == 0) return &zones[i];
+    }
+    return NULL;
+}
 
 int main() {
     // Create a new world
@@ -52,6 +140,946 @@ int main() {
     printf("Collision with box2: %s (expect no collision)\n", 
            CheckCollision(world, playerBox2) ? "Yes" : "No");
     
+    // Swept movement stops at the first solid block, however far the move
+    BoundingBox fallingBox = { { 10.2f, 20.0f, 10.2f }, { 10.8f, 21.8f, 10.8f } };
+    printf("Fall stopped at y: %.3f (expect 12.001)\n",
+           fallingBox.min.y + SweepBoxAxis(world, fallingBox, 1, -15.0f));
+    BoundingBox fastBox = { { 5.0f, 10.2f, 10.2f }, { 5.6f, 10.8f, 10.8f } };
+    printf("Fast move stopped at x: %.3f (expect 9.999)\n",
+           fastBox.max.x + SweepBoxAxis(world, fastBox, 0, 20.0f));
+    printf("Unblocked move: %.3f (expect -20.000)\n", SweepBoxAxis(world, fastBox, 2, -20.0f));
+    
+    // Test raycasts: first block hit, entry face and distance
+    printf("\nTesting raycasts...\n");
+    RaycastHit rayHit = RaycastWorld(world, (Ray){ { 5.5f, 10.5f, 10.5f }, { 1.0f, 0.0f, 0.0f } }, 20.0f, 0);
+    printf("Ray along +X hits (%d,%d,%d) normal (%d,%d,%d) at %.2f (expect (10,10,10) normal (-1,0,0) at 4.50)\n",
+           rayHit.x, rayHit.y, rayHit.z, rayHit.normalX, rayHit.normalY, rayHit.normalZ, rayHit.distance);
+    rayHit = RaycastWorld(world, (Ray){ { 10.5f, 40.5f, 10.5f }, { 0.0f, -2.0f, 0.0f } }, 64.0f, 0);
+    printf("Ray down hits block %d normal Y %d at %.2f (expect %d, 1 at 28.50)\n",
+           rayHit.block, rayHit.normalY, rayHit.distance, BLOCK_SAND);
+    SetBlock(world, 8, 10, 10, BLOCK_JELLO);
+    rayHit = RaycastWorld(world, (Ray){ { 5.5f, 10.5f, 10.5f }, { 1.0f, 0.0f, 0.0f } }, 20.0f, 0);
+    printf("Ray stops at jello: x %d (expect 8)\n", rayHit.x);
+    rayHit = RaycastWorld(world, (Ray){ { 5.5f, 10.5f, 10.5f }, { 1.0f, 0.0f, 0.0f } }, 20.0f, RAYCAST_IGNORE_JELLO);
+    printf("Ray ignoring jello: x %d (expect 10)\n", rayHit.x);
+    SetBlock(world, 8, 10, 10, BLOCK_EMPTY);
+    rayHit = RaycastWorld(world, (Ray){ { 5.5f, 10.5f, 10.5f }, { 1.0f, 0.0f, 0.0f } }, 4.0f, 0);
+    printf("Ray beyond max distance hit: %s (expect No)\n", rayHit.hit ? "Yes" : "No");
+    
+    // Test the entity store: ids survive removals and bodies fall onto the terrain
+    printf("\nTesting entities...\n");
+    EntityStore* entities = CreateEntityStore(3);
+    Vector3 bodySize = { 0.6f, 1.8f, 0.6f };
+    int removedId = CreateEntity(entities, (Vector3){ 40.5f, 30.0f, 40.5f }, bodySize);
+    int fallerId = CreateEntity(entities, (Vector3){ 10.5f, 30.0f, 10.5f }, bodySize);
+    int walkerId = CreateEntity(entities, (Vector3){ 20.5f, 30.0f, 20.5f }, bodySize);
+    printf("Entity beyond capacity: %d (expect -1)\n", CreateEntity(entities, (Vector3){ 0 }, bodySize));
+    RemoveEntity(entities, removedId);
+    printf("Walker after removal: index %d at x %.1f (expect 0 at 20.5)\n",
+           GetEntityIndex(entities, walkerId), GetEntityPosition(entities, walkerId).x);
+    printf("Removed id reused: %s (expect Yes)\n",
+           CreateEntity(entities, (Vector3){ 40.5f, 30.0f, 40.5f }, bodySize) == removedId ? "Yes" : "No");
+    
+    // The same walker alone in a store must end up in the same place
+    EntityStore* soloEntities = CreateEntityStore(1);
+    int soloId = CreateEntity(soloEntities, (Vector3){ 20.5f, 30.0f, 20.5f }, bodySize);
+    SetEntityInput(entities, walkerId, 0.1f, 0.05f, ENTITY_INPUT_JUMP);
+    SetEntityInput(soloEntities, soloId, 0.1f, 0.05f, ENTITY_INPUT_JUMP);
+    for (int tick = 0; tick < 240; tick++) {
+        StepEntities(entities, world);
+        StepEntities(soloEntities, world);
+    }
+    Vector3 faller = GetEntityPosition(entities, fallerId);
+    printf("Faller rests at y %.2f on ground: %s (expect 12.00, Yes)\n", faller.y,
+           (GetEntityFlags(entities, fallerId) & ENTITY_ON_GROUND) ? "Yes" : "No");
+    Vector3 walker = GetEntityPosition(entities, walkerId);
+    Vector3 solo = GetEntityPosition(soloEntities, soloId);
+    printf("Walker moved %.1f blocks, same alone: %s (expect > 0, Yes)\n", walker.x - 20.5f,
+           (walker.x == solo.x && walker.y == solo.y && walker.z == solo.z) ? "Yes" : "No");
+    printf("Ticks run for 0.11 s: %d (expect 6)\n", UpdateEntities(entities, world, 0.11f));
+    DestroyEntityStore(soloEntities);
+    DestroyEntityStore(entities);
+    
+    // Test the broadphase against brute force, with some boxes larger than a cell
+    printf("\nTesting broadphase...\n");
+    enum { TEST_BOXES = 1500 };
+    static BoundingBox testBoxes[TEST_BOXES];
+    Broadphase* broadphase = CreateBroadphase(TEST_BOXES, 2.0f);
+    srand(77);
+    for (int i = 0; i < TEST_BOXES; i++) {
+        float x = (float)(rand() % 6000) / 100.0f - 30.0f;
+        float y = (float)(rand() % 6400) / 100.0f;
+        float z = (float)(rand() % 6000) / 100.0f - 30.0f;
+        float size = (i % 100 == 0) ? 5.0f : 0.3f + (float)(rand() % 100) / 100.0f;
+        testBoxes[i] = (BoundingBox){ { x, y, z }, { x + size, y + size * 2.0f, z + size } };
+        AddBroadphaseBox(broadphase, i, testBoxes[i]);
+    }
+    int brutePairs = 0;
+    for (int i = 0; i < TEST_BOXES; i++) {
+        for (int j = i + 1; j < TEST_BOXES; j++) {
+            brutePairs += CheckCollisionBoxes(testBoxes[i], testBoxes[j]);
+        }
+    }
+    static BroadphasePair testPairs[TEST_BOXES * 8];
+    int pairCount = FindBroadphasePairs(broadphase, testPairs, TEST_BOXES * 8);
+    int wrongPairs = 0;
+    for (int i = 0; i < pairCount; i++) {
+        wrongPairs += !CheckCollisionBoxes(testBoxes[testPairs[i].a], testBoxes[testPairs[i].b]);
+    }
+    printf("Pairs: %d, not overlapping: %d (expect %d, 0)\n", pairCount, wrongPairs, brutePairs);
+    int queryMismatches = 0;
+    static int queryIds[TEST_BOXES];
+    for (int q = 0; q < 200; q++) {
+        Vector3 center = { (float)(q % 20) * 3.0f - 30.0f, (float)(q % 13) * 5.0f, (float)(q / 20) * 6.0f - 30.0f };
+        float radius = 0.5f + (float)(q % 7);
+        int found = QueryBroadphaseRadius(broadphase, center, radius, queryIds, TEST_BOXES);
+        int expected = 0;
+        for (int i = 0; i < TEST_BOXES; i++) {
+            Vector3 closest = {
+                fmaxf(testBoxes[i].min.x, fminf(center.x, testBoxes[i].max.x)),
+                fmaxf(testBoxes[i].min.y, fminf(center.y, testBoxes[i].max.y)),
+                fmaxf(testBoxes[i].min.z, fminf(center.z, testBoxes[i].max.z))
+            };
+            float dx = closest.x - center.x, dy = closest.y - center.y, dz = closest.z - center.z;
+            expected += (dx * dx + dy * dy + dz * dz <= radius * radius);
+        }
+        BoundingBox queryBox = { { center.x - radius, center.y, center.z - radius },
+                                 { center.x + radius, center.y + 2.0f, center.z + radius } };
+        int boxFound = QueryBroadphaseBox(broadphase, queryBox, queryIds, TEST_BOXES);
+        int boxExpected = 0;
+        for (int i = 0; i < TEST_BOXES; i++) {
+            boxExpected += CheckCollisionBoxes(testBoxes[i], queryBox);
+        }
+        queryMismatches += (found != expected) + (boxFound != boxExpected);
+    }
+    printf("Radius and box query mismatches: %d (expect 0)\n", queryMismatches);
+    DestroyBroadphase(broadphase);
+    
+    // Two bodies dropped onto the same spot are pushed apart
+    EntityStore* crowd = CreateEntityStore(2);
+    int first = CreateEntity(crowd, (Vector3){ 10.5f, 20.0f, 10.5f }, bodySize);
+    int second = CreateEntity(crowd, (Vector3){ 10.5f, 20.0f, 10.5f }, bodySize);
+    for (int tick = 0; tick < 120; tick++) {
+        StepEntities(crowd, world);
+    }
+    Vector3 firstPosition = GetEntityPosition(crowd, first);
+    Vector3 secondPosition = GetEntityPosition(crowd, second);
+    printf("Stacked bodies apart after 2 s: %.2f blocks (expect 0.60)\n",
+           fmaxf(fabsf(secondPosition.x - firstPosition.x), fabsf(secondPosition.z - firstPosition.z)));
+    DestroyEntityStore(crowd);
+    
+    // Test chunked storage
+    printf("\nTesting chunked storage...\n");
+    int chunksBefore = world->chunkCount;
+    SetBlock(world, 5000, 20, -7000, BLOCK_STONE);
+    printf("Block at (5000,20,-7000): %d (expect %d)\n",
+           GetBlock(world, 5000, 20, -7000), BLOCK_STONE);
+    printf("Block at (-1,20,-7000): %d (expect %d)\n",
+           GetBlock(world, -1, 20, -7000), BLOCK_EMPTY);
+    printf("Chunks after far write: %d (expect %d)\n",
+           world->chunkCount, chunksBefore + 1);
+    SetBlock(world, 5000, 20, -7000, BLOCK_EMPTY);
+    printf("Chunks after clearing far block: %d (expect %d)\n",
+           world->chunkCount, chunksBefore);
+    SetBlock(world, 100, 100, 100, BLOCK_STONE);
+    printf("Block above world top: %d (expect %d)\n",
+           GetBlock(world, 100, 100, 100), BLOCK_EMPTY);
+    
+    // Test paletted storage: a chunk filled with one type collapses to a single entry
+    printf("\nTesting paletted storage...\n");
+    World* paletteWorld = CreateWorld();
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                SetBlock(paletteWorld, x, y, z, (y == 3) ? BLOCK_SAND : BLOCK_STONE);
+            }
+        }
+    }
+    Chunk* paletteChunk = GetChunk(paletteWorld, 0, 0, 0);
+    printf("Bits per block once full (compacted, air dropped): %d (expect 1)\n", paletteChunk->bitsPerBlock);
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            SetBlock(paletteWorld, x, 3, z, BLOCK_STONE);
+        }
+    }
+    CompactChunk(paletteChunk);
+    printf("Bits per block when uniform: %d (expect 0)\n", paletteChunk->bitsPerBlock);
+    printf("Block at (7,3,7): %d (expect %d)\n", GetBlock(paletteWorld, 7, 3, 7), BLOCK_STONE);
+    DestroyWorld(paletteWorld);
+    
+    // Test greedy meshing: a 3x1x1 row of stone merges into 6 quads
+    printf("\nTesting greedy meshing...\n");
+    World* meshWorld = CreateWorld();
+    SetBlock(meshWorld, 1, 1, 1, BLOCK_STONE);
+    SetBlock(meshWorld, 2, 1, 1, BLOCK_STONE);
+    SetBlock(meshWorld, 3, 1, 1, BLOCK_STONE);
+    SetBlock(meshWorld, 1, 2, 1, BLOCK_JELLO);
+    ChunkSnapshot snapshot;
+    ChunkMeshData meshData;
+    CreateChunkSnapshot(meshWorld, 0, 0, 0, &snapshot);
+    BuildChunkMesh(&snapshot, &meshData);
+    printf("Opaque vertices: %d (expect %d)\n", meshData.opaque.vertexCount, 6 * 6);
+    printf("Transparent vertices: %d (expect %d)\n", meshData.transparent.vertexCount, 5 * 6);
+    FreeChunkMeshData(&meshData);
+    
+    // Transparent faces sort back to front: a jello staircase seen from one corner
+    for (int i = 0; i < 8; i++) {
+        SetBlock(meshWorld, 4 + i, 4 + (i & 3), 4 + (i >> 1), BLOCK_JELLO);
+    }
+    CreateChunkSnapshot(meshWorld, 0, 0, 0, &snapshot);
+    BuildChunkMesh(&snapshot, &meshData);
+    Vector3 viewPoint = { -3.0f, 9.0f, 14.0f };
+    float vertexSum = 0.0f;
+    for (int i = 0; i < meshData.transparent.vertexCount * 3; i++) vertexSum += meshData.transparent.vertices[i];
+    SortMeshBufferQuads(&meshData.transparent, viewPoint);
+    int outOfOrder = 0;
+    float previousDistance = INFINITY;
+    float sortedSum = 0.0f;
+    for (int q = 0; q < meshData.transparent.vertexCount / VERTICES_PER_QUAD; q++) {
+        const float* v = &meshData.transparent.vertices[q * VERTICES_PER_QUAD * 3];
+        float dx = (v[0] + v[6]) * 0.5f - viewPoint.x;
+        float dy = (v[1] + v[7]) * 0.5f - viewPoint.y;
+        float dz = (v[2] + v[8]) * 0.5f - viewPoint.z;
+        float distance = dx * dx + dy * dy + dz * dz;
+        if (distance > previousDistance) outOfOrder++;
+        previousDistance = distance;
+    }
+    for (int i = 0; i < meshData.transparent.vertexCount * 3; i++) sortedSum += meshData.transparent.vertices[i];
+    printf("Sorted transparent quads out of order: %d, geometry kept: %s (expect 0, Yes)\n",
+           outOfOrder, (sortedSum == vertexSum) ? "Yes" : "No");
+    FreeChunkMeshData(&meshData);
+    for (int i = 0; i < 8; i++) {
+        SetBlock(meshWorld, 4 + i, 4 + (i & 3), 4 + (i >> 1), BLOCK_EMPTY);
+    }
+    
+    // Test level-of-detail snapshots: a lone block fills its whole cell
+    SetBlock(meshWorld, 5, 21, 5, BLOCK_STONE);
+    CreateLodSnapshot(meshWorld, 0, 1, 0, 2, &snapshot);
+    BuildChunkMesh(&snapshot, &meshData);
+    printf("LOD 2 block: %d vertices from (%.0f,%.0f,%.0f) to (%.0f,%.0f,%.0f) (expect 36 from (4,20,4) to (8,24,8))\n",
+           meshData.opaque.vertexCount, meshData.bounds.min.x, meshData.bounds.min.y, meshData.bounds.min.z,
+           meshData.bounds.max.x, meshData.bounds.max.y, meshData.bounds.max.z);
+    FreeChunkMeshData(&meshData);
+    SetBlock(meshWorld, 5, 21, 5, BLOCK_EMPTY);
+    
+    // Coarser levels give generated terrain fewer quads
+    World* lodWorld = CreateWorld();
+    GenerateTerrainSeeded(lodWorld, 42u, NULL);
+    int lodQuads[MAX_LOD_LEVEL + 1] = { 0 };
+    for (int level = 0; level <= MAX_LOD_LEVEL; level++) {
+        for (int cx = 0; cx < WORLD_SIZE_X / CHUNK_SIZE; cx++) {
+            for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+                for (int cz = 0; cz < WORLD_SIZE_Z / CHUNK_SIZE; cz++) {
+                    if (level > 0) {
+                        CreateLodSnapshot(lodWorld, cx, cy, cz, level, &snapshot);
+                    } else {
+                        CreateChunkSnapshot(lodWorld, cx, cy, cz, &snapshot);
+                    }
+                    if (BuildChunkMesh(&snapshot, &meshData)) {
+                        lodQuads[level] += meshData.quadCount;
+                        FreeChunkMeshData(&meshData);
+                    }
+                }
+            }
+        }
+    }
+    printf("Terrain quads per level: %d, %d, %d, %d (expect decreasing)\n",
+           lodQuads[0], lodQuads[1], lodQuads[2], lodQuads[3]);
+    DestroyWorld(lodWorld);
+    
+    // Test dirty tracking: an edit on a chunk border dirties both chunks
+    printf("\nTesting dirty tracking...\n");
+    SetBlock(meshWorld, 16, 1, 1, BLOCK_STONE);
+    ChunkCoord dirtyCoord;
+    while (PopDirtyChunk(meshWorld, &dirtyCoord)) {}
+    SetBlock(meshWorld, 15, 1, 1, BLOCK_SAND);
+    int dirtyCount = 0;
+    while (PopDirtyChunk(meshWorld, &dirtyCoord)) dirtyCount++;
+    printf("Dirty chunks after border edit: %d (expect 2)\n", dirtyCount);
+    SetBlock(meshWorld, 5, 5, 5, BLOCK_STONE);
+    SetBlock(meshWorld, 5, 6, 5, BLOCK_STONE);
+    dirtyCount = 0;
+    while (PopDirtyChunk(meshWorld, &dirtyCoord)) dirtyCount++;
+    printf("Dirty chunks after two interior edits: %d (expect 1)\n", dirtyCount);
+    
+    // Test the job system: mesh the same snapshot on several workers
+    printf("\nTesting job system...\n");
+    JobSystem* jobs = CreateJobSystem(4);
+    ChunkSnapshot jobSnapshots[8];
+    for (int i = 0; i < 8; i++) {
+        CreateChunkSnapshot(meshWorld, 0, 0, 0, &jobSnapshots[i]);
+        SubmitJob(jobs, CountQuadsJob, &jobSnapshots[i]);
+    }
+    WaitForJobs(jobs);
+    CreateChunkSnapshot(meshWorld, 0, 0, 0, &snapshot);
+    BuildChunkMesh(&snapshot, &meshData);
+    int matchingJobs = 0;
+    for (int i = 0; i < 8; i++) {
+        if (jobSnapshots[i].cx == meshData.quadCount) matchingJobs++;
+    }
+    FreeChunkMeshData(&meshData);
+    printf("Jobs matching single-threaded mesh: %d (expect 8)\n", matchingJobs);
+    DestroyJobSystem(jobs);
+    DestroyWorld(meshWorld);
+    
+    // Test frustum culling with a camera looking down -Z
+    printf("\nTesting frustum culling...\n");
+    Camera camera = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, 60.0f, CAMERA_PERSPECTIVE };
+    Frustum frustum = GetCameraFrustum(camera, 4.0f / 3.0f);
+    BoundingBox ahead = { { -1.0f, -1.0f, -11.0f }, { 1.0f, 1.0f, -9.0f } };
+    BoundingBox behind = { { -1.0f, -1.0f, 9.0f }, { 1.0f, 1.0f, 11.0f } };
+    BoundingBox aside = { { 30.0f, -1.0f, -11.0f }, { 32.0f, 1.0f, -9.0f } };
+    printf("Box ahead visible: %s (expect Yes)\n", IsBoxInFrustum(&frustum, ahead) ? "Yes" : "No");
+    printf("Box behind visible: %s (expect No)\n", IsBoxInFrustum(&frustum, behind) ? "Yes" : "No");
+    printf("Box to the side visible: %s (expect No)\n", IsBoxInFrustum(&frustum, aside) ? "Yes" : "No");
+    
+    // Test batch noise against the scalar path (must be bit-identical)
+    printf("\nTesting batch noise (%s kernel)...\n", GetNoiseKernelName());
+    float batchNoise[37];
+    int noiseMismatches = 0;
+    for (int z = -40; z < 40; z += 3) {
+        unsigned int seed = (z < 0) ? DEFAULT_WORLD_SEED : 12345u;
+        GenerateNoise2DRow(batchNoise, 37, z * 5 - 20, z, 2.5f, NOISE_SCALE * 3.0f, seed);
+        for (int i = 0; i < 37; i++) {
+            float x = (float)(z * 5 - 20 + i);
+            if (batchNoise[i] != GenerateNoise2DSeeded(x * 2.5f, (float)z * 2.5f, NOISE_SCALE * 3.0f, seed)) noiseMismatches++;
+        }
+    }
+    printf("Batch noise mismatches: %d (expect 0)\n", noiseMismatches);
+    
+    // Test seeded generation: parallel output must match the single-threaded world
+    printf("\nTesting seeded terrain generation...\n");
+    World* serialWorld = CreateWorld();
+    World* parallelWorld = CreateWorld();
+    World* otherSeedWorld = CreateWorld();
+    JobSystem* terrainJobs = CreateJobSystem(4);
+    GenerateTerrainSeeded(serialWorld, 42u, NULL);
+    GenerateTerrainSeeded(parallelWorld, 42u, terrainJobs);
+    GenerateTerrainSeeded(otherSeedWorld, 43u, terrainJobs);
+    int parallelMismatches = 0;
+    int seedDifferences = 0;
+    for (int x = 0; x < WORLD_SIZE_X; x++) {
+        for (int y = 0; y < WORLD_SIZE_Y; y++) {
+            for (int z = 0; z < WORLD_SIZE_Z; z++) {
+                BlockType block = GetBlock(serialWorld, x, y, z);
+                if (GetBlock(parallelWorld, x, y, z) != block) parallelMismatches++;
+                if (GetBlock(otherSeedWorld, x, y, z) != block) seedDifferences++;
+            }
+        }
+    }
+    printf("Parallel vs single-threaded mismatches: %d (expect 0)\n", parallelMismatches);
+    printf("Different seeds differ: %s (expect Yes)\n", seedDifferences > 0 ? "Yes" : "No");
+    
+    // Test uniform chunks: a solid 3x3x3 block of chunks, a jello chunk
+    // beside it and a stone block behind that
+    printf("\nTesting uniform chunks...\n");
+    World* solidWorld = CreateWorld();
+    for (int x = 0; x < 3 * CHUNK_SIZE; x++) {
+        for (int y = 0; y < 3 * CHUNK_SIZE; y++) {
+            for (int z = 0; z < 3 * CHUNK_SIZE; z++) {
+                SetBlock(solidWorld, x, y, z, BLOCK_STONE);
+                SetBlock(solidWorld, x + 4 * CHUNK_SIZE, y, z, (x < CHUNK_SIZE) ? BLOCK_JELLO : BLOCK_EMPTY);
+            }
+        }
+    }
+    SetBlock(solidWorld, 5 * CHUNK_SIZE, 20, 20, BLOCK_STONE);
+    Chunk* centreChunk = GetChunk(solidWorld, 1, 1, 1);
+    printf("Filled chunk uniform: %s, packed bytes: %d (expect Yes, 0)\n",
+           IsChunkUniform(centreChunk) ? "Yes" : "No", (int)(GetChunkMemoryUsage(centreChunk) - sizeof(Chunk)));
+    
+    ChunkSnapshot uniformSnapshot;
+    ChunkMeshData uniformMesh;
+    CreateChunkSnapshot(solidWorld, 1, 1, 1, &uniformSnapshot);
+    BuildChunkMesh(&uniformSnapshot, &uniformMesh);
+    printf("Enclosed chunk: %s, %d quads (expect Yes, 0)\n",
+           uniformSnapshot.enclosed ? "Yes" : "No", uniformMesh.quadCount);
+    FreeChunkMeshData(&uniformMesh);
+    CreateChunkSnapshot(solidWorld, 0, 0, 0, &uniformSnapshot);
+    BuildChunkMesh(&uniformSnapshot, &uniformMesh);
+    printf("Corner chunk: %s, %d quads (expect No, 3)\n",
+           uniformSnapshot.enclosed ? "Yes" : "No", uniformMesh.quadCount);
+    FreeChunkMeshData(&uniformMesh);
+    
+    SetBlock(solidWorld, 20, 20, 20, BLOCK_EMPTY);
+    CreateChunkSnapshot(solidWorld, 1, 1, 1, &uniformSnapshot);
+    BuildChunkMesh(&uniformSnapshot, &uniformMesh);
+    printf("Chunk with a hole uniform: %s, %d quads (expect No, 6)\n",
+           IsChunkUniform(centreChunk) ? "Yes" : "No", uniformMesh.quadCount);
+    FreeChunkMeshData(&uniformMesh);
+    SetBlock(solidWorld, 20, 20, 20, BLOCK_STONE);
+    printf("Refilled chunk uniform: %s (expect Yes)\n", IsChunkUniform(centreChunk) ? "Yes" : "No");
+    
+    Ray jelloRay = { { 3.5f * CHUNK_SIZE, 20.5f, 20.5f }, { 1.0f, 0.0f, 0.0f } };
+    printf("Ray into jello chunk hits x=%d, ignoring jello x=%d (expect 64, 80)\n",
+           RaycastWorld(solidWorld, jelloRay, 64.0f, 0).x,
+           RaycastWorld(solidWorld, jelloRay, 64.0f, RAYCAST_IGNORE_JELLO).x);
+    
+    // Chunk-at-a-time collision agrees with the block-by-block check, on
+    // generated terrain and on the uniform chunks (half the boxes snapped
+    // to whole blocks, so touching contacts are covered)
+    int collisionMismatches = 0;
+    for (int i = 0; i < 20000; i++) {
+        World* target = (i & 1) ? serialWorld : solidWorld;
+        float size = (float)(rand() % 2000) / 100.0f + 0.1f;
+        Vector3 min = {
+            (float)(rand() % 8000) / 100.0f - 8.0f,
+            (float)(rand() % 8000) / 100.0f - 8.0f,
+            (float)(rand() % 8000) / 100.0f - 8.0f
+        };
+        if (i & 2) {
+            min = (Vector3){ floorf(min.x), floorf(min.y), floorf(min.z) };
+            size = ceilf(size);
+        }
+        BoundingBox box = { min, { min.x + size * 0.5f, min.y + size, min.z + size * 0.5f } };
+        if (CheckCollision(target, box) != CheckCollisionPerBlock(target, box)) collisionMismatches++;
+    }
+    printf("Collision mismatches: %d (expect 0)\n", collisionMismatches);
+    DestroyWorld(solidWorld);
+    
+    // Test chunk occlusion culling: solid ground three chunks deep under a
+    // layer of air chunks
+    printf("\nTesting occlusion culling...\n");
+    World* caveWorld = CreateWorld();
+    for (int x = 0; x < 3 * CHUNK_SIZE; x++) {
+        for (int y = 0; y < 3 * CHUNK_SIZE; y++) {
+            for (int z = 0; z < 3 * CHUNK_SIZE; z++) {
+                SetBlock(caveWorld, x, y, z, BLOCK_STONE);
+            }
+        }
+    }
+    SetBlock(caveWorld, 40, 60, 40, BLOCK_STONE);
+    ChunkSnapshot connectivitySnapshot;
+    CreateChunkSnapshot(caveWorld, 2, 3, 2, &connectivitySnapshot);
+    printf("Air chunk with one block connected: %s (expect Yes)\n",
+           GetChunkConnectivity(&connectivitySnapshot) == CHUNK_ALL_FACES_CONNECTED ? "Yes" : "No");
+    CreateChunkSnapshot(caveWorld, 1, 1, 1, &connectivitySnapshot);
+    printf("Solid chunk connectivity: %d (expect 0)\n", GetChunkConnectivity(&connectivitySnapshot));
+    
+    // A horizontal tunnel along X through chunk (1, 1, 1)
+    for (int x = CHUNK_SIZE; x < 2 * CHUNK_SIZE; x++) {
+        SetBlock(caveWorld, x, 20, 20, BLOCK_EMPTY);
+    }
+    CreateChunkSnapshot(caveWorld, 1, 1, 1, &connectivitySnapshot);
+    uint16_t tunnel = GetChunkConnectivity(&connectivitySnapshot);
+    printf("Tunnel joins -X/+X: %s, +Y/-Y: %s (expect Yes, No)\n",
+           (tunnel & GetFacePairBit(1, 0)) ? "Yes" : "No", (tunnel & GetFacePairBit(2, 3)) ? "Yes" : "No");
+    
+    ChunkVisibility* visibility = CreateChunkVisibility(64);
+    ChunkCoord reachedChunks[64];
+    ChunkBox caveBox = { 0, 0, 0, 2, 3, 2 };
+    Vector3 surfaceCamera = { 24.0f, 56.0f, 24.0f };
+    int reachedCount = FindVisibleChunks(visibility, caveBox, surfaceCamera, NULL,
+                                         GetWorldChunkConnectivity, caveWorld, reachedChunks, 64);
+    printf("Chunks reached from the surface: %d (expect 18)\n", reachedCount);
+    reachedCount = FindVisibleChunks(visibility, caveBox, (Vector3){ 24.0f, 200.0f, 24.0f }, NULL,
+                                     GetWorldChunkConnectivity, caveWorld, reachedChunks, 64);
+    printf("Chunks reached from above the world: %d (expect 18)\n", reachedCount);
+    
+    // A shaft down through chunk (1, 2, 1) lets the search reach the chunk
+    // under it, but no further: the tunnel there runs sideways
+    for (int y = 2 * CHUNK_SIZE; y < 3 * CHUNK_SIZE; y++) {
+        SetBlock(caveWorld, 24, y, 24, BLOCK_EMPTY);
+    }
+    reachedCount = FindVisibleChunks(visibility, caveBox, surfaceCamera, NULL,
+                                     GetWorldChunkConnectivity, caveWorld, reachedChunks, 64);
+    printf("Chunks reached after digging a shaft: %d (expect 19)\n", reachedCount);
+    
+    // From inside the tunnel: the camera's chunk and its six neighbours, and
+    // through the shaft above it the nine chunks of air
+    reachedCount = FindVisibleChunks(visibility, caveBox, (Vector3){ 20.5f, 20.5f, 20.5f }, NULL,
+                                     GetWorldChunkConnectivity, caveWorld, reachedChunks, 64);
+    printf("Chunks reached from the tunnel: %d (expect 16)\n", reachedCount);
+    DestroyChunkVisibility(visibility);
+    DestroyWorld(caveWorld);
+    
+    // Test column face masks: whole-column culling agrees with the per-block check
+    printf("\nTesting column face masks...\n");
+    BlockType editedBlocks[3] = {
+        GetBlock(serialWorld, 20, 30, 20), GetBlock(serialWorld, 20, 31, 20), GetBlock(serialWorld, 21, 5, 20)
+    };
+    SetBlock(serialWorld, 20, 30, 20, BLOCK_JELLO);
+    SetBlock(serialWorld, 20, 31, 20, BLOCK_STONE);
+    SetBlock(serialWorld, 21, 5, 20, BLOCK_EMPTY);
+    int faceMaskMismatches = 0;
+    for (int x = -1; x <= WORLD_SIZE_X; x++) {
+        for (int z = -1; z <= WORLD_SIZE_Z; z++) {
+            uint64_t faceMasks[6];
+            GetColumnFaceMasks(serialWorld, x, z, faceMasks);
+            for (int y = 0; y < WORLD_SIZE_Y; y++) {
+                for (int faceDir = 0; faceDir < 6; faceDir++) {
+                    bool visible = (faceMasks[faceDir] >> y) & 1;
+                    if (visible != IsBlockFaceVisible(serialWorld, x, y, z, faceDir)) faceMaskMismatches++;
+                }
+            }
+        }
+    }
+    printf("Face mask vs per-block mismatches: %d (expect 0)\n", faceMaskMismatches);
+    
+    // Batched rays over terrain match single rays and never pass through a block
+    Ray terrainRays[512];
+    RaycastHit batchHits[512];
+    for (int i = 0; i < 512; i++) {
+        float angle = (float)i * 0.37f;
+        terrainRays[i] = (Ray){
+            { 32.3f + (float)(i % 7), 50.0f, 32.7f - (float)(i % 5) },
+            { cosf(angle), -0.2f - (float)(i % 9) * 0.2f, sinf(angle) }
+        };
+    }
+    RaycastWorldBatch(serialWorld, terrainRays, 512, 128.0f, 0, batchHits);
+    int rayMismatches = 0;
+    for (int i = 0; i < 512; i++) {
+        RaycastHit single = RaycastWorld(serialWorld, terrainRays[i], 128.0f, 0);
+        if (single.hit != batchHits[i].hit || single.x != batchHits[i].x ||
+            single.y != batchHits[i].y || single.z != batchHits[i].z) rayMismatches++;
+        if (single.hit && GetBlock(serialWorld, single.x, single.y, single.z) == BLOCK_EMPTY) rayMismatches++;
+        
+        // Sample the ray up to the hit (or its end): every point before it must be in air
+        Vector3 d = terrainRays[i].direction;
+        float length = sqrtf(d.x * d.x + d.y * d.y + d.z * d.z);
+        float end = single.hit ? single.distance - 0.01f : 128.0f;
+        for (float t = 0.0f; t < end; t += 0.05f) {
+            Vector3 p = terrainRays[i].position;
+            if (GetBlock(serialWorld, (int)floorf(p.x + d.x / length * t), (int)floorf(p.y + d.y / length * t),
+                         (int)floorf(p.z + d.z / length * t)) != BLOCK_EMPTY) {
+                rayMismatches++;
+                break;
+            }
+        }
+    }
+    printf("Batched ray mismatches: %d (expect 0)\n", rayMismatches);
+    SetBlock(serialWorld, 20, 30, 20, editedBlocks[0]);
+    SetBlock(serialWorld, 20, 31, 20, editedBlocks[1]);
+    SetBlock(serialWorld, 21, 5, 20, editedBlocks[2]);
+    
+    // Test bulk edits: fills must match the same edits made block by block,
+    // and a copied box pasted elsewhere must reproduce the terrain
+    printf("\nTesting bulk region edits...\n");
+    World* fillWorld = CreateWorld();
+    World* fillReference = CreateWorld();
+    const int fillBoxes[][7] = {
+        { -20, 0, -5, 40, 20, 30, BLOCK_STONE },   // Many chunks, several whole
+        { 3, 10, 3, 12, 50, 12, BLOCK_JELLO },     // Inside the stone and above it
+        { 0, 0, 0, 15, 15, 15, BLOCK_SAND },       // Exactly one chunk
+        { 35, 18, 20, 5, 2, -3, BLOCK_EMPTY },     // Corners given in reverse
+        { -16, 0, -16, -1, 15, -1, BLOCK_EMPTY },  // Empties a whole chunk
+        { 8, -10, 8, 8, 100, 8, BLOCK_GRASS }      // Clipped to the world's height
+    };
+    int fillBoxCount = (int)(sizeof(fillBoxes) / sizeof(fillBoxes[0]));
+    for (int i = 0; i < fillBoxCount; i++) {
+        const int* b = fillBoxes[i];
+        FillRegion(fillWorld, b[0], b[1], b[2], b[3], b[4], b[5], (BlockType)b[6]);
+        for (int x = (b[0] < b[3] ? b[0] : b[3]); x <= (b[0] < b[3] ? b[3] : b[0]); x++) {
+            for (int y = (b[1] < b[4] ? b[1] : b[4]); y <= (b[1] < b[4] ? b[4] : b[1]); y++) {
+                for (int z = (b[2] < b[5] ? b[2] : b[5]); z <= (b[2] < b[5] ? b[5] : b[2]); z++) {
+                    SetBlock(fillReference, x, y, z, (BlockType)b[6]);
+                }
+            }
+        }
+    }
+    FillColumn(fillWorld, 30, 30, 60, 25, BLOCK_STONE);
+    for (int y = 25; y <= 60; y++) SetBlock(fillReference, 30, y, 30, BLOCK_STONE);
+    int fillMismatches = 0;
+    for (int x = -24; x < 48; x++) {
+        for (int y = 0; y < WORLD_SIZE_Y; y++) {
+            for (int z = -24; z < 48; z++) {
+                if (GetBlock(fillWorld, x, y, z) != GetBlock(fillReference, x, y, z)) fillMismatches++;
+            }
+        }
+    }
+    printf("Fill vs per-block mismatches: %d (expect 0)\n", fillMismatches);
+    printf("Chunks: %d, per-block: %d (expect equal)\n", fillWorld->chunkCount, fillReference->chunkCount);
+    Chunk* stoneChunk = GetChunk(fillWorld, -1, 0, 0);
+    printf("Whole-chunk fill uniform: %s, modified: %s (expect Yes, Yes)\n",
+           (stoneChunk && IsChunkUniform(stoneChunk)) ? "Yes" : "No", (stoneChunk && stoneChunk->modified) ? "Yes" : "No");
+    ChunkCoord fillDirty;
+    while (PopDirtyChunk(fillWorld, &fillDirty)) {}
+    World* emptyFillWorld = CreateWorld();
+    FillRegion(emptyFillWorld, 0, 0, 0, 47, 31, 47, BLOCK_STONE);
+    int fillDirtyCount = 0;
+    while (PopDirtyChunk(emptyFillWorld, &fillDirty)) fillDirtyCount++;
+    printf("Dirty chunks after filling 3x2x3 chunks: %d (expect 18)\n", fillDirtyCount);
+    FillRegion(emptyFillWorld, 0, 0, 0, 47, 31, 47, BLOCK_STONE);
+    FillRegion(emptyFillWorld, 100, 0, 100, 120, 40, 120, BLOCK_EMPTY);
+    fillDirtyCount = 0;
+    while (PopDirtyChunk(emptyFillWorld, &fillDirty)) fillDirtyCount++;
+    printf("Dirty chunks after fills that change nothing: %d (expect 0)\n", fillDirtyCount);
+    FillRegion(emptyFillWorld, 5, 5, 5, 5, 5, 5, BLOCK_EMPTY);
+    fillDirtyCount = 0;
+    while (PopDirtyChunk(emptyFillWorld, &fillDirty)) fillDirtyCount++;
+    printf("Dirty chunks after carving one inner block: %d (expect 1)\n", fillDirtyCount);
+    DestroyWorld(emptyFillWorld);
+    
+    BlockRegion* copied = CopyRegion(serialWorld, 10, -4, 10, 40, WORLD_SIZE_Y - 1, 35);
+    printf("Copied region size: %dx%dx%d (expect 31x68x26)\n",
+           copied ? copied->sizeX : 0, copied ? copied->sizeY : 0, copied ? copied->sizeZ : 0);
+    PasteRegion(fillWorld, copied, -50, -4, 70);
+    int pasteMismatches = 0;
+    for (int x = 0; x < 31; x++) {
+        for (int y = 0; y < WORLD_SIZE_Y; y++) {
+            for (int z = 0; z < 26; z++) {
+                if (GetBlock(fillWorld, x - 50, y, z + 70) != GetBlock(serialWorld, x + 10, y, z + 10)) pasteMismatches++;
+            }
+        }
+    }
+    printf("Pasted vs source mismatches: %d (expect 0)\n", pasteMismatches);
+    printf("Block below the world copied as: %d (expect %d)\n",
+           copied ? copied->blocks[GetRegionBlockIndex(copied, 0, 0, 0)] : -1, BLOCK_EMPTY);
+    PasteRegion(fillWorld, copied, -50, 40, 70);
+    int clippedPasteMismatches = 0;
+    for (int y = 40; y < WORLD_SIZE_Y; y++) {
+        if (GetBlock(fillWorld, -45, y, 75) != GetBlock(serialWorld, 15, y - 44, 15)) clippedPasteMismatches++;
+    }
+    printf("Paste clipped at the top mismatches: %d (expect 0)\n", clippedPasteMismatches);
+    FreeBlockRegion(copied);
+    DestroyWorld(fillWorld);
+    DestroyWorld(fillReference);
+    
+    // Test the column height cache: after every kind of edit the cached
+    // heights match a scan of the blocks
+    printf("\nTesting column heights...\n");
+    World* heightWorld = CreateWorld();
+    GenerateTerrainSeeded(heightWorld, 42u, terrainJobs);
+    printf("Heights of a column outside the world: %d, %d (expect -1, -1)\n",
+           GetSolidHeight(heightWorld, WORLD_HORIZONTAL_LIMIT, 0), GetJelloHeight(heightWorld, 0, -WORLD_HORIZONTAL_LIMIT));
+    int generatedSurface = GetSolidHeight(heightWorld, 10, 10);
+    SetBlock(heightWorld, 10, 60, 10, BLOCK_STONE);
+    printf("Solid height after building on top: %d (expect 60)\n", GetSolidHeight(heightWorld, 10, 10));
+    SetBlock(heightWorld, 10, 60, 10, BLOCK_EMPTY);
+    printf("Solid height after removing it again: %s (expect Yes)\n",
+           GetSolidHeight(heightWorld, 10, 10) == generatedSurface ? "Yes" : "No");
+    SetBlock(heightWorld, 10, 62, 10, BLOCK_JELLO);
+    printf("Jello height after placing jello: %d (expect 62)\n", GetJelloHeight(heightWorld, 10, 10));
+    FillColumn(heightWorld, 11, 11, 0, WORLD_SIZE_Y - 1, BLOCK_EMPTY);
+    printf("Heights of a cleared column: %d, %d (expect -1, -1)\n",
+           GetSolidHeight(heightWorld, 11, 11), GetJelloHeight(heightWorld, 11, 11));
+    long primedHeights = 0;
+    for (int x = -8; x < 150; x++) {
+        for (int z = -8; z < 150; z++) {
+            primedHeights += GetSolidHeight(heightWorld, x, z);
+        }
+    }
+    FillRegion(heightWorld, 20, 30, 20, 40, 50, 40, BLOCK_JELLO);
+    BlockRegion* heightCopy = CopyRegion(heightWorld, 0, 0, 0, 40, WORLD_SIZE_Y - 1, 40);
+    PasteRegion(heightWorld, heightCopy, 100, 0, 100);
+    FreeBlockRegion(heightCopy);
+    UnloadChunk(heightWorld, 0, 3, 0);
+    SetBlock(heightWorld, 5, 63, 5, BLOCK_SAND);
+    SetBlock(heightWorld, 6, 20, 6, BLOCK_EMPTY);
+    for (int i = 0; i < 16; i++) {
+        // Swap surface blocks between solid, jello and air
+        int top = GetSolidHeight(heightWorld, 60 + i, 60);
+        SetBlock(heightWorld, 60 + i, top, 60, (i & 1) ? BLOCK_JELLO : BLOCK_EMPTY);
+        SetBlock(heightWorld, 60 + i, top + 2, 60, BLOCK_JELLO);
+        if (i & 2) SetBlock(heightWorld, 60 + i, top + 2, 60, BLOCK_SAND);
+        if (i & 4) SetBlock(heightWorld, 60 + i, top + 2, 60, BLOCK_EMPTY);
+    }
+    int heightMismatches = 0;
+    for (int x = -8; x < 150; x++) {
+        for (int z = -8; z < 150; z++) {
+            int solid = -1;
+            int jello = -1;
+            for (int y = WORLD_SIZE_Y - 1; y >= 0 && (solid < 0 || jello < 0); y--) {
+                BlockType block = GetBlock(heightWorld, x, y, z);
+                if (solid < 0 && !IsBlockTransparent(block)) solid = y;
+                if (jello < 0 && block == BLOCK_JELLO) jello = y;
+            }
+            if (GetSolidHeight(heightWorld, x, z) != solid || GetJelloHeight(heightWorld, x, z) != jello) heightMismatches++;
+        }
+    }
+    printf("Cached vs scanned height mismatches: %d (expect 0)\n", heightMismatches);
+    printf("Heights cached before the edits: %s (expect Yes)\n", primedHeights > 0 ? "Yes" : "No");
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        UnloadChunk(heightWorld, 7, cy, 7);
+    }
+    printf("Heights of an unloaded column: %d (expect -1)\n", GetSolidHeight(heightWorld, 7 * CHUNK_SIZE, 7 * CHUNK_SIZE));
+    SetBlock(heightWorld, 300, 10, 300, BLOCK_STONE);
+    int cachedColumns = heightWorld->heightCount;
+    size_t cachedBytes = GetWorldMemoryUsage(heightWorld);
+    for (int i = 0; i < 1000; i++) {
+        GetJelloHeight(heightWorld, 5000 + i * CHUNK_SIZE, -3000);
+    }
+    printf("Columns cached by queries outside the terrain: %d (expect 0)\n", heightWorld->heightCount - cachedColumns);
+    GetSolidHeight(heightWorld, 300, 300);
+    printf("Memory usage counts the height cache: %s (expect Yes)\n",
+           GetWorldMemoryUsage(heightWorld) == cachedBytes + sizeof(ColumnHeights) ? "Yes" : "No");
+    EntityStore* heightEntities = CreateEntityStore(1);
+    Player* heightPlayer = CreatePlayer(heightWorld, heightEntities);
+    Vector3 spawn = GetEntityPosition(heightEntities, heightPlayer->entity);
+    int spawnSolid = GetSolidHeight(heightWorld, WORLD_SIZE_X / 2, WORLD_SIZE_Z / 2);
+    int spawnJello = GetJelloHeight(heightWorld, WORLD_SIZE_X / 2, WORLD_SIZE_Z / 2);
+    printf("Player spawns on the surface: %s (expect Yes)\n",
+           (int)spawn.y == ((spawnJello > spawnSolid) ? spawnJello : spawnSolid) + 1 ? "Yes" : "No");
+    DestroyPlayer(heightPlayer);
+    DestroyEntityStore(heightEntities);
+    DestroyWorld(heightWorld);
+    
+    // Test saving and loading: a round trip keeps every block and the seed
+    printf("\nTesting world save and load...\n");
+    RemoveSavedWorld(TEST_SAVE_DIRECTORY);
+    SetBlock(serialWorld, -40, 5, 100, BLOCK_SAND);
+    SetBlock(serialWorld, 10, 2, 10, BLOCK_EMPTY);
+    bool saved = SaveWorld(serialWorld, TEST_SAVE_DIRECTORY);
+    World* loadedWorld = LoadWorld(TEST_SAVE_DIRECTORY);
+    printf("Saved and loaded: %s (expect Yes)\n", saved && loadedWorld ? "Yes" : "No");
+    if (loadedWorld) {
+        int loadMismatches = 0;
+        for (int x = 0; x < WORLD_SIZE_X; x++) {
+            for (int y = 0; y < WORLD_SIZE_Y; y++) {
+                for (int z = 0; z < WORLD_SIZE_Z; z++) {
+                    if (GetBlock(loadedWorld, x, y, z) != GetBlock(serialWorld, x, y, z)) loadMismatches++;
+                }
+            }
+        }
+        printf("Loaded vs saved mismatches: %d (expect 0)\n", loadMismatches);
+        printf("Far block after load: %d (expect 2)\n", GetBlock(loadedWorld, -40, 5, 100));
+        printf("Loaded seed: %u (expect 42)\n", loadedWorld->seed);
+        DestroyWorld(loadedWorld);
+    }
+    
+    // Lazy loading decodes a column only when it is first reached
+    World* lazyWorld = LoadWorldLazy(TEST_SAVE_DIRECTORY);
+    printf("Lazily loaded: %s (expect Yes)\n", lazyWorld ? "Yes" : "No");
+    if (lazyWorld) {
+        printf("Chunks before access: %d (expect 0)\n", lazyWorld->chunkCount);
+        GetBlock(lazyWorld, 5, 5, 5);
+        int columnChunks = 0;
+        for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+            if (GetChunk(serialWorld, 0, cy, 0)) columnChunks++;
+        }
+        printf("Chunks after one access: %d (expect %d)\n", lazyWorld->chunkCount, columnChunks);
+        
+        int lazyMismatches = 0;
+        for (int x = 0; x < WORLD_SIZE_X; x++) {
+            for (int y = 0; y < WORLD_SIZE_Y; y++) {
+                for (int z = 0; z < WORLD_SIZE_Z; z++) {
+                    if (GetBlock(lazyWorld, x, y, z) != GetBlock(serialWorld, x, y, z)) lazyMismatches++;
+                }
+            }
+        }
+        printf("Lazy vs saved mismatches: %d (expect 0)\n", lazyMismatches);
+        printf("Far block after lazy load: %d (expect 2)\n", GetBlock(lazyWorld, -40, 5, 100));
+        DestroyWorld(lazyWorld);
+    }
+    
+    // Saving a lazily opened world elsewhere also writes the columns it never reached
+    RemoveSavedWorld(TEST_COPY_DIRECTORY);
+    lazyWorld = LoadWorldLazy(TEST_SAVE_DIRECTORY);
+    GetBlock(lazyWorld, 5, 5, 5);
+    bool copySaved = lazyWorld && SaveWorld(lazyWorld, TEST_COPY_DIRECTORY);
+    DestroyWorld(lazyWorld);
+    World* copiedWorld = LoadWorld(TEST_COPY_DIRECTORY);
+    printf("Lazy world saved to another directory: %s (expect Yes)\n", copySaved && copiedWorld ? "Yes" : "No");
+    if (copiedWorld) {
+        int copyMismatches = 0;
+        for (int x = 0; x < WORLD_SIZE_X; x++) {
+            for (int y = 0; y < WORLD_SIZE_Y; y++) {
+                for (int z = 0; z < WORLD_SIZE_Z; z++) {
+                    if (GetBlock(copiedWorld, x, y, z) != GetBlock(serialWorld, x, y, z)) copyMismatches++;
+                }
+            }
+        }
+        printf("Copied vs original mismatches: %d (expect 0)\n", copyMismatches);
+        printf("Far block in the copy: %d (expect 2)\n", GetBlock(copiedWorld, -40, 5, 100));
+        DestroyWorld(copiedWorld);
+    }
+    RemoveSavedWorld(TEST_COPY_DIRECTORY);
+    RemoveSavedWorld(TEST_SAVE_DIRECTORY);
+    SetBlock(serialWorld, -40, 5, 100, BLOCK_EMPTY);
+    SetBlock(serialWorld, 10, 2, 10, BLOCK_STONE);
+    
+    // Test streaming: columns around a point are generated, far ones evicted
+    // (and saved when edited)
+    printf("\nTesting chunk streaming...\n");
+    World* streamWorld = CreateWorld();
+    WorldStreamer* streamer = CreateWorldStreamer(terrainJobs, 42u, 2, 0, TEST_SAVE_DIRECTORY);
+    Vector3 streamPosition = { 8.0f, 30.0f, 8.0f };
+    Vector3 streamForward = { 1.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 8; i++) {
+        UpdateWorldStreamer(streamer, streamWorld, streamPosition, streamForward);
+        WaitForJobs(terrainJobs);
+        
+        // Edits made while their column is generating land on top of it
+        if (i == 0) {
+            SetBlock(streamWorld, 20, 5, 20, BLOCK_JELLO);
+            FillRegion(streamWorld, 24, 6, 24, 25, 6, 24, BLOCK_SAND);
+        }
+    }
+    printf("Columns loaded: %d (expect 13)\n", streamer->stats.loadedColumns);
+    printf("Blocks edited during generation: %d, %d, %d (expect %d, %d, %d)\n", GetBlock(streamWorld, 20, 5, 20),
+           GetBlock(streamWorld, 24, 6, 24), GetBlock(streamWorld, 25, 6, 24), BLOCK_JELLO, BLOCK_SAND, BLOCK_SAND);
+    int editedColumnMismatches = 0;
+    for (int x = CHUNK_SIZE; x < 2 * CHUNK_SIZE; x++) {
+        for (int y = 0; y < WORLD_SIZE_Y; y++) {
+            for (int z = CHUNK_SIZE; z < 2 * CHUNK_SIZE; z++) {
+                bool edited = (x == 20 && y == 5 && z == 20) || ((x == 24 || x == 25) && y == 6 && z == 24);
+                if (!edited && GetBlock(streamWorld, x, y, z) != GetBlock(serialWorld, x, y, z)) editedColumnMismatches++;
+            }
+        }
+    }
+    printf("Column edited during generation vs generated mismatches: %d (expect 0)\n", editedColumnMismatches);
+    int streamMismatches = 0;
+    for (int x = 0; x < 3 * CHUNK_SIZE; x++) {
+        for (int y = 0; y < WORLD_SIZE_Y; y++) {
+            if (GetBlock(streamWorld, x, y, 5) != GetBlock(serialWorld, x, y, 5)) streamMismatches++;
+        }
+    }
+    printf("Streamed vs generated mismatches: %d (expect 0)\n", streamMismatches);
+    SetBlock(streamWorld, 5, 60, 5, BLOCK_STONE);
+    streamPosition.x += 1000.0f;
+    for (int i = 0; i < 8; i++) {
+        UpdateWorldStreamer(streamer, streamWorld, streamPosition, streamForward);
+        WaitForJobs(terrainJobs);
+        
+        // The edited column is being saved now; edits to it wait for the save
+        if (i == 0) {
+            printf("Edited columns saving after moving away: %d (expect 2)\n", streamer->stats.savingColumns);
+            SetBlock(streamWorld, 6, 5, 6, BLOCK_JELLO);
+        }
+    }
+    printf("Old column evicted: %s (expect Yes)\n", GetChunk(streamWorld, 0, 0, 0) ? "No" : "Yes");
+    printf("Columns loaded after moving: %d (expect 13)\n", streamer->stats.loadedColumns);
+    streamPosition.x -= 1000.0f;
+    for (int i = 0; i < 8; i++) {
+        UpdateWorldStreamer(streamer, streamWorld, streamPosition, streamForward);
+        WaitForJobs(terrainJobs);
+    }
+    printf("Edited block after streaming back: %d (expect 3)\n", GetBlock(streamWorld, 5, 60, 5));
+    printf("Block edited during the save: %d (expect %d)\n", GetBlock(streamWorld, 6, 5, 6), BLOCK_JELLO);
+    int savedColumnMismatches = 0;
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int y = 0; y < WORLD_SIZE_Y; y++) {
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                bool edited = (x == 5 && y == 60 && z == 5) || (x == 6 && y == 5 && z == 6);
+                if (!edited && GetBlock(streamWorld, x, y, z) != GetBlock(serialWorld, x, y, z)) savedColumnMismatches++;
+            }
+        }
+    }
+    printf("Column edited during the save vs generated mismatches: %d (expect 0)\n", savedColumnMismatches);
+    DestroyWorldStreamer(streamer, streamWorld);
+    DestroyWorld(streamWorld);
+    RemoveSavedWorld(TEST_SAVE_DIRECTORY);
+    
+    // Test rendering through the headless backend: mesh a generated world,
+    // then draw it from the player's view and check what was submitted
+    printf("\nTesting headless rendering...\n");
+    RenderBackend* backend = CreateHeadlessRenderBackend(800, 600, true);
+    printf("Renderer without a backend: %s (expect NULL)\n", CreateWorldRenderer(terrainJobs, NULL) ? "created" : "NULL");
+    World* renderWorld = CreateWorld();
+    GenerateTerrainSeeded(renderWorld, 42u, terrainJobs);
+    SetBlock(renderWorld, 40, 50, 30, BLOCK_JELLO);
+    EntityStore* renderEntities = CreateEntityStore(1);
+    Player* renderPlayer = CreatePlayer(renderWorld, renderEntities);
+    WorldRenderer* renderer = CreateWorldRenderer(terrainJobs, backend);
+    for (int i = 0; i < 64; i++) {
+        UpdateWorldRenderer(renderer, renderWorld, renderPlayer);
+        WaitForJobs(terrainJobs);
+    }
+    UpdateWorldRenderer(renderer, renderWorld, renderPlayer);
+    printf("Meshes uploaded: %s (expect Yes)\n", backend->stats.meshUploads > 0 ? "Yes" : "No");
+    Camera renderCamera = { 0 };
+    renderCamera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    renderCamera.fovy = 60.0f;
+    renderCamera.projection = CAMERA_PERSPECTIVE;
+    UpdateCameraFromPlayer(&renderCamera, renderPlayer);
+    renderCamera.target = (Vector3){ renderCamera.position.x + 1.0f, renderCamera.position.y - 1.0f, renderCamera.position.z };
+    ResetRenderBackendStats(backend);
+    RenderWorld(renderer, renderWorld, renderPlayer, renderCamera);
+    int capturedCount;
+    const float* captured = GetCapturedVertices(backend, &capturedCount);
+    int capturedOutside = 0;
+    for (int i = 0; i < capturedCount; i++) {
+        const float* v = &captured[i * 3];
+        if (v[0] < 0.0f || v[0] > WORLD_SIZE_X || v[1] < 0.0f || v[1] > WORLD_SIZE_Y || v[2] < 0.0f || v[2] > WORLD_SIZE_Z) {
+            capturedOutside++;
+        }
+    }
+    printf("Draw calls cover drawn chunks: %s (expect Yes)\n",
+           (renderer->stats.chunksDrawn > 0 && backend->stats.drawCalls >= renderer->stats.chunksDrawn) ? "Yes" : "No");
+    printf("Triangles match vertices: %s (expect Yes)\n",
+           backend->stats.triangles * 3 == backend->stats.vertices ? "Yes" : "No");
+    printf("Captured vertices match drawn: %s (expect Yes)\n", capturedCount == backend->stats.vertices ? "Yes" : "No");
+    printf("Captured vertices outside the world: %d (expect 0)\n", capturedOutside);
+    printf("Blend state changes: %d (expect 2)\n", backend->stats.stateChanges);
+    long lookingDownTriangles = backend->stats.triangles;
+    ResetRenderBackendStats(backend);
+    RenderWorld(renderer, renderWorld, renderPlayer, renderCamera);
+    printf("Uploads and re-sorts when redrawn from the same spot: %d %d (expect 0 0)\n",
+           backend->stats.meshUploads, backend->stats.bufferUpdates);
+    renderCamera.target = (Vector3){ renderCamera.position.x, renderCamera.position.y + 1.0f, renderCamera.position.z + 0.01f };
+    ResetRenderBackendStats(backend);
+    RenderWorld(renderer, renderWorld, renderPlayer, renderCamera);
+    printf("Fewer triangles looking at the sky: %s (expect Yes)\n",
+           backend->stats.triangles < lookingDownTriangles ? "Yes" : "No");
+    DestroyWorldRenderer(renderer);
+    DestroyRenderBackend(backend);
+    DestroyPlayer(renderPlayer);
+    DestroyEntityStore(renderEntities);
+    DestroyWorld(renderWorld);
+    
+    // Test the profiler: nested zones on this thread, zones from the workers,
+    // ring overflow and the trace file
+    printf("\nTesting profiler...\n");
+    printf("Profiler started: %s (expect Yes)\n", InitProfiler() ? "Yes" : "No");
+    printf("Second start refused: %s (expect Yes)\n", InitProfiler() ? "No" : "Yes");
+    ProfileBegin("Outer");
+    ProfileBegin("Inner");
+    ProfileEnd();
+    ProfileEnd();
+    ProfileEnd(); // Unbalanced end is ignored
+    for (int i = 0; i < 4; i++) {
+        SubmitJob(terrainJobs, ProfileZoneJob, NULL);
+    }
+    WaitForJobs(terrainJobs);
+    ProfileFrame();
+    ProfileZoneStats zoneStats[PROFILER_MAX_ZONES];
+    int zoneStatCount = GetProfileZoneStats(zoneStats, PROFILER_MAX_ZONES);
+    const ProfileZoneStats* outerZone = FindProfileZone(zoneStats, zoneStatCount, "Outer");
+    const ProfileZoneStats* innerZone = FindProfileZone(zoneStats, zoneStatCount, "Inner");
+    const ProfileZoneStats* workerZone = FindProfileZone(zoneStats, zoneStatCount, "WorkerZone");
+    const ProfileZoneStats* frameZone = FindProfileZone(zoneStats, zoneStatCount, "Frame");
+    printf("Zones recorded: %d (expect 4)\n", zoneStatCount);
+    printf("Outer/Inner/Worker/Frame calls: %d %d %d %d (expect 1 1 4 1)\n",
+           outerZone ? outerZone->calls : 0, innerZone ? innerZone->calls : 0,
+           workerZone ? workerZone->calls : 0, frameZone ? frameZone->calls : 0);
+    printf("Outer zone covers inner zone: %s (expect Yes)\n",
+           (outerZone && innerZone && outerZone->frameMs >= innerZone->frameMs) ? "Yes" : "No");
+    ProfileFrame();
+    zoneStatCount = GetProfileZoneStats(zoneStats, PROFILER_MAX_ZONES);
+    outerZone = FindProfileZone(zoneStats, zoneStatCount, "Outer");
+    printf("Outer calls in the next frame: %d (expect 0)\n", outerZone ? outerZone->calls : -1);
+    for (int i = 0; i < PROFILER_RING_SIZE + 100; i++) {
+        ProfileBegin("Overflow");
+        ProfileEnd();
+    }
+    ProfileFrame();
+    printf("Zones dropped by a full ring: %ld (expect 100)\n", GetProfileDroppedEvents());
+    const char* tracePath = "test_profile_trace.json";
+    printf("Trace written: %s (expect Yes)\n", WriteProfileTrace(tracePath) ? "Yes" : "No");
+    int traceWorkerZones = 0;
+    FILE* traceFile = fopen(tracePath, "r");
+    if (traceFile) {
+        char line[256];
+        while (fgets(line, sizeof(line), traceFile)) {
+            if (strstr(line, "\"name\":\"WorkerZone\",\"ph\":\"X\"")) traceWorkerZones++;
+        }
+        fclose(traceFile);
+    }
+    remove(tracePath);
+    printf("Worker zones in trace: %d (expect 4)\n", traceWorkerZones);
+    ShutdownProfiler(NULL);
+    printf("Profiler restarted: %s (expect Yes)\n", InitProfiler() ? "Yes" : "No");
+    ProfileBegin("Outer");
+    ProfileEnd();
+    ProfileFrame();
+    zoneStatCount = GetProfileZoneStats(zoneStats, PROFILER_MAX_ZONES);
+    printf("Zones after restart: %d (expect 2)\n", zoneStatCount);
+    ShutdownProfiler(NULL);
+    
+    DestroyJobSystem(terrainJobs);
+    DestroyWorld(serialWorld);
+    DestroyWorld(parallelWorld);
+    DestroyWorld(otherSeedWorld);
+    
     // Clean up
     printf("\nCleaning up...\n");
     DestroyWorld(world);
@@ -0,0 +1,153 @@
+#include "visibility.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// enteredFace markers besides the six face directions
+#define VISIBILITY_UNREACHED 0xFF // Not reached by the search
+#define VISIBILITY_START 6        // Search started here (every face counts as entered)
+
+// Offset to the neighbouring chunk across each face (+X, -X, +Y, -Y, +Z, -Z)
+static const int STEP_OFFSETS[6][3] = {
+    { 1, 0, 0 }, {-1, 0, 0 }, { 0, 1, 0 }, { 0,-1, 0 }, { 0, 0, 1 }, { 0, 0,-1 }
+};
+
+// Create the search state for boxes of up to capacity chunks
+ChunkVisibility* CreateChunkVisibility(int capacity) {
+    if (capacity <= 0) return NULL;
+    
+    ChunkVisibility* visibility = (ChunkVisibility*)calloc(1, sizeof(ChunkVisibility));
+    if (!visibility) return NULL;
+    
+    visibility->capacity = capacity;
+    visibility->enteredFace = (uint8_t*)malloc(capacity);
+    visibility->directions = (uint8_t*)malloc(capacity);
+    visibility->queue = (int*)malloc(capacity * sizeof(int));
+    
+    if (!visibility->enteredFace || !visibility->directions || !visibility->queue) {
+        DestroyChunkVisibility(visibility);
+        return NULL;
+    }
+    
+    return visibility;
+}
+
+// Free the search state
+void DestroyChunkVisibility(ChunkVisibility* visibility) {
+    if (visibility) {
+        free(visibility->enteredFace);
+        free(visibility->directions);
+        free(visibility->queue);
+        free(visibility);
+    }
+}
+
+// Whether a chunk lies in the frustum (always, without one)
+static bool IsChunkInFrustum(const Frustum* frustum, int cx, int cy, int cz) {
+    if (!frustum) return true;
+    
+    BoundingBox bounds = {
+        { (float)(cx * CHUNK_SIZE), (float)(cy * CHUNK_SIZE), (float)(cz * CHUNK_SIZE) },
+        { (float)((cx + 1) * CHUNK_SIZE), (float)((cy + 1) * CHUNK_SIZE), (float)((cz + 1) * CHUNK_SIZE) }
+    };
+    
+    return IsBoxInFrustum(frustum, bounds);
+}
+
+// Find the chunks of a box that can be seen from the camera (frustum may be
+// NULL to search in every direction). Writes up to maxVisible chunk
+// coordinates, nearest steps first, and returns how many were written.
+// When the camera is above or below the box, the search starts from every
+// chunk of the layer facing it.
+int FindVisibleChunks(ChunkVisibility* visibility, ChunkBox box, Vector3 camera, const Frustum* frustum,
+                      ChunkConnectivityFunction connectivity, void* context,
+                      ChunkCoord* visible, int maxVisible) {
+    if (!visibility || !connectivity || !visible || maxVisible <= 0) return 0;
+    
+    int size[3] = { box.maxX - box.minX + 1, box.maxY - box.minY + 1, box.maxZ - box.minZ + 1 };
+    if (size[0] <= 0 || size[1] <= 0 || size[2] <= 0) return 0;
+    if ((long)size[0] * size[1] * size[2] > visibility->capacity) return 0;
+    
+    int boxMin[3] = { box.minX, box.minY, box.minZ };
+    int boxMax[3] = { box.maxX, box.maxY, box.maxZ };
+    memset(visibility->enteredFace, VISIBILITY_UNREACHED, (size_t)size[0] * size[1] * size[2]);
+    
+    int head = 0, tail = 0;
+    
+    // Starting chunks: the camera's chunk, clamped into the box
+    int start[3] = {
+        BlockToChunkCoord((int)floorf(camera.x)),
+        BlockToChunkCoord((int)floorf(camera.y)),
+        BlockToChunkCoord((int)floorf(camera.z))
+    };
+    int layerFace = -1; // Face of the box the camera is beyond vertically
+    for (int axis = 0; axis < 3; axis++) {
+        if (start[axis] < boxMin[axis]) {
+            start[axis] = boxMin[axis];
+            if (axis == 1) layerFace = 3;
+        } else if (start[axis] > boxMax[axis]) {
+            start[axis] = boxMax[axis];
+            if (axis == 1) layerFace = 2;
+        }
+    }
+    
+    for (int cx = box.minX; cx <= box.maxX; cx++) {
+        for (int cz = box.minZ; cz <= box.maxZ; cz++) {
+            if (layerFace < 0 && (cx != start[0] || cz != start[2])) continue;
+            if (layerFace >= 0 && !IsChunkInFrustum(frustum, cx, start[1], cz)) continue;
+            
+            int index = ((cx - box.minX) * size[1] + (start[1] - box.minY)) * size[2] + (cz - box.minZ);
+            visibility->enteredFace[index] = (layerFace < 0) ? VISIBILITY_START : (uint8_t)layerFace;
+            visibility->directions[index] = (layerFace < 0) ? 0 : (uint8_t)(1 << (layerFace ^ 1));
+            visibility->queue[tail++] = index;
+        }
+    }
+    
+    while (head < tail) {
+        int index = visibility->queue[head++];
+        int chunk[3] = {
+            box.minX + index / (size[1] * size[2]),
+            box.minY + (index / size[2]) % size[1],
+            box.minZ + index % size[2]
+        };
+        int entered = visibility->enteredFace[index];
+        uint16_t connections = (entered == VISIBILITY_START)
+            ? CHUNK_ALL_FACES_CONNECTED
+            : connectivity(context, chunk[0], chunk[1], chunk[2]);
+        
+        for (int faceDir = 0; faceDir < 6; faceDir++) {
+            // Never step back toward the camera, and only leave through
+            // faces the chunk can be seen through from where it was entered
+            if (visibility->directions[index] & (1 << (faceDir ^ 1))) continue;
+            if (entered != VISIBILITY_START && (entered == faceDir || !(connections & GetFacePairBit(entered, faceDir)))) continue;
+            
+            int next[3] = {
+                chunk[0] + STEP_OFFSETS[faceDir][0],
+                chunk[1] + STEP_OFFSETS[faceDir][1],
+                chunk[2] + STEP_OFFSETS[faceDir][2]
+            };
+            int axis = faceDir / 2;
+            if (next[axis] < boxMin[axis] || next[axis] > boxMax[axis]) continue;
+            
+            int nextIndex = ((next[0] - box.minX) * size[1] + (next[1] - box.minY)) * size[2] + (next[2] - box.minZ);
+            if (visibility->enteredFace[nextIndex] != VISIBILITY_UNREACHED) continue;
+            if (!IsChunkInFrustum(frustum, next[0], next[1], next[2])) continue;
+            
+            visibility->enteredFace[nextIndex] = (uint8_t)(faceDir ^ 1);
+            visibility->directions[nextIndex] = visibility->directions[index] | (uint8_t)(1 << faceDir);
+            visibility->queue[tail++] = nextIndex;
+        }
+    }
+    
+    int count = (tail < maxVisible) ? tail : maxVisible;
+    for (int i = 0; i < count; i++) {
+        int index = visibility->queue[i];
+        visible[i] = (ChunkCoord){
+            box.minX + index / (size[1] * size[2]),
+            box.minY + (index / size[2]) % size[1],
+            box.minZ + index % size[2]
+        };
+    }
+    
+    return count;
+}
@@ -0,0 +1,38 @@
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+
+#include "raylib.h"
+#include "voxel.h"
+#include "frustum.h"
+#include "mesher.h"
+
+// Gives the face connectivity of a chunk (see GetChunkConnectivity); chunks
+// without blocks, or not meshed yet, should report CHUNK_ALL_FACES_CONNECTED
+typedef uint16_t (*ChunkConnectivityFunction)(void* context, int cx, int cy, int cz);
+
+// Box of chunk coordinates (both corners inclusive)
+typedef struct {
+    int minX, minY, minZ;
+    int maxX, maxY, maxZ;
+} ChunkBox;
+
+// Chunk occlusion culling by a breadth-first search from the camera's chunk
+// ("cave culling"). The search enters a chunk through one face and only
+// leaves it through faces connected to that one, never steps back toward
+// the camera, and skips chunks outside the view frustum, so chunks hidden
+// behind solid ground are never reached.
+typedef struct {
+    int capacity;             // Most chunks a search box may hold
+    uint8_t* enteredFace;     // Per chunk of the box: faceDir it was entered through, or a marker for unreached and starting chunks
+    uint8_t* directions;      // Per chunk of the box: bit d set if the path to it stepped along faceDir d
+    int* queue;               // Reached chunks (box indices) in search order
+} ChunkVisibility;
+
+// Function prototypes
+ChunkVisibility* CreateChunkVisibility(int capacity);
+void DestroyChunkVisibility(ChunkVisibility* visibility);
+int FindVisibleChunks(ChunkVisibility* visibility, ChunkBox box, Vector3 camera, const Frustum* frustum,
+                      ChunkConnectivityFunction connectivity, void* context,
+                      ChunkCoord* visible, int maxVisible);
+
+#endif // VISIBILITY_H
@@ -1,6 +1,14 @@
 #include "voxel.h"
+#include "profiler.h"
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+
+// Initial number of hash table slots in a new world (must be a power of two)
+#define WORLD_INITIAL_CAPACITY 256
+
+// Initial number of column height cache slots (must be a power of two)
+#define HEIGHT_INITIAL_CAPACITY 64
 
 // Direction vectors for the 6 faces of a block
 // Order: +X, -X, +Y, -Y, +Z, -Z
@@ -18,13 +26,229 @@ bool IsBlockTransparent(BlockType blockType) {
     return blockType == BLOCK_EMPTY || blockType == BLOCK_JELLO;
 }
 
+// Find the slot holding a chunk, or the free slot where it would be inserted
+static int FindChunkSlot(World* world, int cx, int cy, int cz) {
+    int mask = world->capacity - 1;
+    int slot = (int)(HashChunkCoords(cx, cy, cz) & (unsigned int)mask);
+    
+    while (world->slots[slot]) {
+        Chunk* chunk = world->slots[slot];
+        if (chunk->cx == cx && chunk->cy == cy && chunk->cz == cz) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    
+    return slot;
+}
+
+// Double the hash table size and reinsert every chunk
+static bool GrowWorld(World* world) {
+    int newCapacity = world->capacity * 2;
+    Chunk** newSlots = (Chunk**)calloc(newCapacity, sizeof(Chunk*));
+    if (!newSlots) return false;
+    
+    Chunk** oldSlots = world->slots;
+    int oldCapacity = world->capacity;
+    world->slots = newSlots;
+    world->capacity = newCapacity;
+    
+    for (int i = 0; i < oldCapacity; i++) {
+        Chunk* chunk = oldSlots[i];
+        if (chunk) {
+            world->slots[FindChunkSlot(world, chunk->cx, chunk->cy, chunk->cz)] = chunk;
+        }
+    }
+    
+    free(oldSlots);
+    return true;
+}
+
+// Allocate a uniformly empty chunk that is not yet part of any world
+static Chunk* AllocateChunk(int cx, int cy, int cz) {
+    Chunk* chunk = (Chunk*)malloc(sizeof(Chunk));
+    if (!chunk) return NULL;
+    
+    chunk->cx = cx;
+    chunk->cy = cy;
+    chunk->cz = cz;
+    chunk->filledCount = 0;
+    chunk->dirty = false;
+    chunk->modified = false;
+    
+    // A new chunk is uniformly empty and needs no packed data
+    chunk->bitsPerBlock = 0;
+    chunk->paletteSize = 1;
+    chunk->palette[0] = BLOCK_EMPTY;
+    chunk->data = NULL;
+    memset(chunk->filledColumns, 0, sizeof(chunk->filledColumns));
+    memset(chunk->opaqueColumns, 0, sizeof(chunk->opaqueColumns));
+    
+    return chunk;
+}
+
+// Put a chunk into a free slot of the hash table (the coordinates must not be present)
+static bool LinkChunk(World* world, Chunk* chunk) {
+    // Keep the load factor at or below one half
+    if ((world->chunkCount + 1) * 2 > world->capacity && !GrowWorld(world)) {
+        return false;
+    }
+    
+    world->slots[FindChunkSlot(world, chunk->cx, chunk->cy, chunk->cz)] = chunk;
+    world->chunkCount++;
+    
+    return true;
+}
+
+// Allocate an empty chunk and insert it into the world
+static Chunk* CreateChunk(World* world, int cx, int cy, int cz) {
+    Chunk* chunk = AllocateChunk(cx, cy, cz);
+    if (!chunk) return NULL;
+    
+    if (!LinkChunk(world, chunk)) {
+        free(chunk);
+        return NULL;
+    }
+    
+    return chunk;
+}
+
+// Remove a chunk from the hash table without freeing it
+static void UnlinkChunk(World* world, Chunk* chunk) {
+    int mask = world->capacity - 1;
+    int slot = FindChunkSlot(world, chunk->cx, chunk->cy, chunk->cz);
+    
+    world->slots[slot] = NULL;
+    world->chunkCount--;
+    
+    // Shift back any following entries that can no longer be reached
+    int next = (slot + 1) & mask;
+    while (world->slots[next]) {
+        Chunk* moved = world->slots[next];
+        int home = (int)(HashChunkCoords(moved->cx, moved->cy, moved->cz) & (unsigned int)mask);
+        
+        // Move the entry if its home slot does not lie cyclically in (slot, next]
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            world->slots[slot] = moved;
+            world->slots[next] = NULL;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+// Remove a chunk from the world and free it
+static void RemoveChunk(World* world, Chunk* chunk) {
+    UnlinkChunk(world, chunk);
+    free(chunk->data);
+    free(chunk);
+}
+
+// Find the slot caching a chunk column's heights, or the free slot where
+// they would be inserted
+static int FindHeightSlot(World* world, int cx, int cz) {
+    int mask = world->heightCapacity - 1;
+    int slot = (int)(HashChunkCoords(cx, 0, cz) & (unsigned int)mask);
+    
+    while (world->heightSlots[slot]) {
+        ColumnHeights* heights = world->heightSlots[slot];
+        if (heights->cx == cx && heights->cz == cz) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    
+    return slot;
+}
+
+// Double the height cache size and reinsert every column
+static bool GrowHeightCache(World* world) {
+    int newCapacity = world->heightCapacity * 2;
+    ColumnHeights** newSlots = (ColumnHeights**)calloc(newCapacity, sizeof(ColumnHeights*));
+    if (!newSlots) return false;
+    
+    ColumnHeights** oldSlots = world->heightSlots;
+    int oldCapacity = world->heightCapacity;
+    world->heightSlots = newSlots;
+    world->heightCapacity = newCapacity;
+    
+    for (int i = 0; i < oldCapacity; i++) {
+        ColumnHeights* heights = oldSlots[i];
+        if (heights) {
+            world->heightSlots[FindHeightSlot(world, heights->cx, heights->cz)] = heights;
+        }
+    }
+    
+    free(oldSlots);
+    return true;
+}
+
+// Get the cached heights of a chunk column (NULL if they are not cached)
+static ColumnHeights* FindColumnHeights(World* world, int cx, int cz) {
+    return world->heightSlots[FindHeightSlot(world, cx, cz)];
+}
+
+// Mark a chunk column's cached heights as out of date, after its chunks were
+// replaced or rewritten wholesale (they are recomputed on the next query)
+static void InvalidateColumnHeights(World* world, int cx, int cz) {
+    ColumnHeights* heights = FindColumnHeights(world, cx, cz);
+    if (heights) heights->valid = false;
+}
+
+// Drop a chunk column's cached heights (when its last chunk leaves the world)
+static void RemoveColumnHeights(World* world, int cx, int cz) {
+    int mask = world->heightCapacity - 1;
+    int slot = FindHeightSlot(world, cx, cz);
+    if (!world->heightSlots[slot]) return;
+    
+    free(world->heightSlots[slot]);
+    world->heightSlots[slot] = NULL;
+    world->heightCount--;
+    
+    // Shift back any following entries that can no longer be reached (see UnlinkChunk)
+    int next = (slot + 1) & mask;
+    while (world->heightSlots[next]) {
+        ColumnHeights* moved = world->heightSlots[next];
+        int home = (int)(HashChunkCoords(moved->cx, 0, moved->cz) & (unsigned int)mask);
+        
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            world->heightSlots[slot] = moved;
+            world->heightSlots[next] = NULL;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
 // Create a new empty world
 World* CreateWorld(void) {
     World* world = (World*)malloc(sizeof(World));
     
     if (world) {
-        // Initialize all blocks to empty
-        memset(world->blocks, BLOCK_EMPTY, sizeof(world->blocks));
+        // Start with an empty chunk table; chunks are allocated on first write
+        world->capacity = WORLD_INITIAL_CAPACITY;
+        world->chunkCount = 0;
+        world->seed = 0;
+        world->columnSource = (ChunkColumnSource){ NULL, NULL, NULL };
+        world->heldColumns = NULL;
+        world->heldCount = 0;
+        world->heldCapacity = 0;
+        world->dirtyChunks = NULL;
+        world->dirtyCount = 0;
+        world->dirtyCapacity = 0;
+        world->slots = (Chunk**)calloc(world->capacity, sizeof(Chunk*));
+        
+        // Column heights are cached as they are first queried
+        world->heightCapacity = HEIGHT_INITIAL_CAPACITY;
+        world->heightCount = 0;
+        world->heightSlots = (ColumnHeights**)calloc(world->heightCapacity, sizeof(ColumnHeights*));
+        
+        if (!world->slots || !world->heightSlots) {
+            free(world->slots);
+            free(world->heightSlots);
+            free(world);
+            return NULL;
+        }
     }
     
     return world;
@@ -33,15 +257,485 @@ World* CreateWorld(void) {
 // Free the world's memory
 void DestroyWorld(World* world) {
     if (world) {
+        for (int i = 0; i < world->capacity; i++) {
+            if (world->slots[i]) {
+                free(world->slots[i]->data);
+                free(world->slots[i]);
+            }
+        }
+        free(world->slots);
+        for (int i = 0; i < world->heightCapacity; i++) {
+            free(world->heightSlots[i]);
+        }
+        free(world->heightSlots);
+        for (int i = 0; i < world->heldCount; i++) {
+            free(world->heldColumns[i].edits);
+        }
+        free(world->heldColumns);
+        free(world->dirtyChunks);
+        if (world->columnSource.freeContext) {
+            world->columnSource.freeContext(world->columnSource.context);
+        }
         free(world);
     }
 }
 
+// Look up a chunk without consulting the column source
+static Chunk* FindChunk(World* world, int cx, int cy, int cz) {
+    return world->slots[FindChunkSlot(world, cx, cy, cz)];
+}
+
+// Pull a column in from the world's column source; returns false if the
+// source had nothing for it
+static bool LoadSourceColumn(World* world, int cx, int cz) {
+    Chunk* chunks[WORLD_CHUNKS_Y];
+    if (!world->columnSource.loadColumn(world->columnSource.context, cx, cz, chunks)) {
+        return false;
+    }
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        if (chunks[cy] && !InsertChunk(world, chunks[cy])) {
+            FreeChunk(chunks[cy]);
+        }
+    }
+    
+    return true;
+}
+
+// Get the chunk at the given chunk coordinates (NULL if it holds no blocks).
+// Lazily loaded worlds decode the chunk's column on first access.
+Chunk* GetChunk(World* world, int cx, int cy, int cz) {
+    if (!world) return NULL;
+    
+    Chunk* chunk = FindChunk(world, cx, cy, cz);
+    
+    if (!chunk && world->columnSource.loadColumn && cy >= 0 && cy < WORLD_CHUNKS_Y &&
+        LoadSourceColumn(world, cx, cz)) {
+        chunk = FindChunk(world, cx, cy, cz);
+    }
+    
+    return chunk;
+}
+
+// Number of bytes of packed data for a given index width
+static size_t GetChunkDataSize(int bitsPerBlock) {
+    return (size_t)CHUNK_VOLUME * bitsPerBlock / 8;
+}
+
+// Get the number of bytes used by one chunk (header and packed data)
+size_t GetChunkMemoryUsage(const Chunk* chunk) {
+    if (!chunk) return 0;
+    
+    return sizeof(Chunk) + GetChunkDataSize(chunk->bitsPerBlock);
+}
+
+// Get the number of bytes used by the world's chunk storage and column
+// height cache
+size_t GetWorldMemoryUsage(World* world) {
+    if (!world) return 0;
+    
+    size_t bytes = sizeof(World) + (size_t)world->capacity * sizeof(Chunk*);
+    bytes += (size_t)world->heightCapacity * sizeof(ColumnHeights*) + (size_t)world->heightCount * sizeof(ColumnHeights);
+    
+    for (int i = 0; i < world->capacity; i++) {
+        bytes += GetChunkMemoryUsage(world->slots[i]);
+    }
+    
+    return bytes;
+}
+
+// Write a palette index into packed data of the given width
+static inline void WritePackedIndex(uint64_t* data, int bitsPerBlock, int blockIndex, int paletteIndex) {
+    int bit = blockIndex * bitsPerBlock;
+    uint64_t mask = ((1ull << bitsPerBlock) - 1) << (bit & 63);
+    
+    data[bit >> 6] = (data[bit >> 6] & ~mask) | ((uint64_t)paletteIndex << (bit & 63));
+}
+
+// Read a palette index from packed data of the given width
+static inline int ReadPackedIndex(const uint64_t* data, int bitsPerBlock, int blockIndex) {
+    if (bitsPerBlock == 0) return 0;
+    
+    int bit = blockIndex * bitsPerBlock;
+    return (int)((data[bit >> 6] >> (bit & 63)) & ((1ull << bitsPerBlock) - 1));
+}
+
+// Repack a chunk's indices at a new width, remapping them through remap (NULL keeps them)
+static bool RepackChunk(Chunk* chunk, int newBits, const int* remap) {
+    uint64_t* newData = NULL;
+    
+    if (newBits > 0) {
+        newData = (uint64_t*)calloc(1, GetChunkDataSize(newBits));
+        if (!newData) return false;
+        
+        for (int i = 0; i < CHUNK_VOLUME; i++) {
+            int index = ReadPackedIndex(chunk->data, chunk->bitsPerBlock, i);
+            WritePackedIndex(newData, newBits, i, remap ? remap[index] : index);
+        }
+    }
+    
+    free(chunk->data);
+    chunk->data = newData;
+    chunk->bitsPerBlock = newBits;
+    
+    return true;
+}
+
+// Get the palette index of a block type, adding it (and widening the indices) if needed
+static int GetOrAddPaletteIndex(Chunk* chunk, BlockType type) {
+    for (int i = 0; i < chunk->paletteSize; i++) {
+        if (chunk->palette[i] == (BlockId)type) return i;
+    }
+    
+    if (chunk->paletteSize == (1 << chunk->bitsPerBlock)) {
+        int newBits = (chunk->bitsPerBlock == 0) ? 1 : chunk->bitsPerBlock * 2;
+        if (!RepackChunk(chunk, newBits, NULL)) return -1;
+    }
+    
+    chunk->palette[chunk->paletteSize] = (BlockId)type;
+    return chunk->paletteSize++;
+}
+
+// Write a block into a chunk and its column occupancy; returns false if the
+// storage could not grow.
+// Does not update filledCount or dirty state (SetBlock takes care of those).
+bool SetChunkBlock(Chunk* chunk, int lx, int ly, int lz, BlockType type) {
+    int paletteIndex = GetOrAddPaletteIndex(chunk, type);
+    if (paletteIndex < 0) return false;
+    
+    if (chunk->bitsPerBlock > 0) {
+        WritePackedIndex(chunk->data, chunk->bitsPerBlock, CHUNK_INDEX(lx, ly, lz), paletteIndex);
+    }
+    
+    int column = CHUNK_COLUMN_INDEX(lx, lz);
+    uint16_t bit = (uint16_t)(1u << ly);
+    chunk->filledColumns[column] &= (uint16_t)~bit;
+    chunk->opaqueColumns[column] &= (uint16_t)~bit;
+    if (type != BLOCK_EMPTY) chunk->filledColumns[column] |= bit;
+    if (!IsBlockTransparent(type)) chunk->opaqueColumns[column] |= bit;
+    
+    return true;
+}
+
+// Decode every block of a chunk into an array indexed by CHUNK_INDEX
+void UnpackChunkBlocks(const Chunk* chunk, BlockId* blocks) {
+    if (chunk->bitsPerBlock == 0) {
+        memset(blocks, chunk->palette[0], CHUNK_VOLUME);
+        return;
+    }
+    
+    int bits = chunk->bitsPerBlock;
+    int perWord = 64 / bits;
+    uint64_t mask = (1ull << bits) - 1;
+    
+    for (int w = 0; w < CHUNK_VOLUME / perWord; w++) {
+        uint64_t word = chunk->data[w];
+        for (int i = 0; i < perWord; i++) {
+            blocks[w * perWord + i] = chunk->palette[word & mask];
+            word >>= bits;
+        }
+    }
+}
+
+// Drop unused palette entries and narrow the packed indices to the smallest width
+void CompactChunk(Chunk* chunk) {
+    if (!chunk || chunk->bitsPerBlock == 0) return;
+    
+    bool used[CHUNK_MAX_PALETTE] = { false };
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        used[ReadPackedIndex(chunk->data, chunk->bitsPerBlock, i)] = true;
+    }
+    
+    int remap[CHUNK_MAX_PALETTE];
+    BlockId palette[CHUNK_MAX_PALETTE];
+    int paletteSize = 0;
+    for (int i = 0; i < chunk->paletteSize; i++) {
+        if (used[i]) {
+            remap[i] = paletteSize;
+            palette[paletteSize++] = chunk->palette[i];
+        }
+    }
+    
+    int newBits = 0;
+    while ((1 << newBits) < paletteSize) {
+        newBits = (newBits == 0) ? 1 : newBits * 2;
+    }
+    
+    if (newBits == chunk->bitsPerBlock && paletteSize == chunk->paletteSize) return;
+    if (!RepackChunk(chunk, newBits, remap)) return;
+    
+    memcpy(chunk->palette, palette, paletteSize * sizeof(BlockId));
+    chunk->paletteSize = paletteSize;
+}
+
+// Compact the storage of every chunk in the world
+void CompactWorld(World* world) {
+    if (!world) return;
+    
+    for (int i = 0; i < world->capacity; i++) {
+        CompactChunk(world->slots[i]);
+    }
+}
+
+// Build a standalone chunk from an array of blocks indexed by CHUNK_INDEX.
+// The palette is as small as possible. Returns NULL if every block is empty
+// (or memory runs out). Safe to call from worker threads.
+Chunk* CreateChunkFromBlocks(int cx, int cy, int cz, const BlockId* blocks) {
+    int paletteIndex[CHUNK_MAX_PALETTE];
+    for (int i = 0; i < CHUNK_MAX_PALETTE; i++) {
+        paletteIndex[i] = -1;
+    }
+    
+    Chunk* chunk = AllocateChunk(cx, cy, cz);
+    if (!chunk) return NULL;
+    
+    // Collect the palette in order of first appearance and count filled blocks
+    chunk->paletteSize = 0;
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        if (paletteIndex[blocks[i]] < 0) {
+            paletteIndex[blocks[i]] = chunk->paletteSize;
+            chunk->palette[chunk->paletteSize++] = blocks[i];
+        }
+        if (blocks[i] != BLOCK_EMPTY) chunk->filledCount++;
+    }
+    
+    if (chunk->filledCount == 0) {
+        free(chunk);
+        return NULL;
+    }
+    
+    int bits = 0;
+    while ((1 << bits) < chunk->paletteSize) {
+        bits = (bits == 0) ? 1 : bits * 2;
+    }
+    
+    if (bits > 0) {
+        chunk->data = (uint64_t*)malloc(GetChunkDataSize(bits));
+        if (!chunk->data) {
+            free(chunk);
+            return NULL;
+        }
+        
+        // Fill whole words at a time
+        int perWord = 64 / bits;
+        for (int w = 0; w < CHUNK_VOLUME / perWord; w++) {
+            const BlockId* wordBlocks = &blocks[w * perWord];
+            uint64_t word = 0;
+            for (int i = 0; i < perWord; i++) {
+                word |= (uint64_t)paletteIndex[wordBlocks[i]] << (i * bits);
+            }
+            chunk->data[w] = word;
+        }
+    }
+    chunk->bitsPerBlock = bits;
+    
+    // Column occupancy
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            const BlockId* row = &blocks[CHUNK_INDEX(x, y, 0)];
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                uint16_t bit = (uint16_t)(row[z] != BLOCK_EMPTY) << y;
+                uint16_t opaqueBit = (uint16_t)!IsBlockTransparent((BlockType)row[z]) << y;
+                chunk->filledColumns[CHUNK_COLUMN_INDEX(x, z)] |= bit;
+                chunk->opaqueColumns[CHUNK_COLUMN_INDEX(x, z)] |= opaqueBit;
+            }
+        }
+    }
+    
+    return chunk;
+}
+
+// Free a chunk that is not part of a world
+void FreeChunk(Chunk* chunk) {
+    if (chunk) {
+        free(chunk->data);
+        free(chunk);
+    }
+}
+
+// Append a chunk to the dirty list
+static void QueueDirtyChunk(World* world, int cx, int cy, int cz) {
+    if (world->dirtyCount == world->dirtyCapacity) {
+        int capacity = world->dirtyCapacity ? world->dirtyCapacity * 2 : 64;
+        ChunkCoord* queue = (ChunkCoord*)realloc(world->dirtyChunks, capacity * sizeof(ChunkCoord));
+        if (!queue) return;
+        
+        world->dirtyChunks = queue;
+        world->dirtyCapacity = capacity;
+    }
+    
+    world->dirtyChunks[world->dirtyCount++] = (ChunkCoord){ cx, cy, cz };
+}
+
+// Flag a chunk's geometry as out of date (chunks without blocks are ignored)
+void MarkChunkDirty(World* world, int cx, int cy, int cz) {
+    Chunk* chunk = FindChunk(world, cx, cy, cz);
+    
+    if (chunk && !chunk->dirty) {
+        chunk->dirty = true;
+        QueueDirtyChunk(world, cx, cy, cz);
+    }
+}
+
+// Take the next chunk from the dirty list; returns false when it is empty
+bool PopDirtyChunk(World* world, ChunkCoord* coord) {
+    if (!world || world->dirtyCount == 0) {
+        return false;
+    }
+    
+    *coord = world->dirtyChunks[--world->dirtyCount];
+    
+    Chunk* chunk = FindChunk(world, coord->cx, coord->cy, coord->cz);
+    if (chunk) {
+        chunk->dirty = false;
+    }
+    
+    return true;
+}
+
+// Hand a chunk built with CreateChunkFromBlocks to the world, replacing any
+// chunk already at its coordinates. The chunk and its neighbours are marked
+// dirty. Returns false (and leaves the chunk to the caller) if the table
+// could not grow.
+bool InsertChunk(World* world, Chunk* chunk) {
+    if (!world || !chunk) return false;
+    
+    int cx = chunk->cx;
+    int cy = chunk->cy;
+    int cz = chunk->cz;
+    
+    int slot = FindChunkSlot(world, cx, cy, cz);
+    if (world->slots[slot]) {
+        FreeChunk(world->slots[slot]);
+        world->slots[slot] = chunk;
+    } else if (!LinkChunk(world, chunk)) {
+        return false;
+    }
+    
+    chunk->dirty = false;
+    MarkChunkDirty(world, cx, cy, cz);
+    InvalidateColumnHeights(world, cx, cz);
+    
+    // The faces neighbouring chunks show towards this one may have changed
+    for (int i = 0; i < 6; i++) {
+        MarkChunkDirty(world, cx + DIRECTION_VECTORS[i][0], cy + DIRECTION_VECTORS[i][1], cz + DIRECTION_VECTORS[i][2]);
+    }
+    
+    return true;
+}
+
+// Take a chunk out of the world without freeing it (for example to save it
+// on another thread) and return it. The renderer is told through the dirty
+// list, and neighbours are marked dirty because the faces they show towards
+// it may change.
+Chunk* DetachChunk(World* world, int cx, int cy, int cz) {
+    if (!world) return NULL;
+    
+    Chunk* chunk = FindChunk(world, cx, cy, cz);
+    if (!chunk) return NULL;
+    
+    UnlinkChunk(world, chunk);
+    QueueDirtyChunk(world, cx, cy, cz);
+    
+    for (int i = 0; i < 6; i++) {
+        MarkChunkDirty(world, cx + DIRECTION_VECTORS[i][0], cy + DIRECTION_VECTORS[i][1], cz + DIRECTION_VECTORS[i][2]);
+    }
+    
+    // Stop caching the heights of columns that leave the world entirely
+    bool columnEmpty = true;
+    for (int y = 0; y < WORLD_CHUNKS_Y && columnEmpty; y++) {
+        columnEmpty = (FindChunk(world, cx, y, cz) == NULL);
+    }
+    if (columnEmpty) {
+        RemoveColumnHeights(world, cx, cz);
+    } else {
+        InvalidateColumnHeights(world, cx, cz);
+    }
+    
+    return chunk;
+}
+
+// Drop a chunk from the world (for example when it is streamed out)
+void UnloadChunk(World* world, int cx, int cy, int cz) {
+    FreeChunk(DetachChunk(world, cx, cy, cz));
+}
+
+// Find a held column (NULL if the column is not held)
+static HeldColumn* FindHeldColumn(World* world, int cx, int cz) {
+    for (int i = 0; i < world->heldCount; i++) {
+        if (world->heldColumns[i].cx == cx && world->heldColumns[i].cz == cz) {
+            return &world->heldColumns[i];
+        }
+    }
+    return NULL;
+}
+
+// Start recording edits to a column instead of applying them, while its
+// chunks are away (holding a held column keeps its edits). Returns false
+// if memory runs out.
+bool HoldColumn(World* world, int cx, int cz) {
+    if (!world) return false;
+    if (FindHeldColumn(world, cx, cz)) return true;
+    
+    if (world->heldCount == world->heldCapacity) {
+        int newCapacity = world->heldCapacity ? world->heldCapacity * 2 : 16;
+        HeldColumn* newColumns = (HeldColumn*)realloc(world->heldColumns, newCapacity * sizeof(HeldColumn));
+        if (!newColumns) return false;
+        
+        world->heldColumns = newColumns;
+        world->heldCapacity = newCapacity;
+    }
+    
+    world->heldColumns[world->heldCount++] = (HeldColumn){ cx, cz, NULL, 0, 0 };
+    return true;
+}
+
+// Get the number of edits recorded for a column (0 if it is not held)
+int GetHeldEditCount(World* world, int cx, int cz) {
+    if (!world) return 0;
+    
+    HeldColumn* held = FindHeldColumn(world, cx, cz);
+    return held ? held->editCount : 0;
+}
+
+// Stop holding a column and apply its recorded edits, in order, on top of
+// the chunks it holds now
+void ReleaseColumn(World* world, int cx, int cz) {
+    if (!world) return;
+    
+    HeldColumn* held = FindHeldColumn(world, cx, cz);
+    if (!held) return;
+    
+    // Take the column out first so the edits are applied rather than recorded again
+    HeldColumn released = *held;
+    *held = world->heldColumns[--world->heldCount];
+    
+    for (int i = 0; i < released.editCount; i++) {
+        const BlockEdit* edit = &released.edits[i];
+        SetBlock(world, edit->x, edit->y, edit->z, edit->type);
+    }
+    free(released.edits);
+}
+
+// Append an edit to a held column (dropped if memory runs out)
+static void AddHeldEdit(HeldColumn* held, int x, int y, int z, BlockType type) {
+    if (held->editCount == held->editCapacity) {
+        int newCapacity = held->editCapacity ? held->editCapacity * 2 : 64;
+        BlockEdit* newEdits = (BlockEdit*)realloc(held->edits, newCapacity * sizeof(BlockEdit));
+        if (!newEdits) return;
+        
+        held->edits = newEdits;
+        held->editCapacity = newCapacity;
+    }
+    
+    held->edits[held->editCount++] = (BlockEdit){ x, y, z, type };
+}
+
 // Check if a position is within world bounds
 bool IsValidBlockPosition(int x, int y, int z) {
-    return (x >= 0 && x < WORLD_SIZE_X &&
+    return (x > -WORLD_HORIZONTAL_LIMIT && x < WORLD_HORIZONTAL_LIMIT &&
             y >= 0 && y < WORLD_SIZE_Y &&
-            z >= 0 && z < WORLD_SIZE_Z);
+            z > -WORLD_HORIZONTAL_LIMIT && z < WORLD_HORIZONTAL_LIMIT);
 }
 
 // Get the block type at a specific position
@@ -50,13 +744,490 @@ BlockType GetBlock(World* world, int x, int y, int z) {
         return BLOCK_EMPTY;
     }
     
-    return world->blocks[x][y][z];
+    Chunk* chunk = GetChunk(world, BlockToChunkCoord(x), BlockToChunkCoord(y), BlockToChunkCoord(z));
+    if (!chunk) {
+        return BLOCK_EMPTY;
+    }
+    
+    return GetChunkBlock(chunk, x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK);
+}
+
+// Height of the highest set bit of a block column's occupancy (-1 if none)
+static inline int GetHighestColumnBit(uint64_t bits) {
+    return bits ? 63 - __builtin_clzll(bits) : -1;
 }
 
 // Set a block at a specific position
 void SetBlock(World* world, int x, int y, int z, BlockType type) {
-    if (world && IsValidBlockPosition(x, y, z)) {
-        world->blocks[x][y][z] = type;
+    if (!world || !IsValidBlockPosition(x, y, z)) {
+        return;
+    }
+    
+    int cx = BlockToChunkCoord(x);
+    int cy = BlockToChunkCoord(y);
+    int cz = BlockToChunkCoord(z);
+    
+    // Columns away from the world take the edit once they are back
+    HeldColumn* held = (world->heldCount > 0) ? FindHeldColumn(world, cx, cz) : NULL;
+    if (held) {
+        AddHeldEdit(held, x, y, z, type);
+        return;
+    }
+    
+    Chunk* chunk = GetChunk(world, cx, cy, cz);
+    
+    if (!chunk) {
+        // Writing air into a missing chunk changes nothing
+        if (type == BLOCK_EMPTY) return;
+        
+        chunk = CreateChunk(world, cx, cy, cz);
+        if (!chunk) return;
+    }
+    
+    int lx = x & CHUNK_MASK;
+    int ly = y & CHUNK_MASK;
+    int lz = z & CHUNK_MASK;
+    BlockType previous = GetChunkBlock(chunk, lx, ly, lz);
+    if (previous == type) return;
+    if (!SetChunkBlock(chunk, lx, ly, lz, type)) return;
+    chunk->modified = true;
+    
+    // A cached surface only moves when a block of its kind is placed or
+    // removed at or above it
+    ColumnHeights* heights = FindColumnHeights(world, cx, cz);
+    if (heights && !heights->valid) heights = NULL;
+    int column = CHUNK_COLUMN_INDEX(lx, lz);
+    bool solidMoves = heights && y >= heights->solidHeights[column] &&
+                      (!IsBlockTransparent(previous) || !IsBlockTransparent(type));
+    bool jelloMoves = heights && y >= heights->jelloHeights[column] &&
+                      (previous == BLOCK_JELLO || type == BLOCK_JELLO);
+    
+    if (previous == BLOCK_EMPTY) {
+        // Filling the last hole may leave a single block type: collapse the
+        // chunk so its packed data is freed and queries can skip it whole
+        if (++chunk->filledCount == CHUNK_VOLUME) CompactChunk(chunk);
+    } else if (type == BLOCK_EMPTY) {
+        chunk->filledCount--;
+    }
+    
+    // Release chunks that no longer hold any blocks; the renderer still has
+    // to hear about them so it can drop their geometry
+    if (chunk->filledCount == 0) {
+        RemoveChunk(world, chunk);
+        QueueDirtyChunk(world, cx, cy, cz);
+    } else {
+        MarkChunkDirty(world, cx, cy, cz);
+    }
+    
+    // Placing a block raises its surface to it; removing the top block means
+    // searching the column below for the next one
+    bool placesSolid = !IsBlockTransparent(type);
+    bool placesJello = (type == BLOCK_JELLO);
+    if ((solidMoves && !placesSolid) || (jelloMoves && !placesJello)) {
+        uint64_t filled, opaque;
+        GetColumnOccupancy(world, x, z, &filled, &opaque);
+        if (solidMoves && !placesSolid) heights->solidHeights[column] = (int8_t)GetHighestColumnBit(opaque);
+        if (jelloMoves && !placesJello) heights->jelloHeights[column] = (int8_t)GetHighestColumnBit(filled & ~opaque);
+    }
+    if (solidMoves && placesSolid) heights->solidHeights[column] = (int8_t)y;
+    if (jelloMoves && placesJello) heights->jelloHeights[column] = (int8_t)y;
+    
+    // Blocks on a chunk border also change the faces of the neighbouring chunk
+    if (lx == 0) MarkChunkDirty(world, cx - 1, cy, cz);
+    if (lx == CHUNK_MASK) MarkChunkDirty(world, cx + 1, cy, cz);
+    if (ly == 0) MarkChunkDirty(world, cx, cy - 1, cz);
+    if (ly == CHUNK_MASK) MarkChunkDirty(world, cx, cy + 1, cz);
+    if (lz == 0) MarkChunkDirty(world, cx, cy, cz - 1);
+    if (lz == CHUNK_MASK) MarkChunkDirty(world, cx, cy, cz + 1);
+}
+
+// Order a pair of inclusive corners along one axis and clip them to
+// [lo, hi]; returns false if nothing is left
+static bool ClipRegionAxis(int* a, int* b, int lo, int hi) {
+    int min = (*a < *b) ? *a : *b;
+    int max = (*a < *b) ? *b : *a;
+    
+    *a = (min < lo) ? lo : min;
+    *b = (max > hi) ? hi : max;
+    return *a <= *b;
+}
+
+// Clip a box of blocks (inclusive corners, in any order) to the world bounds
+static bool ClipRegion(int* x0, int* y0, int* z0, int* x1, int* y1, int* z1) {
+    return ClipRegionAxis(x0, x1, -WORLD_HORIZONTAL_LIMIT + 1, WORLD_HORIZONTAL_LIMIT - 1) &&
+           ClipRegionAxis(y0, y1, 0, WORLD_SIZE_Y - 1) &&
+           ClipRegionAxis(z0, z1, -WORLD_HORIZONTAL_LIMIT + 1, WORLD_HORIZONTAL_LIMIT - 1);
+}
+
+// Part [min, max] of the block range [lo, hi] that lies in chunk c along one axis
+static void GetChunkPart(int c, int lo, int hi, int* min, int* max) {
+    int start = c * CHUNK_SIZE;
+    *min = (start > lo) ? start : lo;
+    *max = (start + CHUNK_MASK < hi) ? start + CHUNK_MASK : hi;
+}
+
+// Build a chunk holding a single block type (NULL for air or when memory runs out)
+static Chunk* CreateUniformChunk(int cx, int cy, int cz, BlockType type) {
+    if (type == BLOCK_EMPTY) return NULL;
+    
+    Chunk* chunk = AllocateChunk(cx, cy, cz);
+    if (!chunk) return NULL;
+    
+    chunk->filledCount = CHUNK_VOLUME;
+    chunk->palette[0] = (BlockId)type;
+    memset(chunk->filledColumns, 0xFF, sizeof(chunk->filledColumns));
+    if (!IsBlockTransparent(type)) memset(chunk->opaqueColumns, 0xFF, sizeof(chunk->opaqueColumns));
+    
+    return chunk;
+}
+
+// Overwrite a whole chunk with one type: the result is a uniform chunk (or
+// no chunk for air) and the old blocks are never looked at. Returns false
+// if nothing changed.
+static bool FillWholeChunk(World* world, int cx, int cy, int cz, Chunk* chunk, BlockType type) {
+    if (chunk ? (IsChunkUniform(chunk) && chunk->palette[0] == (BlockId)type) : (type == BLOCK_EMPTY)) {
+        return false;
+    }
+    
+    if (type == BLOCK_EMPTY) {
+        // The renderer still has to hear about chunks that were emptied
+        RemoveChunk(world, chunk);
+        QueueDirtyChunk(world, cx, cy, cz);
+        return true;
+    }
+    
+    Chunk* replacement = CreateUniformChunk(cx, cy, cz, type);
+    if (!replacement) return false;
+    replacement->modified = true;
+    
+    if (chunk) {
+        // Keep the old chunk's place in the dirty list
+        replacement->dirty = chunk->dirty;
+        world->slots[FindChunkSlot(world, cx, cy, cz)] = replacement;
+        FreeChunk(chunk);
+    } else if (!LinkChunk(world, replacement)) {
+        FreeChunk(replacement);
+        return false;
+    }
+    
+    MarkChunkDirty(world, cx, cy, cz);
+    return true;
+}
+
+// Write palette indices into blocks z0..z1 of the row (x, y) of a chunk,
+// a packed word at a time: indices[i] for block z0 + i, or fillIndex for
+// every block when indices is NULL. Returns false if the row already held
+// them.
+static bool WritePackedRow(Chunk* chunk, int x, int y, int z0, int z1, const uint8_t* indices, int fillIndex) {
+    int bits = chunk->bitsPerBlock;
+    if (bits == 0) return false; // Every block is already palette entry 0
+    
+    int perWord = 64 / bits;
+    int first = CHUNK_INDEX(x, y, z0);
+    int last = CHUNK_INDEX(x, y, z1);
+    uint64_t fillPattern = (uint64_t)fillIndex * (~0ull / ((1ull << bits) - 1)); // fillIndex in every slot
+    bool changed = false;
+    
+    for (int i = first; i <= last;) {
+        int word = i / perWord;
+        int end = (word + 1) * perWord - 1;
+        if (end > last) end = last;
+        
+        int shift = (i % perWord) * bits;
+        int width = (end - i + 1) * bits;
+        uint64_t mask = ((width == 64) ? ~0ull : (1ull << width) - 1) << shift;
+        uint64_t value = fillPattern & mask;
+        if (indices) {
+            value = 0;
+            for (int j = i; j <= end; j++) {
+                value |= (uint64_t)indices[j - first] << ((j % perWord) * bits);
+            }
+        }
+        
+        uint64_t updated = (chunk->data[word] & ~mask) | value;
+        changed |= (updated != chunk->data[word]);
+        chunk->data[word] = updated;
+        i = end + 1;
+    }
+    
+    return changed;
+}
+
+// Recompute the occupancy of the columns in [x0, x1] x [z0, z1] (local,
+// inclusive) from the chunk's blocks, and the chunk's filled count
+static void RebuildChunkOccupancy(Chunk* chunk, int x0, int z0, int x1, int z1) {
+    for (int x = x0; x <= x1; x++) {
+        for (int z = z0; z <= z1; z++) {
+            uint16_t filled = 0;
+            uint16_t opaque = 0;
+            for (int y = 0; y < CHUNK_SIZE; y++) {
+                BlockType type = GetChunkBlock(chunk, x, y, z);
+                if (type != BLOCK_EMPTY) filled |= (uint16_t)(1u << y);
+                if (!IsBlockTransparent(type)) opaque |= (uint16_t)(1u << y);
+            }
+            chunk->filledColumns[CHUNK_COLUMN_INDEX(x, z)] = filled;
+            chunk->opaqueColumns[CHUNK_COLUMN_INDEX(x, z)] = opaque;
+        }
+    }
+    
+    chunk->filledCount = 0;
+    for (int column = 0; column < CHUNK_SIZE * CHUNK_SIZE; column++) {
+        chunk->filledCount += __builtin_popcount(chunk->filledColumns[column]);
+    }
+}
+
+// Write a box of blocks into one chunk (local, inclusive corners), either
+// filling it with one type (source NULL) or copying rows of source, whose
+// z rows are sourceRowStride apart along y and sourceSliceStride along x.
+// Whole-chunk fills become uniform chunks; otherwise the packed indices are
+// rewritten a word at a time along z and the column occupancy a column at a
+// time, without decoding the chunk. The chunk and the neighbours across the
+// faces the box touches are marked dirty once.
+static void WriteChunkRegion(World* world, int cx, int cy, int cz,
+                             int x0, int y0, int z0, int x1, int y1, int z1,
+                             BlockType fill, const BlockId* source, int sourceRowStride, int sourceSliceStride) {
+    Chunk* chunk = GetChunk(world, cx, cy, cz);
+    bool changed = false;
+    
+    if (!source && x0 == 0 && y0 == 0 && z0 == 0 && x1 == CHUNK_MASK && y1 == CHUNK_MASK && z1 == CHUNK_MASK) {
+        if (!FillWholeChunk(world, cx, cy, cz, chunk, fill)) return;
+        InvalidateColumnHeights(world, cx, cz);
+    } else {
+        // Writing air into a missing chunk changes nothing
+        if (!chunk && !source && fill == BLOCK_EMPTY) return;
+        
+        // Blocks go into a detached chunk until they turn out not to be empty
+        bool linked = (chunk != NULL);
+        if (!chunk) {
+            chunk = AllocateChunk(cx, cy, cz);
+            if (!chunk) return;
+        }
+        
+        // Palette index of every block type written so far
+        int paletteIndex[CHUNK_MAX_PALETTE];
+        for (int i = 0; i < CHUNK_MAX_PALETTE; i++) {
+            paletteIndex[i] = -1;
+        }
+        
+        // A fill sets whole column ranges at once and needs one palette entry
+        uint16_t heights = (uint16_t)(((1u << (y1 + 1)) - 1) & ~((1u << y0) - 1));
+        uint16_t fillFilled = (fill != BLOCK_EMPTY) ? heights : 0;
+        uint16_t fillOpaque = !IsBlockTransparent(fill) ? heights : 0;
+        int fillIndex = source ? 0 : GetOrAddPaletteIndex(chunk, fill);
+        uint8_t indices[CHUNK_SIZE];
+        bool failed = (fillIndex < 0);
+        
+        for (int x = x0; x <= x1 && !failed; x++) {
+            // The old blocks leave the columns and the new ones take their place
+            for (int z = z0; z <= z1; z++) {
+                int column = CHUNK_COLUMN_INDEX(x, z);
+                chunk->filledCount -= __builtin_popcount(chunk->filledColumns[column] & heights);
+                chunk->filledColumns[column] = (chunk->filledColumns[column] & (uint16_t)~heights) | fillFilled;
+                chunk->opaqueColumns[column] = (chunk->opaqueColumns[column] & (uint16_t)~heights) | fillOpaque;
+            }
+            
+            for (int y = y0; y <= y1; y++) {
+                if (!source) {
+                    changed |= WritePackedRow(chunk, x, y, z0, z1, NULL, fillIndex);
+                    continue;
+                }
+                
+                const BlockId* row = source + (x - x0) * sourceSliceStride + (y - y0) * sourceRowStride;
+                uint16_t bit = (uint16_t)(1u << y);
+                for (int z = z0; z <= z1; z++) {
+                    BlockId id = row[z - z0];
+                    if (paletteIndex[id] < 0) {
+                        paletteIndex[id] = GetOrAddPaletteIndex(chunk, (BlockType)id);
+                        if (paletteIndex[id] < 0) {
+                            failed = true;
+                            break;
+                        }
+                    }
+                    indices[z - z0] = (uint8_t)paletteIndex[id];
+                    
+                    int column = CHUNK_COLUMN_INDEX(x, z);
+                    if (id != BLOCK_EMPTY) chunk->filledColumns[column] |= bit;
+                    if (!IsBlockTransparent((BlockType)id)) chunk->opaqueColumns[column] |= bit;
+                }
+                if (failed) break;
+                changed |= WritePackedRow(chunk, x, y, z0, z1, indices, 0);
+            }
+            
+            for (int z = z0; z <= z1; z++) {
+                chunk->filledCount += __builtin_popcount(chunk->filledColumns[CHUNK_COLUMN_INDEX(x, z)] & heights);
+            }
+        }
+        
+        // Memory ran out part way through: the occupancy was updated ahead of
+        // rows that were never written, so rebuild it from the blocks
+        if (failed) RebuildChunkOccupancy(chunk, x0, z0, x1, z1);
+        
+        if (!linked) {
+            // A missing chunk only changes if something other than air was written
+            if (chunk->filledCount == 0 || !LinkChunk(world, chunk)) {
+                FreeChunk(chunk);
+                return;
+            }
+            changed = true;
+        }
+        if (!changed) return;
+        
+        chunk->modified = true;
+        InvalidateColumnHeights(world, cx, cz);
+        if (chunk->filledCount == 0) {
+            RemoveChunk(world, chunk);
+            QueueDirtyChunk(world, cx, cy, cz);
+        } else {
+            // Filling the last hole may leave a single block type (see SetBlock)
+            if (chunk->filledCount == CHUNK_VOLUME) CompactChunk(chunk);
+            MarkChunkDirty(world, cx, cy, cz);
+        }
+    }
+    
+    // Blocks on a chunk border also change the faces of the neighbouring chunk
+    if (x0 == 0) MarkChunkDirty(world, cx - 1, cy, cz);
+    if (x1 == CHUNK_MASK) MarkChunkDirty(world, cx + 1, cy, cz);
+    if (y0 == 0) MarkChunkDirty(world, cx, cy - 1, cz);
+    if (y1 == CHUNK_MASK) MarkChunkDirty(world, cx, cy + 1, cz);
+    if (z0 == 0) MarkChunkDirty(world, cx, cy, cz - 1);
+    if (z1 == CHUNK_MASK) MarkChunkDirty(world, cx, cy, cz + 1);
+}
+
+// Write a clipped box of blocks chunk by chunk: a fill with one type when
+// source is NULL, otherwise a copy of source, a box laid out as in
+// BlockRegion whose block (sourceX, sourceY, sourceZ) lands on (x0, y0, z0)
+static void WriteRegion(World* world, int x0, int y0, int z0, int x1, int y1, int z1, BlockType fill,
+                        const BlockRegion* source, int sourceX, int sourceY, int sourceZ) {
+    for (int cx = BlockToChunkCoord(x0); cx <= BlockToChunkCoord(x1); cx++) {
+        for (int cy = BlockToChunkCoord(y0); cy <= BlockToChunkCoord(y1); cy++) {
+            for (int cz = BlockToChunkCoord(z0); cz <= BlockToChunkCoord(z1); cz++) {
+                // Part of the box inside this chunk, in world coordinates
+                int minX, minY, minZ, maxX, maxY, maxZ;
+                GetChunkPart(cx, x0, x1, &minX, &maxX);
+                GetChunkPart(cy, y0, y1, &minY, &maxY);
+                GetChunkPart(cz, z0, z1, &minZ, &maxZ);
+                
+                const BlockId* rows = NULL;
+                int rowStride = 0;
+                int sliceStride = 0;
+                if (source) {
+                    rowStride = source->sizeZ;
+                    sliceStride = source->sizeY * source->sizeZ;
+                    rows = &source->blocks[GetRegionBlockIndex(source, sourceX + minX - x0, sourceY + minY - y0,
+                                                               sourceZ + minZ - z0)];
+                }
+                
+                // Columns away from the world take the blocks once they are back (see SetBlock)
+                HeldColumn* held = (world->heldCount > 0) ? FindHeldColumn(world, cx, cz) : NULL;
+                if (held) {
+                    for (int x = minX; x <= maxX; x++) {
+                        for (int y = minY; y <= maxY; y++) {
+                            for (int z = minZ; z <= maxZ; z++) {
+                                BlockType type = rows ? (BlockType)rows[(x - minX) * sliceStride + (y - minY) * rowStride + z - minZ] : fill;
+                                AddHeldEdit(held, x, y, z, type);
+                            }
+                        }
+                    }
+                    continue;
+                }
+                
+                WriteChunkRegion(world, cx, cy, cz, minX & CHUNK_MASK, minY & CHUNK_MASK, minZ & CHUNK_MASK,
+                                 maxX & CHUNK_MASK, maxY & CHUNK_MASK, maxZ & CHUNK_MASK,
+                                 fill, rows, rowStride, sliceStride);
+            }
+        }
+    }
+}
+
+// Set every block of a box (inclusive corners, in any order) to one type.
+// The box is clipped to the world once, whole chunks become uniform chunks
+// without touching their blocks, and each affected chunk is marked dirty
+// once, so the renderer remeshes it a single time.
+void FillRegion(World* world, int x0, int y0, int z0, int x1, int y1, int z1, BlockType type) {
+    if (!world || !ClipRegion(&x0, &y0, &z0, &x1, &y1, &z1)) return;
+    
+    WriteRegion(world, x0, y0, z0, x1, y1, z1, type, NULL, 0, 0, 0);
+}
+
+// Set the blocks of a column from y0 to y1 (inclusive) to one type
+void FillColumn(World* world, int x, int z, int y0, int y1, BlockType type) {
+    FillRegion(world, x, y0, z, x, y1, z, type);
+}
+
+// Copy a box of blocks (inclusive corners, in any order) out of the world.
+// Blocks outside the world read as empty. Returns NULL if memory runs out.
+BlockRegion* CopyRegion(World* world, int x0, int y0, int z0, int x1, int y1, int z1) {
+    if (!world) return NULL;
+    
+    int minX = (x0 < x1) ? x0 : x1;
+    int minY = (y0 < y1) ? y0 : y1;
+    int minZ = (z0 < z1) ? z0 : z1;
+    int maxX = (x0 < x1) ? x1 : x0;
+    int maxY = (y0 < y1) ? y1 : y0;
+    int maxZ = (z0 < z1) ? z1 : z0;
+    
+    BlockRegion* region = (BlockRegion*)malloc(sizeof(BlockRegion));
+    if (!region) return NULL;
+    
+    region->sizeX = maxX - minX + 1;
+    region->sizeY = maxY - minY + 1;
+    region->sizeZ = maxZ - minZ + 1;
+    region->blocks = (BlockId*)calloc((size_t)region->sizeX * region->sizeY * region->sizeZ, sizeof(BlockId));
+    if (!region->blocks) {
+        free(region);
+        return NULL;
+    }
+    
+    // Only the part inside the world has anything to copy
+    if (!ClipRegion(&x0, &y0, &z0, &x1, &y1, &z1)) return region;
+    
+    BlockId blocks[CHUNK_VOLUME];
+    for (int cx = BlockToChunkCoord(x0); cx <= BlockToChunkCoord(x1); cx++) {
+        for (int cy = BlockToChunkCoord(y0); cy <= BlockToChunkCoord(y1); cy++) {
+            for (int cz = BlockToChunkCoord(z0); cz <= BlockToChunkCoord(z1); cz++) {
+                Chunk* chunk = GetChunk(world, cx, cy, cz);
+                if (!chunk) continue; // Already empty
+                
+                int chunkMinX, chunkMinY, chunkMinZ, chunkMaxX, chunkMaxY, chunkMaxZ;
+                GetChunkPart(cx, x0, x1, &chunkMinX, &chunkMaxX);
+                GetChunkPart(cy, y0, y1, &chunkMinY, &chunkMaxY);
+                GetChunkPart(cz, z0, z1, &chunkMinZ, &chunkMaxZ);
+                int rowLength = chunkMaxZ - chunkMinZ + 1;
+                
+                UnpackChunkBlocks(chunk, blocks);
+                for (int x = chunkMinX; x <= chunkMaxX; x++) {
+                    for (int y = chunkMinY; y <= chunkMaxY; y++) {
+                        memcpy(&region->blocks[GetRegionBlockIndex(region, x - minX, y - minY, chunkMinZ - minZ)],
+                               &blocks[CHUNK_INDEX(x & CHUNK_MASK, y & CHUNK_MASK, chunkMinZ & CHUNK_MASK)], rowLength);
+                    }
+                }
+            }
+        }
+    }
+    
+    return region;
+}
+
+// Write a copied box back into the world with its lowest corner at (x, y, z),
+// air included. Parts outside the world are dropped; chunks are written and
+// marked dirty as in FillRegion.
+void PasteRegion(World* world, const BlockRegion* region, int x, int y, int z) {
+    if (!world || !region || !region->blocks) return;
+    
+    int x0 = x, y0 = y, z0 = z;
+    int x1 = x + region->sizeX - 1;
+    int y1 = y + region->sizeY - 1;
+    int z1 = z + region->sizeZ - 1;
+    if (!ClipRegion(&x0, &y0, &z0, &x1, &y1, &z1)) return;
+    
+    WriteRegion(world, x0, y0, z0, x1, y1, z1, BLOCK_EMPTY, region, x0 - x, y0 - y, z0 - z);
+}
+
+// Free a region returned by CopyRegion
+void FreeBlockRegion(BlockRegion* region) {
+    if (region) {
+        free(region->blocks);
+        free(region);
     }
 }
 
@@ -91,6 +1262,146 @@ bool IsBlockFaceVisible(World* world, int x, int y, int z, int faceDir) {
            (IsBlockTransparent(adjacentBlock) && !IsBlockTransparent(GetBlock(world, x, y, z)));
 }
 
+// Get the occupancy of a whole block column: bit y of filled is set for a
+// non-empty block at height y, bit y of opaque for an opaque one.
+// WORLD_SIZE_Y is 64, so each column fits in a single word.
+void GetColumnOccupancy(World* world, int x, int z, uint64_t* filled, uint64_t* opaque) {
+    *filled = 0;
+    *opaque = 0;
+    if (!world || !IsValidBlockPosition(x, 0, z)) return;
+    
+    int cx = BlockToChunkCoord(x);
+    int cz = BlockToChunkCoord(z);
+    int column = CHUNK_COLUMN_INDEX(x & CHUNK_MASK, z & CHUNK_MASK);
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        Chunk* chunk = GetChunk(world, cx, cy, cz);
+        if (chunk) {
+            *filled |= (uint64_t)chunk->filledColumns[column] << (cy * CHUNK_SIZE);
+            *opaque |= (uint64_t)chunk->opaqueColumns[column] << (cy * CHUNK_SIZE);
+        }
+    }
+}
+
+// Add an out-of-date entry for a chunk column to the height cache (NULL if
+// memory runs out)
+static ColumnHeights* AddColumnHeights(World* world, int cx, int cz) {
+    // Keep the load factor at or below one half
+    if ((world->heightCount + 1) * 2 > world->heightCapacity && !GrowHeightCache(world)) {
+        return NULL;
+    }
+    
+    ColumnHeights* heights = (ColumnHeights*)malloc(sizeof(ColumnHeights));
+    if (!heights) return NULL;
+    
+    heights->cx = cx;
+    heights->cz = cz;
+    heights->valid = false;
+    world->heightSlots[FindHeightSlot(world, cx, cz)] = heights;
+    world->heightCount++;
+    
+    return heights;
+}
+
+// Get the heights of a chunk column, adding them to the cache or bringing
+// them up to date from the chunks' occupancy bits as needed. Returns NULL
+// for columns without chunks, which are not cached so that queries away
+// from the loaded terrain cost no memory. If memory runs out the heights
+// are computed into scratch instead.
+static ColumnHeights* GetColumnHeights(World* world, int cx, int cz, ColumnHeights* scratch) {
+    ColumnHeights* heights = FindColumnHeights(world, cx, cz);
+    if (heights && heights->valid) return heights;
+    
+    // Fetching the chunks may load the column, which invalidates the entry
+    // again, so they are all looked up before it is marked valid
+    Chunk* chunks[WORLD_CHUNKS_Y];
+    bool empty = true;
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        chunks[cy] = GetChunk(world, cx, cy, cz);
+        if (chunks[cy]) empty = false;
+    }
+    
+    if (empty) {
+        RemoveColumnHeights(world, cx, cz);
+        return NULL;
+    }
+    
+    if (!heights) heights = AddColumnHeights(world, cx, cz);
+    if (!heights) {
+        heights = scratch;
+        heights->cx = cx;
+        heights->cz = cz;
+    }
+    
+    for (int column = 0; column < CHUNK_SIZE * CHUNK_SIZE; column++) {
+        uint64_t filled = 0;
+        uint64_t opaque = 0;
+        for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+            if (chunks[cy]) {
+                filled |= (uint64_t)chunks[cy]->filledColumns[column] << (cy * CHUNK_SIZE);
+                opaque |= (uint64_t)chunks[cy]->opaqueColumns[column] << (cy * CHUNK_SIZE);
+            }
+        }
+        heights->solidHeights[column] = (int8_t)GetHighestColumnBit(opaque);
+        heights->jelloHeights[column] = (int8_t)GetHighestColumnBit(filled & ~opaque);
+    }
+    heights->valid = true;
+    
+    return heights;
+}
+
+// Get the height of the highest opaque block in a column (-1 if there is
+// none). Heights are cached per chunk column and kept up to date as blocks
+// change, so repeated queries cost a hash lookup.
+int GetSolidHeight(World* world, int x, int z) {
+    if (!world || !IsValidBlockPosition(x, 0, z)) return -1;
+    
+    ColumnHeights scratch;
+    ColumnHeights* heights = GetColumnHeights(world, BlockToChunkCoord(x), BlockToChunkCoord(z), &scratch);
+    if (!heights) return -1;
+    
+    return heights->solidHeights[CHUNK_COLUMN_INDEX(x & CHUNK_MASK, z & CHUNK_MASK)];
+}
+
+// Get the height of the highest jello block in a column (-1 if there is
+// none); cached like GetSolidHeight
+int GetJelloHeight(World* world, int x, int z) {
+    if (!world || !IsValidBlockPosition(x, 0, z)) return -1;
+    
+    ColumnHeights scratch;
+    ColumnHeights* heights = GetColumnHeights(world, BlockToChunkCoord(x), BlockToChunkCoord(z), &scratch);
+    if (!heights) return -1;
+    
+    return heights->jelloHeights[CHUNK_COLUMN_INDEX(x & CHUNK_MASK, z & CHUNK_MASK)];
+}
+
+// Compute the visible faces of every block in a column at once: bit y of
+// faceMasks[faceDir] matches IsBlockFaceVisible(world, x, y, z, faceDir)
+void GetColumnFaceMasks(World* world, int x, int z, uint64_t faceMasks[6]) {
+    uint64_t filled, opaque;
+    GetColumnOccupancy(world, x, z, &filled, &opaque);
+    
+    if (!filled) {
+        memset(faceMasks, 0, 6 * sizeof(uint64_t));
+        return;
+    }
+    
+    // Horizontal neighbours
+    for (int faceDir = 0; faceDir < 6; faceDir++) {
+        if (faceDir == 2 || faceDir == 3) continue;
+        
+        uint64_t neighbourFilled, neighbourOpaque;
+        GetColumnOccupancy(world, x + DIRECTION_VECTORS[faceDir][0], z + DIRECTION_VECTORS[faceDir][2],
+                           &neighbourFilled, &neighbourOpaque);
+        faceMasks[faceDir] = GetVisibleFaceBits(filled, opaque, neighbourFilled, neighbourOpaque);
+    }
+    
+    // The column is its own vertical neighbour, shifted by one block; the
+    // shifts bring in air above the top and below the bottom of the world
+    faceMasks[2] = GetVisibleFaceBits(filled, opaque, filled >> 1, opaque >> 1);
+    faceMasks[3] = GetVisibleFaceBits(filled, opaque, filled << 1, opaque << 1);
+}
+
 // Get a bounding box for a specific block
 BoundingBox GetBlockBoundingBox(int x, int y, int z) {
     BoundingBox box;
@@ -102,47 +1413,170 @@ BoundingBox GetBlockBoundingBox(int x, int y, int z) {
     return box;
 }
 
-// Simple collision detection between player and world
-bool CheckCollision(World* world, BoundingBox playerBox) {
-    if (!world) {
-        return false;
+// Gap left between a swept box and the block it stops against, so the box
+// never ends up overlapping a solid block through rounding
+#define SWEEP_SKIN 0.001f
+
+// Bits lo..hi of a column mask, clamped to the world's height
+static uint64_t GetColumnBitRange(int lo, int hi) {
+    if (lo < 0) lo = 0;
+    if (hi > WORLD_SIZE_Y - 1) hi = WORLD_SIZE_Y - 1;
+    if (lo > hi) return 0;
+    
+    uint64_t upTo = (hi == 63) ? ~0ull : (1ull << (hi + 1)) - 1;
+    return upTo & ~((1ull << lo) - 1);
+}
+
+// Blocks of a column at the given heights that stop movement (the same blocks
+// CheckCollision tests: everything except air and jello, which are exactly the
+// opaque ones). Only the chunks covering those heights are looked up.
+static uint64_t GetSolidColumn(World* world, int x, int z, uint64_t heights) {
+    int cx = BlockToChunkCoord(x);
+    int cz = BlockToChunkCoord(z);
+    int column = CHUNK_COLUMN_INDEX(x & CHUNK_MASK, z & CHUNK_MASK);
+    uint64_t solid = 0;
+    
+    for (int cy = 0; cy < WORLD_CHUNKS_Y; cy++) {
+        uint16_t chunkHeights = (uint16_t)(heights >> (cy * CHUNK_SIZE));
+        if (!chunkHeights) continue;
+        
+        Chunk* chunk = GetChunk(world, cx, cy, cz);
+        if (chunk) solid |= (uint64_t)(chunk->opaqueColumns[column] & chunkHeights) << (cy * CHUNK_SIZE);
+    }
+    
+    return solid;
+}
+
+// Move a box along one axis (0 = X, 1 = Y, 2 = Z) by up to distance and
+// return how far it can go before it touches a solid block. Only the block
+// layers crossed by the leading face are tested, using column occupancy, so
+// fast boxes cannot tunnel and vertical moves cost the same at any speed.
+// Blocks the box already overlaps never stop it, letting it move out of them.
+float SweepBoxAxis(World* world, BoundingBox box, int axis, float distance) {
+    if (!world || distance == 0.0f) return distance;
+    
+    float boxMin[3] = { box.min.x, box.min.y, box.min.z };
+    float boxMax[3] = { box.max.x, box.max.y, box.max.z };
+    
+    // Blocks the box overlaps on every axis
+    int lo[3], hi[3];
+    for (int i = 0; i < 3; i++) {
+        lo[i] = (int)floorf(boxMin[i]);
+        hi[i] = (int)ceilf(boxMax[i]) - 1;
     }
     
-    // Determine the range of blocks to check based on player position
-    int minX = (int)playerBox.min.x;
-    int minY = (int)playerBox.min.y;
-    int minZ = (int)playerBox.min.z;
-    int maxX = (int)playerBox.max.x + 1;
-    int maxY = (int)playerBox.max.y + 1;
-    int maxZ = (int)playerBox.max.z + 1;
+    // Block layers the leading face crosses, nearest first
+    bool positive = distance > 0.0f;
+    int step = positive ? 1 : -1;
+    int first = positive ? hi[axis] + 1 : lo[axis] - 1;
+    int last = positive ? (int)ceilf(boxMax[axis] + distance) - 1 : (int)floorf(boxMin[axis] + distance);
+    
+    int hitLayer = 0;
+    bool hit = false;
+    
+    if (axis == 1) {
+        // Every column under the box, tested against all crossed heights at once
+        uint64_t heights = positive ? GetColumnBitRange(first, last) : GetColumnBitRange(last, first);
+        uint64_t solid = 0;
+        for (int x = lo[0]; x <= hi[0] && heights; x++) {
+            for (int z = lo[2]; z <= hi[2]; z++) {
+                solid |= GetSolidColumn(world, x, z, heights);
+            }
+        }
+        
+        if (solid) {
+            hit = true;
+            hitLayer = positive ? 0 : WORLD_SIZE_Y - 1;
+            while (!((solid >> hitLayer) & 1)) hitLayer += step;
+        }
+    } else {
+        // One column per block across the box, tested against its height range
+        int across = (axis == 0) ? 2 : 0;
+        uint64_t heights = GetColumnBitRange(lo[1], hi[1]);
+        
+        for (int layer = first; heights && !hit && layer != last + step; layer += step) {
+            for (int i = lo[across]; i <= hi[across]; i++) {
+                int x = (axis == 0) ? layer : i;
+                int z = (axis == 0) ? i : layer;
+                if (GetSolidColumn(world, x, z, heights)) {
+                    hit = true;
+                    hitLayer = layer;
+                    break;
+                }
+            }
+        }
+    }
+    
+    if (!hit) return distance;
+    
+    // Stop just short of the blocking layer (never back away from it)
+    if (positive) {
+        return fmaxf((float)hitLayer - boxMax[axis] - SWEEP_SKIN, 0.0f);
+    }
+    return fminf((float)(hitLayer + 1) - boxMin[axis] + SWEEP_SKIN, 0.0f);
+}
+
+// Check whether a box touches any solid block (anything but air and jello,
+// i.e. the opaque blocks). Works a chunk at a time: missing chunks are
+// skipped, a uniform chunk answers for all of its blocks at once, and other
+// chunks are tested a column at a time with the opaque occupancy bits.
+static bool FindCollision(World* world, BoundingBox playerBox) {
+    // Blocks the box overlaps, including those whose lower faces only touch
+    // its upper faces (contact counts as a collision)
+    int minX = (int)floorf(playerBox.min.x);
+    int minY = (int)floorf(playerBox.min.y);
+    int minZ = (int)floorf(playerBox.min.z);
+    int maxX = (int)floorf(playerBox.max.x);
+    int maxY = (int)floorf(playerBox.max.y);
+    int maxZ = (int)floorf(playerBox.max.z);
     
-    // Clamp to world bounds
-    minX = (minX < 0) ? 0 : minX;
+    // Clamp to the vertical world bounds (missing chunks read as empty)
     minY = (minY < 0) ? 0 : minY;
-    minZ = (minZ < 0) ? 0 : minZ;
-    maxX = (maxX >= WORLD_SIZE_X) ? WORLD_SIZE_X - 1 : maxX;
     maxY = (maxY >= WORLD_SIZE_Y) ? WORLD_SIZE_Y - 1 : maxY;
-    maxZ = (maxZ >= WORLD_SIZE_Z) ? WORLD_SIZE_Z - 1 : maxZ;
+    if (minY > maxY) return false;
     
-    // Check collision with each block in range
-    for (int x = minX; x <= maxX; x++) {
-        for (int y = minY; y <= maxY; y++) {
-            for (int z = minZ; z <= maxZ; z++) {
-                BlockType blockType = GetBlock(world, x, y, z);
+    for (int cx = BlockToChunkCoord(minX); cx <= BlockToChunkCoord(maxX); cx++) {
+        for (int cy = BlockToChunkCoord(minY); cy <= BlockToChunkCoord(maxY); cy++) {
+            for (int cz = BlockToChunkCoord(minZ); cz <= BlockToChunkCoord(maxZ); cz++) {
+                Chunk* chunk = GetChunk(world, cx, cy, cz);
+                if (!chunk) continue;
                 
-                // Skip empty blocks and jello blocks
-                if (blockType == BLOCK_EMPTY || blockType == BLOCK_JELLO) {
+                // The box reaches at least one block of every chunk in range
+                if (IsChunkUniform(chunk)) {
+                    if (!IsBlockTransparent((BlockType)chunk->palette[0])) return true;
                     continue;
                 }
                 
-                // Check collision with this block
-                BoundingBox blockBox = GetBlockBoundingBox(x, y, z);
-                if (CheckCollisionBoxes(playerBox, blockBox)) {
-                    return true;
+                // Part of the range inside this chunk, in local coordinates
+                int x0 = (cx == BlockToChunkCoord(minX)) ? (minX & CHUNK_MASK) : 0;
+                int x1 = (cx == BlockToChunkCoord(maxX)) ? (maxX & CHUNK_MASK) : CHUNK_MASK;
+                int y0 = (cy == BlockToChunkCoord(minY)) ? (minY & CHUNK_MASK) : 0;
+                int y1 = (cy == BlockToChunkCoord(maxY)) ? (maxY & CHUNK_MASK) : CHUNK_MASK;
+                int z0 = (cz == BlockToChunkCoord(minZ)) ? (minZ & CHUNK_MASK) : 0;
+                int z1 = (cz == BlockToChunkCoord(maxZ)) ? (maxZ & CHUNK_MASK) : CHUNK_MASK;
+                uint16_t heights = (uint16_t)(((1u << (y1 + 1)) - 1) & ~((1u << y0) - 1));
+                
+                for (int x = x0; x <= x1; x++) {
+                    for (int z = z0; z <= z1; z++) {
+                        if (chunk->opaqueColumns[CHUNK_COLUMN_INDEX(x, z)] & heights) return true;
+                    }
                 }
             }
         }
     }
     
     return false;
-}
\ No newline at end of file
+}
+
+// Check whether a box touches any solid block (see FindCollision)
+bool CheckCollision(World* world, BoundingBox playerBox) {
+    if (!world) {
+        return false;
+    }
+    
+    PROFILE_BEGIN("CheckCollision");
+    bool collides = FindCollision(world, playerBox);
+    PROFILE_END();
+    
+    return collides;
+}
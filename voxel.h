@@ -3,6 +3,8 @@
 
 #include <raylib.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 // Block types enum
 typedef enum {
@@ -14,31 +16,234 @@ typedef enum {
     BLOCK_TYPE_COUNT
 } BlockType;
 
-// World dimensions
+// Compact block id as stored in chunks (a BlockType value)
+typedef uint8_t BlockId;
+
+// Size of the area generated at startup. The world itself is stored in chunks
+// and is unbounded horizontally; only the vertical extent is fixed.
 #define WORLD_SIZE_X 64
 #define WORLD_SIZE_Y 64
 #define WORLD_SIZE_Z 64
 
-// World structure
+// Largest |x| or |z| block coordinate the world can address
+#define WORLD_HORIZONTAL_LIMIT (1 << 24)
+
+// Chunk dimensions (chunks are cubes of CHUNK_SIZE blocks)
+#define CHUNK_SHIFT 4
+#define CHUNK_SIZE (1 << CHUNK_SHIFT)
+#define CHUNK_MASK (CHUNK_SIZE - 1)
+#define CHUNK_VOLUME (CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE)
+#define WORLD_CHUNKS_Y (WORLD_SIZE_Y / CHUNK_SIZE)
+
+// Index of a block within a chunk (local coordinates 0..CHUNK_SIZE-1)
+#define CHUNK_INDEX(x, y, z) (((x) << (2 * CHUNK_SHIFT)) | ((y) << CHUNK_SHIFT) | (z))
+
+// Index of a vertical block column within a chunk (local coordinates)
+#define CHUNK_COLUMN_INDEX(x, z) (((x) << CHUNK_SHIFT) | (z))
+
+// Largest palette a chunk can need (8-bit indices)
+#define CHUNK_MAX_PALETTE 256
+
+// Chunk coordinates
+typedef struct {
+    int cx, cy, cz;
+} ChunkCoord;
+
+// A cubic section of the world. Chunks only exist while they contain at least
+// one non-empty block.
+// Blocks are stored as indices into a per-chunk palette of block ids, packed
+// 1, 2, 4 or 8 bits per block; the width grows as new block types are written.
+// A chunk holding a single block type needs no packed data at all.
+// Alongside the blocks, every vertical column keeps occupancy bitsets (bit ly
+// set for a non-empty or an opaque block) so faces can be culled with shifts
+// and ANDs instead of per-block lookups.
+typedef struct {
+    int cx, cy, cz;     // Chunk coordinates (block coordinates >> CHUNK_SHIFT)
+    int filledCount;    // Number of non-empty blocks in the chunk
+    bool dirty;         // Queued in the world's dirty list since the last remesh
+    bool modified;      // Edited with SetBlock since it was generated, loaded or saved
+    int bitsPerBlock;   // Width of a packed palette index: 0 (uniform), 1, 2, 4 or 8
+    int paletteSize;    // Number of palette entries in use
+    BlockId palette[CHUNK_MAX_PALETTE]; // Block ids referenced by the packed indices
+    uint64_t* data;     // Packed palette indices (NULL when bitsPerBlock is 0)
+    uint16_t filledColumns[CHUNK_SIZE * CHUNK_SIZE]; // Non-empty blocks, see CHUNK_COLUMN_INDEX
+    uint16_t opaqueColumns[CHUNK_SIZE * CHUNK_SIZE]; // Opaque blocks, see CHUNK_COLUMN_INDEX
+} Chunk;
+
+// A box of blocks copied out of the world (see CopyRegion), for pasting
+// elsewhere. Blocks are stored with z varying fastest, then y, then x, so
+// rows along z are contiguous as they are in chunks.
+typedef struct {
+    int sizeX, sizeY, sizeZ; // Extent in blocks
+    BlockId* blocks;         // sizeX * sizeY * sizeZ block ids, see GetRegionBlockIndex
+} BlockRegion;
+
+// Highest solid (opaque) and highest jello block of every vertical block
+// column in one column of chunks, -1 where there is none (block heights fit
+// in 8 bits). Kept by the world and recomputed from the chunks' occupancy
+// bits when they change wholesale.
+typedef struct {
+    int cx, cz;         // Chunk column coordinates
+    bool valid;         // Heights match the chunks (otherwise recomputed on the next lookup)
+    int8_t solidHeights[CHUNK_SIZE * CHUNK_SIZE]; // See CHUNK_COLUMN_INDEX
+    int8_t jelloHeights[CHUNK_SIZE * CHUNK_SIZE]; // See CHUNK_COLUMN_INDEX
+} ColumnHeights;
+
+// A block edit waiting for its column to return to the world
+typedef struct {
+    int x, y, z;
+    BlockType type;
+} BlockEdit;
+
+// A chunk column whose chunks are away from the world, for example being
+// generated or saved on another thread. Edits to it are recorded instead of
+// applied and replayed on top of its chunks when it is released, so they
+// neither create chunks holding only the edited blocks nor get lost.
+typedef struct {
+    int cx, cz;           // Column coordinates
+    BlockEdit* edits;     // Recorded edits, oldest first
+    int editCount;
+    int editCapacity;
+} HeldColumn;
+
+// Backing store that supplies chunk columns the first time they are touched
+// (see LoadWorldLazy). loadColumn fills chunks[cy] (NULL for empty chunks)
+// and returns false if it has nothing (more) to give for the column.
+typedef struct {
+    void* context;
+    bool (*loadColumn)(void* context, int cx, int cz, Chunk* chunks[WORLD_CHUNKS_Y]);
+    void (*freeContext)(void* context);
+} ChunkColumnSource;
+
+// World structure: an open-addressing hash map of chunks keyed by chunk coordinates
 typedef struct {
-    BlockType blocks[WORLD_SIZE_X][WORLD_SIZE_Y][WORLD_SIZE_Z];
+    Chunk** slots;      // Hash table slots (NULL when free)
+    int capacity;       // Number of slots (always a power of two)
+    int chunkCount;     // Number of allocated chunks
+    unsigned int seed;  // Seed the terrain is generated from
+    ChunkColumnSource columnSource; // Lazily loaded columns (loadColumn is NULL when unused)
+    
+    ColumnHeights** heightSlots; // Surface height cache keyed by chunk column (NULL when free)
+    int heightCapacity;       // Number of height slots (always a power of two)
+    int heightCount;          // Number of cached chunk columns
+    
+    HeldColumn* heldColumns;  // Columns whose edits are deferred (few, searched linearly)
+    int heldCount;            // Number of held columns
+    int heldCapacity;         // Allocated length of heldColumns
+    
+    ChunkCoord* dirtyChunks;  // Chunks whose geometry is out of date
+    int dirtyCount;           // Number of queued dirty chunks
+    int dirtyCapacity;        // Allocated length of dirtyChunks
 } World;
 
+// Convert a block coordinate to the coordinate of the chunk containing it
+static inline int BlockToChunkCoord(int v) {
+    return v >> CHUNK_SHIFT; // Arithmetic shift floors negative coordinates
+}
+
+// Hash chunk coordinates (mask the result to index a power-of-two table)
+static inline unsigned int HashChunkCoords(int cx, int cy, int cz) {
+    return (unsigned int)cx * 73856093u ^
+           (unsigned int)cy * 19349663u ^
+           (unsigned int)cz * 83492791u;
+}
+
+// Whether every block of a chunk is the same type (palette[0]). Such chunks
+// store no packed data and let queries treat the whole chunk as one block.
+// Edits only collapse a chunk into this form when they fill it (SetBlock) or
+// when it is compacted, so a uniform chunk may still report false.
+static inline bool IsChunkUniform(const Chunk* chunk) {
+    return chunk->bitsPerBlock == 0;
+}
+
+// Read a block from a chunk (local coordinates 0..CHUNK_SIZE-1)
+static inline BlockType GetChunkBlock(const Chunk* chunk, int lx, int ly, int lz) {
+    if (chunk->bitsPerBlock == 0) {
+        return (BlockType)chunk->palette[0];
+    }
+    
+    // Widths divide 64, so an index never straddles two words
+    int bit = CHUNK_INDEX(lx, ly, lz) * chunk->bitsPerBlock;
+    uint64_t word = chunk->data[bit >> 6];
+    int paletteIndex = (int)((word >> (bit & 63)) & ((1u << chunk->bitsPerBlock) - 1));
+    
+    return (BlockType)chunk->palette[paletteIndex];
+}
+
+// Index of a block within a region (coordinates relative to its lowest corner)
+static inline int GetRegionBlockIndex(const BlockRegion* region, int x, int y, int z) {
+    return (x * region->sizeY + y) * region->sizeZ + z;
+}
+
 // Function prototypes for world creation and management
 World* CreateWorld(void);
 void DestroyWorld(World* world);
 
+// World persistence (region files in a directory, see region.h)
+bool SaveWorld(World* world, const char* directory);
+World* LoadWorld(const char* directory);
+World* LoadWorldLazy(const char* directory);
+
+// Chunk access
+Chunk* GetChunk(World* world, int cx, int cy, int cz);
+size_t GetChunkMemoryUsage(const Chunk* chunk);
+size_t GetWorldMemoryUsage(World* world);
+
+// Chunk storage
+bool SetChunkBlock(Chunk* chunk, int lx, int ly, int lz, BlockType type);
+void UnpackChunkBlocks(const Chunk* chunk, BlockId* blocks);
+void CompactChunk(Chunk* chunk);
+void CompactWorld(World* world);
+Chunk* CreateChunkFromBlocks(int cx, int cy, int cz, const BlockId* blocks);
+void FreeChunk(Chunk* chunk);
+bool InsertChunk(World* world, Chunk* chunk);
+Chunk* DetachChunk(World* world, int cx, int cy, int cz);
+void UnloadChunk(World* world, int cx, int cy, int cz);
+
+// Deferring edits to columns that are away from the world
+bool HoldColumn(World* world, int cx, int cz);
+int GetHeldEditCount(World* world, int cx, int cz);
+void ReleaseColumn(World* world, int cx, int cz);
+
+// Change tracking for incremental remeshing
+void MarkChunkDirty(World* world, int cx, int cy, int cz);
+bool PopDirtyChunk(World* world, ChunkCoord* coord);
+
 // Block access and modification
 BlockType GetBlock(World* world, int x, int y, int z);
 void SetBlock(World* world, int x, int y, int z, BlockType type);
 bool IsValidBlockPosition(int x, int y, int z);
 
+// Bulk editing (clipped to the world once per call, one remesh per chunk)
+void FillRegion(World* world, int x0, int y0, int z0, int x1, int y1, int z1, BlockType type);
+void FillColumn(World* world, int x, int z, int y0, int y1, BlockType type);
+BlockRegion* CopyRegion(World* world, int x0, int y0, int z0, int x1, int y1, int z1);
+void PasteRegion(World* world, const BlockRegion* region, int x, int y, int z);
+void FreeBlockRegion(BlockRegion* region);
+
+// Surface queries (cached per column, updated as blocks change)
+int GetSolidHeight(World* world, int x, int z);
+int GetJelloHeight(World* world, int x, int z);
+
 // Collision detection
 bool CheckCollision(World* world, BoundingBox playerBox);
+float SweepBoxAxis(World* world, BoundingBox box, int axis, float distance);
 BoundingBox GetBlockBoundingBox(int x, int y, int z);
 
 // Rendering optimization
 bool IsBlockFaceVisible(World* world, int x, int y, int z, int faceDir);
 bool IsBlockTransparent(BlockType blockType);
 
-#endif // VOXEL_H
\ No newline at end of file
+// Whole-column occupancy and face culling (bit y of each mask is block y)
+void GetColumnOccupancy(World* world, int x, int z, uint64_t* filled, uint64_t* opaque);
+void GetColumnFaceMasks(World* world, int x, int z, uint64_t faceMasks[6]);
+
+// Blocks with a visible face given the column's occupancy and its neighbour's
+// across that face (the neighbour masks are already aligned with the column)
+static inline uint64_t GetVisibleFaceBits(uint64_t filled, uint64_t opaque,
+                                          uint64_t neighbourFilled, uint64_t neighbourOpaque) {
+    // Visible next to air, or for an opaque block next to a transparent one
+    return filled & (~neighbourFilled | (opaque & ~neighbourOpaque));
+}
+
+#endif // VOXEL_H